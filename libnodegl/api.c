@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <stdio.h>
+#include <string.h>
 
 #if defined(TARGET_ANDROID)
 #include <jni.h>
@@ -31,12 +32,14 @@
 
 #include "backend.h"
 #include "darray.h"
+#include "hwupload.h"
 #include "log.h"
 #include "math_utils.h"
 #include "memory.h"
 #include "nodegl.h"
 #include "nodes.h"
 #include "rnode.h"
+#include "utils.h"
 
 #if defined(TARGET_IPHONE) || defined(TARGET_ANDROID)
 # define DEFAULT_BACKEND NGL_BACKEND_OPENGLES
@@ -95,6 +98,8 @@ static int cmd_configure(struct ngl_ctx *s, void *arg)
     const struct backend *backend = backend_map[config->backend];
     LOG(INFO, "selected backend: %s", backend->name);
 
+    memset(&s->stats, 0, sizeof(s->stats));
+
     if (config->platform == NGL_PLATFORM_AUTO)
         config->platform = get_default_platform();
     if (config->platform < 0) {
@@ -210,6 +215,142 @@ end:;
     return ret;
 }
 
+struct warmup_params {
+    double t_start;
+    double t_end;
+};
+
+static int is_timerangemode(const struct ngl_node *node)
+{
+    return node->class->id == NGL_NODE_TIMERANGEMODECONT ||
+           node->class->id == NGL_NODE_TIMERANGEMODENOOP ||
+           node->class->id == NGL_NODE_TIMERANGEMODEONCE;
+}
+
+static int is_media_texture(const struct ngl_node *node)
+{
+    const struct texture_priv *texture = node->priv_data;
+    return node->class->id == NGL_NODE_TEXTURE2D &&
+           texture->data_src && texture->data_src->class->id == NGL_NODE_MEDIA;
+}
+
+/*
+ * Record the start times of the time ranges found in the nodes visited for
+ * the first time
+ */
+static int collect_warmup_times(struct ngl_ctx *s, struct darray *filters, struct darray *times)
+{
+    struct ngl_node **nodes = ngli_darray_data(&s->activitycheck_nodes);
+    for (int i = 0; i < ngli_darray_count(&s->activitycheck_nodes); i++) {
+        struct ngl_node *node = nodes[i];
+
+        if (node->is_active && is_media_texture(node)) {
+            int ret = ngli_hwupload_warmup(node);
+            if (ret < 0)
+                return ret;
+        }
+
+        if (node->class->id != NGL_NODE_TIMERANGEFILTER)
+            continue;
+
+        struct ngl_node **filter = ngli_darray_data(filters);
+        int j;
+        for (j = 0; j < ngli_darray_count(filters); j++)
+            if (filter[j] == node)
+                break;
+        if (j < ngli_darray_count(filters))
+            continue;
+        if (!ngli_darray_push(filters, &node))
+            return NGL_ERROR_MEMORY;
+
+        struct ngl_node **children = ngli_darray_data(&node->children);
+        for (j = 0; j < ngli_darray_count(&node->children); j++) {
+            if (!is_timerangemode(children[j]))
+                continue;
+            const struct timerangemode_priv *range = children[j]->priv_data;
+            if (!ngli_darray_push(times, &range->start_time))
+                return NGL_ERROR_MEMORY;
+        }
+    }
+    return 0;
+}
+
+static int warmup_visit(struct ngl_ctx *s, double t)
+{
+    s->activitycheck_nodes.count = 0;
+    int ret = ngli_node_visit(s->scene, 1, t);
+    if (ret < 0)
+        return ret;
+    return ngli_node_honor_release_prefetch(&s->activitycheck_nodes);
+}
+
+static int cmd_warmup(struct ngl_ctx *s, void *arg)
+{
+    const struct warmup_params *params = arg;
+
+    struct ngl_node *scene = s->scene;
+    if (!scene)
+        return 0;
+
+    const int64_t start_time = ngli_gettime_relative();
+
+    struct darray filters, times;
+    ngli_darray_init(&filters, sizeof(struct ngl_node *), 0);
+    ngli_darray_init(&times, sizeof(double), 0);
+
+    /*
+     * The time ranges are discovered while going through the timeline since
+     * the ranges nested in an inactive branch are only reached once this
+     * branch becomes active
+     */
+    int nb_steps = 0;
+    double t = params->t_start;
+    int ret;
+    for (;;) {
+        LOG(DEBUG, "warmup scene %s @ t=%f", scene->label, t);
+        if ((ret = warmup_visit(s, t)) < 0 ||
+            (ret = collect_warmup_times(s, &filters, &times)) < 0)
+            goto end;
+        nb_steps++;
+
+        int found = 0;
+        double next_t = params->t_end;
+        const double *range_times = ngli_darray_data(&times);
+        for (int i = 0; i < ngli_darray_count(&times); i++) {
+            if (range_times[i] > t && range_times[i] <= next_t) {
+                next_t = range_times[i];
+                found = 1;
+            }
+        }
+        if (!found)
+            break;
+        t = next_t;
+    }
+
+    if (t != params->t_start) {
+        ret = warmup_visit(s, params->t_start);
+        if (ret < 0)
+            goto end;
+    }
+
+    const int64_t warmup_time = ngli_gettime_relative() - start_time;
+    s->stats.warmup_time += warmup_time;
+    LOG(INFO, "scene %s warmed up over [%g,%g] in %d steps: %.3fms", scene->label,
+        params->t_start, params->t_end, nb_steps, warmup_time / 1000.);
+
+end:
+    ngli_darray_reset(&times);
+    ngli_darray_reset(&filters);
+    return ret;
+}
+
+static int cmd_get_stats(struct ngl_ctx *s, void *arg)
+{
+    struct ngl_stats *stats = arg;
+    *stats = s->stats;
+    return 0;
+}
+
 static int cmd_stop(struct ngl_ctx *s, void *arg)
 {
     if (s->backend)
@@ -299,8 +440,12 @@ static void stop_thread(struct ngl_ctx *s)
     pthread_mutex_destroy(&s->lock);
 }
 
+static pthread_once_t math_utils_once = PTHREAD_ONCE_INIT;
+
 struct ngl_ctx *ngl_create(void)
 {
+    pthread_once(&math_utils_once, ngli_math_utils_init);
+
     struct ngl_ctx *s = ngli_calloc(1, sizeof(*s));
     if (!s)
         return NULL;
@@ -320,11 +465,14 @@ struct ngl_ctx *ngl_create(void)
     s->rnode_pos = &s->rnode;
 
     ngli_darray_init(&s->modelview_matrix_stack, 4 * 4 * sizeof(float), 1);
+    ngli_darray_init(&s->modelview_version_stack, sizeof(int64_t), 0);
     ngli_darray_init(&s->projection_matrix_stack, 4 * 4 * sizeof(float), 1);
     ngli_darray_init(&s->activitycheck_nodes, sizeof(struct ngl_node *), 0);
 
     static const NGLI_ALIGNED_MAT(id_matrix) = NGLI_MAT4_IDENTITY;
+    static const int64_t id_version = 0;
     if (!ngli_darray_push(&s->modelview_matrix_stack, id_matrix) ||
+        !ngli_darray_push(&s->modelview_version_stack, &id_version) ||
         !ngli_darray_push(&s->projection_matrix_stack, id_matrix))
         goto fail;
 
@@ -354,11 +502,54 @@ int ngl_configure(struct ngl_ctx *s, struct ngl_config *config)
                 config->height);
             return NGL_ERROR_INVALID_ARG;
         }
+        if (config->capture_buffer && config->capture_callback) {
+            LOG(ERROR, "capture_buffer and capture_callback cannot be used simultaneously");
+            return NGL_ERROR_INVALID_ARG;
+        }
+        if (config->capture_shm_name) {
+#if defined(TARGET_LINUX)
+            if (config->capture_buffer || config->capture_callback) {
+                LOG(ERROR, "capture_shm_name cannot be combined with capture_buffer or capture_callback");
+                return NGL_ERROR_INVALID_ARG;
+            }
+            if (config->capture_shm_slots < 0) {
+                LOG(ERROR, "invalid number of shared memory capture slots %d", config->capture_shm_slots);
+                return NGL_ERROR_INVALID_ARG;
+            }
+#else
+            LOG(ERROR, "shared memory capture is only supported on Linux");
+            return NGL_ERROR_UNSUPPORTED;
+#endif
+        }
+        if (config->capture_format == NGL_CAPTURE_FORMAT_NV12 ||
+            config->capture_format == NGL_CAPTURE_FORMAT_I420) {
+            if (config->width % 4 || config->height % 2) {
+                LOG(ERROR, "NV12 and I420 capture requires a width multiple of 4 and an even height (%dx%d)",
+                    config->width, config->height);
+                return NGL_ERROR_INVALID_ARG;
+            }
+            if (config->capture_color_matrix != NGL_CAPTURE_COLOR_MATRIX_BT709 &&
+                config->capture_color_matrix != NGL_CAPTURE_COLOR_MATRIX_BT601) {
+                LOG(ERROR, "invalid capture color matrix %d", config->capture_color_matrix);
+                return NGL_ERROR_INVALID_ARG;
+            }
+        } else if (config->capture_format != NGL_CAPTURE_FORMAT_RGBA) {
+            LOG(ERROR, "unsupported capture format %d", config->capture_format);
+            return NGL_ERROR_INVALID_ARG;
+        }
     } else {
         if (config->capture_buffer) {
             LOG(ERROR, "capture_buffer is only supported with offscreen rendering");
             return NGL_ERROR_INVALID_ARG;
         }
+        if (config->capture_callback) {
+            LOG(ERROR, "capture_callback is only supported with offscreen rendering");
+            return NGL_ERROR_INVALID_ARG;
+        }
+        if (config->capture_shm_name) {
+            LOG(ERROR, "capture_shm_name is only supported with offscreen rendering");
+            return NGL_ERROR_INVALID_ARG;
+        }
     }
 
     s->configured = 0;
@@ -429,6 +620,35 @@ int ngl_draw(struct ngl_ctx *s, double t)
     return dispatch_cmd(s, cmd_draw, &t);
 }
 
+int ngl_warmup(struct ngl_ctx *s, double t_start, double t_end)
+{
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before warming up");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    if (t_end < t_start) {
+        LOG(ERROR, "warmup end time (%g) must not be before its start time (%g)", t_end, t_start);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    struct warmup_params params = {
+        .t_start = t_start,
+        .t_end = t_end,
+    };
+    return dispatch_cmd(s, cmd_warmup, &params);
+}
+
+int ngl_get_stats(struct ngl_ctx *s, struct ngl_stats *stats)
+{
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured before querying statistics");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    return dispatch_cmd(s, cmd_get_stats, stats);
+}
+
 void ngl_freep(struct ngl_ctx **ss)
 {
     struct ngl_ctx *s = *ss;
@@ -442,6 +662,7 @@ void ngl_freep(struct ngl_ctx **ss)
     stop_thread(s);
     ngli_rnode_reset(&s->rnode);
     ngli_darray_reset(&s->modelview_matrix_stack);
+    ngli_darray_reset(&s->modelview_version_stack);
     ngli_darray_reset(&s->projection_matrix_stack);
     ngli_darray_reset(&s->activitycheck_nodes);
     ngli_free(*ss);
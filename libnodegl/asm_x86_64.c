@@ -0,0 +1,199 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "math_utils.h"
+
+/*
+ * SSE is part of the x86-64 baseline and is always used. The AVX versions
+ * are built with a function target attribute and selected once by
+ * ngli_math_utils_init_x86_64(), so the library still runs on CPUs without
+ * AVX.
+ */
+
+int ngli_cpu_has_avx(void)
+{
+    return __builtin_cpu_supports("avx");
+}
+
+static inline __m128 mat4_mul_col(__m128 c0, __m128 c1, __m128 c2, __m128 c3, __m128 v)
+{
+    const __m128 r01 = _mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))),
+                                  _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+    const __m128 r23 = _mm_add_ps(_mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))),
+                                  _mm_mul_ps(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+    return _mm_add_ps(r01, r23);
+}
+
+void ngli_mat4_mul_sse(float *dst, const float *m1, const float *m2)
+{
+    const __m128 c0 = _mm_loadu_ps(m1);
+    const __m128 c1 = _mm_loadu_ps(m1 + 4);
+    const __m128 c2 = _mm_loadu_ps(m1 + 8);
+    const __m128 c3 = _mm_loadu_ps(m1 + 12);
+
+    const __m128 r0 = mat4_mul_col(c0, c1, c2, c3, _mm_loadu_ps(m2));
+    const __m128 r1 = mat4_mul_col(c0, c1, c2, c3, _mm_loadu_ps(m2 + 4));
+    const __m128 r2 = mat4_mul_col(c0, c1, c2, c3, _mm_loadu_ps(m2 + 8));
+    const __m128 r3 = mat4_mul_col(c0, c1, c2, c3, _mm_loadu_ps(m2 + 12));
+
+    /* Stored after all the loads since dst may alias m1 or m2 */
+    _mm_storeu_ps(dst,      r0);
+    _mm_storeu_ps(dst +  4, r1);
+    _mm_storeu_ps(dst +  8, r2);
+    _mm_storeu_ps(dst + 12, r3);
+}
+
+/* Two columns of the result are computed per 256-bit register */
+__attribute__((target("avx")))
+void ngli_mat4_mul_avx(float *dst, const float *m1, const float *m2)
+{
+    const __m256 c0 = _mm256_broadcast_ps((const __m128 *)m1);
+    const __m256 c1 = _mm256_broadcast_ps((const __m128 *)(m1 + 4));
+    const __m256 c2 = _mm256_broadcast_ps((const __m128 *)(m1 + 8));
+    const __m256 c3 = _mm256_broadcast_ps((const __m128 *)(m1 + 12));
+
+    const __m256 v01 = _mm256_loadu_ps(m2);
+    const __m256 v23 = _mm256_loadu_ps(m2 + 8);
+
+    const __m256 r01 = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(c0, _mm256_shuffle_ps(v01, v01, _MM_SHUFFLE(0, 0, 0, 0))),
+                      _mm256_mul_ps(c1, _mm256_shuffle_ps(v01, v01, _MM_SHUFFLE(1, 1, 1, 1)))),
+        _mm256_add_ps(_mm256_mul_ps(c2, _mm256_shuffle_ps(v01, v01, _MM_SHUFFLE(2, 2, 2, 2))),
+                      _mm256_mul_ps(c3, _mm256_shuffle_ps(v01, v01, _MM_SHUFFLE(3, 3, 3, 3)))));
+    const __m256 r23 = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(c0, _mm256_shuffle_ps(v23, v23, _MM_SHUFFLE(0, 0, 0, 0))),
+                      _mm256_mul_ps(c1, _mm256_shuffle_ps(v23, v23, _MM_SHUFFLE(1, 1, 1, 1)))),
+        _mm256_add_ps(_mm256_mul_ps(c2, _mm256_shuffle_ps(v23, v23, _MM_SHUFFLE(2, 2, 2, 2))),
+                      _mm256_mul_ps(c3, _mm256_shuffle_ps(v23, v23, _MM_SHUFFLE(3, 3, 3, 3)))));
+
+    _mm256_storeu_ps(dst, r01);
+    _mm256_storeu_ps(dst + 8, r23);
+}
+
+void (*ngli_mat4_mul_x86_64)(float *dst, const float *m1, const float *m2) = ngli_mat4_mul_sse;
+
+void ngli_math_utils_init_x86_64(void)
+{
+    if (ngli_cpu_has_avx())
+        ngli_mat4_mul_x86_64 = ngli_mat4_mul_avx;
+}
+
+void ngli_mat4_mul_vec4_sse(float *dst, const float *m, const float *v)
+{
+    const __m128 r = mat4_mul_col(_mm_loadu_ps(m),     _mm_loadu_ps(m + 4),
+                                  _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12),
+                                  _mm_loadu_ps(v));
+    _mm_storeu_ps(dst, r);
+}
+
+static inline __m128 cross(__m128 a, __m128 b)
+{
+    const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+/*
+ * The rows of the inverse are the cross products of the columns divided by
+ * the determinant. The last column is loaded from m + 5 to avoid reading past
+ * the end of the matrix.
+ */
+void ngli_mat3_inverse_sse(float *dst, const float *m)
+{
+    const __m128 c0 = _mm_loadu_ps(m);
+    const __m128 c1 = _mm_loadu_ps(m + 3);
+    const __m128 c2_5 = _mm_loadu_ps(m + 5);
+    const __m128 c2 = _mm_shuffle_ps(c2_5, c2_5, _MM_SHUFFLE(3, 3, 2, 1));
+
+    __m128 r0 = cross(c1, c2);
+    __m128 r1 = cross(c2, c0);
+    __m128 r2 = cross(c0, c1);
+
+    float d[4];
+    _mm_storeu_ps(d, _mm_mul_ps(c0, r0));
+    const float det = d[0] + d[1] + d[2];
+    if (det == 0.0f) {
+        /* Same fallback as the C version: the matrix is left untouched */
+        memmove(dst, m, 3 * 3 * sizeof(*m));
+        return;
+    }
+
+    __m128 r3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    const __m128 inv_det = _mm_set1_ps(1.0 / det);
+    r0 = _mm_mul_ps(r0, inv_det);
+    r1 = _mm_mul_ps(r1, inv_det);
+    r2 = _mm_mul_ps(r2, inv_det);
+
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + 3, r1);
+    _mm_storel_pi((__m64 *)(dst + 6), r2);
+    _mm_store_ss(dst + 8, _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(2, 2, 2, 2)));
+}
+
+static inline float dot4(__m128 a, __m128 b)
+{
+    float d[4];
+    _mm_storeu_ps(d, _mm_mul_ps(a, b));
+    return d[0] + d[1] + d[2] + d[3];
+}
+
+static inline __m128 norm4(__m128 v)
+{
+    const float l2 = dot4(v, v);
+    if (l2 == 0.0f)
+        return _mm_setzero_ps();
+    return _mm_mul_ps(v, _mm_set1_ps(1.0f / sqrtf(l2)));
+}
+
+#define COS_ALPHA_THRESHOLD 0.9995f
+
+void ngli_quat_slerp_sse(float *dst, const float *q1, const float *q2, float t)
+{
+    __m128 a = _mm_loadu_ps(q1);
+    const __m128 b = _mm_loadu_ps(q2);
+
+    float cos_alpha = dot4(a, b);
+    if (cos_alpha < 0.0f) {
+        cos_alpha = -cos_alpha;
+        a = _mm_sub_ps(_mm_setzero_ps(), a);
+    }
+
+    if (cos_alpha > COS_ALPHA_THRESHOLD) {
+        const __m128 r = _mm_add_ps(a, _mm_mul_ps(_mm_set1_ps(t), _mm_sub_ps(b, a)));
+        _mm_storeu_ps(dst, norm4(r));
+        return;
+    }
+
+    const float alpha = acosf(cos_alpha);
+    const float theta = alpha * t;
+
+    const __m128 ortho = norm4(_mm_sub_ps(b, _mm_mul_ps(a, _mm_set1_ps(cos_alpha))));
+    const __m128 r = _mm_add_ps(_mm_mul_ps(a, _mm_set1_ps(cosf(theta))),
+                                _mm_mul_ps(ortho, _mm_set1_ps(sinf(theta))));
+    _mm_storeu_ps(dst, r);
+}
@@ -27,6 +27,7 @@
 #include "backend.h"
 #include "glcontext.h"
 #include "memory.h"
+#include "readback.h"
 
 #if defined(TARGET_IPHONE)
 #include <CoreVideo/CoreVideo.h>
@@ -36,6 +37,8 @@
 #include "vaapi.h"
 #endif
 
+#define NGLI_CAPTURE_DEFAULT_LATENCY 2
+
 static int offscreen_rendertarget_init(struct ngl_ctx *s)
 {
     struct glcontext *gl = s->glcontext;
@@ -91,17 +94,36 @@ static void offscreen_rendertarget_reset(struct ngl_ctx *s)
     ngli_texture_reset(&s->rt_depth);
 }
 
-static void capture_default(struct ngl_ctx *s)
+/*
+ * Set the render target to read the captured frame from, converting the
+ * frame to a planar format first if requested
+ */
+static int convert_capture(struct ngl_ctx *s, struct rendertarget **rtp)
+{
+    if (!s->capture_yuvconv.ctx) {
+        *rtp = &s->capture_rt;
+        return 0;
+    }
+    *rtp = &s->capture_yuvconv.rt;
+    return ngli_yuvconv_convert(&s->capture_yuvconv);
+}
+
+static int capture_default(struct ngl_ctx *s)
 {
     struct ngl_config *config = &s->config;
     struct rendertarget *rt = &s->rt;
     struct rendertarget *capture_rt = &s->capture_rt;
 
     ngli_rendertarget_blit(rt, capture_rt, 1);
-    ngli_rendertarget_read_pixels(capture_rt, config->capture_buffer);
+    struct rendertarget *read_rt;
+    int ret = convert_capture(s, &read_rt);
+    if (ret < 0)
+        return ret;
+    ngli_rendertarget_read_pixels(read_rt, config->capture_buffer);
+    return 0;
 }
 
-static void capture_ios(struct ngl_ctx *s)
+static int capture_ios(struct ngl_ctx *s)
 {
     struct glcontext *gl = s->glcontext;
     struct rendertarget *rt = &s->rt;
@@ -109,9 +131,10 @@ static void capture_ios(struct ngl_ctx *s)
 
     ngli_rendertarget_blit(rt, capture_rt, 1);
     ngli_glFinish(gl);
+    return 0;
 }
 
-static void capture_gles_msaa(struct ngl_ctx *s)
+static int capture_gles_msaa(struct ngl_ctx *s)
 {
     struct ngl_config *config = &s->config;
     struct rendertarget *rt = &s->rt;
@@ -120,10 +143,15 @@ static void capture_gles_msaa(struct ngl_ctx *s)
 
     ngli_rendertarget_blit(rt, oes_resolve_rt, 0);
     ngli_rendertarget_blit(oes_resolve_rt, capture_rt, 1);
-    ngli_rendertarget_read_pixels(capture_rt, config->capture_buffer);
+    struct rendertarget *read_rt;
+    int ret = convert_capture(s, &read_rt);
+    if (ret < 0)
+        return ret;
+    ngli_rendertarget_read_pixels(read_rt, config->capture_buffer);
+    return 0;
 }
 
-static void capture_ios_msaa(struct ngl_ctx *s)
+static int capture_ios_msaa(struct ngl_ctx *s)
 {
     struct glcontext *gl = s->glcontext;
     struct rendertarget *rt = &s->rt;
@@ -133,9 +161,10 @@ static void capture_ios_msaa(struct ngl_ctx *s)
     ngli_rendertarget_blit(rt, oes_resolve_rt, 0);
     ngli_rendertarget_blit(oes_resolve_rt, capture_rt, 1);
     ngli_glFinish(gl);
+    return 0;
 }
 
-static void capture_cpu_fallback(struct ngl_ctx *s)
+static int capture_cpu_fallback(struct ngl_ctx *s)
 {
     struct ngl_config *config = &s->config;
     struct rendertarget *rt = &s->rt;
@@ -149,6 +178,35 @@ static void capture_cpu_fallback(struct ngl_ctx *s)
         dst += step;
         src -= step;
     }
+    return 0;
+}
+
+static int capture_async(struct ngl_ctx *s)
+{
+    struct rendertarget *rt = &s->rt;
+    struct rendertarget *capture_rt = &s->capture_rt;
+
+    ngli_rendertarget_blit(rt, capture_rt, 1);
+    struct rendertarget *read_rt;
+    int ret = convert_capture(s, &read_rt);
+    if (ret < 0)
+        return ret;
+    return ngli_readback_read(&s->readback, read_rt, s->frame_time);
+}
+
+static int capture_gles_msaa_async(struct ngl_ctx *s)
+{
+    struct rendertarget *rt = &s->rt;
+    struct rendertarget *capture_rt = &s->capture_rt;
+    struct rendertarget *oes_resolve_rt = &s->oes_resolve_rt;
+
+    ngli_rendertarget_blit(rt, oes_resolve_rt, 0);
+    ngli_rendertarget_blit(oes_resolve_rt, capture_rt, 1);
+    struct rendertarget *read_rt;
+    int ret = convert_capture(s, &read_rt);
+    if (ret < 0)
+        return ret;
+    return ngli_readback_read(&s->readback, read_rt, s->frame_time);
 }
 
 static int capture_init(struct ngl_ctx *s)
@@ -156,11 +214,19 @@ static int capture_init(struct ngl_ctx *s)
     struct glcontext *gl = s->glcontext;
     struct ngl_config *config = &s->config;
     const int ios_capture = gl->platform == NGL_PLATFORM_IOS && config->window;
+    const int planar_capture = config->capture_format == NGL_CAPTURE_FORMAT_NV12 ||
+                               config->capture_format == NGL_CAPTURE_FORMAT_I420;
+    const int async_capture = config->capture_callback || config->capture_shm_name;
 
-    if (!config->capture_buffer && !ios_capture)
+    if (!config->capture_buffer && !async_capture && !ios_capture)
         return 0;
 
     if (gl->features & NGLI_FEATURE_FRAMEBUFFER_OBJECT) {
+        if (ios_capture && planar_capture) {
+            LOG(ERROR, "planar capture is not supported when capturing to a CVPixelBuffer");
+            return NGL_ERROR_UNSUPPORTED;
+        }
+
         if (ios_capture) {
 #if defined(TARGET_IPHONE)
             CVPixelBufferRef capture_cvbuffer = (CVPixelBufferRef)config->window;
@@ -189,10 +255,10 @@ static int capture_init(struct ngl_ctx *s)
             }
 
             GLuint id = CVOpenGLESTextureGetName(s->capture_cvtexture);
-            ngli_glBindTexture(gl, GL_TEXTURE_2D, id);
+            ngli_glstate_bind_texture(gl, &s->glstate, GL_TEXTURE_2D, id);
             ngli_glTexParameteri(gl, GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             ngli_glTexParameteri(gl, GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            ngli_glBindTexture(gl, GL_TEXTURE_2D, 0);
+            ngli_glstate_bind_texture(gl, &s->glstate, GL_TEXTURE_2D, 0);
 
             struct texture_params attachment_params = NGLI_TEXTURE_PARAM_DEFAULTS;
             attachment_params.format = NGLI_FORMAT_B8G8R8A8_UNORM;
@@ -207,7 +273,13 @@ static int capture_init(struct ngl_ctx *s)
             attachment_params.format = NGLI_FORMAT_R8G8B8A8_UNORM;
             attachment_params.width = config->width;
             attachment_params.height = config->height;
-            attachment_params.usage = NGLI_TEXTURE_USAGE_ATTACHMENT_ONLY;
+            if (planar_capture) {
+                /* The planar conversion samples the frame with bilinear filtering */
+                attachment_params.min_filter = NGLI_FILTER_LINEAR;
+                attachment_params.mag_filter = NGLI_FILTER_LINEAR;
+            } else {
+                attachment_params.usage = NGLI_TEXTURE_USAGE_ATTACHMENT_ONLY;
+            }
             int ret = ngli_texture_init(&s->capture_rt_color, s, &attachment_params);
             if (ret < 0)
                 return ret;
@@ -248,17 +320,66 @@ static int capture_init(struct ngl_ctx *s)
             if (ret < 0)
                 return ret;
 
-            s->capture_func = config->capture_buffer ? capture_gles_msaa : capture_ios_msaa;
+            s->capture_func = async_capture            ? capture_gles_msaa_async :
+                              config->capture_buffer   ? capture_gles_msaa : capture_ios_msaa;
         } else {
-            s->capture_func = config->capture_buffer ? capture_default : capture_ios;
+            s->capture_func = async_capture            ? capture_async :
+                              config->capture_buffer   ? capture_default : capture_ios;
+        }
+
+        if (planar_capture) {
+            struct color_info color_info = NGLI_COLOR_INFO_DEFAULTS;
+            color_info.space = config->capture_color_matrix == NGL_CAPTURE_COLOR_MATRIX_BT601 ? SXPLAYER_COL_SPC_BT470BG
+                                                                                              : SXPLAYER_COL_SPC_BT709;
+            color_info.range = config->capture_full_range ? SXPLAYER_COL_RNG_FULL : SXPLAYER_COL_RNG_LIMITED;
+            ret = ngli_yuvconv_init(&s->capture_yuvconv, s, &s->capture_rt_color,
+                                    config->capture_format, &color_info);
+            if (ret < 0)
+                return ret;
         }
 
+        if (async_capture) {
+            ngl_capture_callback callback = config->capture_callback;
+            void *user_data = config->capture_user_data;
+#if defined(TARGET_LINUX)
+            if (config->capture_shm_name) {
+                callback = ngli_capture_shm_write;
+                user_data = &s->capture_shm;
+            }
+#endif
+            const int latency = config->capture_latency ? config->capture_latency : NGLI_CAPTURE_DEFAULT_LATENCY;
+            struct rendertarget *readback_rt = planar_capture ? &s->capture_yuvconv.rt : &s->capture_rt;
+            ret = ngli_readback_init(&s->readback, s, readback_rt, config->capture_format, latency,
+                                     callback, user_data);
+            if (ret < 0)
+                return ret;
+        }
+
+#if defined(TARGET_LINUX)
+        if (config->capture_shm_name) {
+            const int nb_slots = config->capture_shm_slots ? config->capture_shm_slots : NGLI_CAPTURE_SHM_DEFAULT_SLOTS;
+            ret = ngli_capture_shm_init(&s->capture_shm, config->capture_shm_name, nb_slots, s->readback.size);
+            if (ret < 0)
+                return ret;
+        }
+#endif
+
     } else {
         if (ios_capture) {
             LOG(WARNING, "context does not support the framebuffer object feature, "
                 "capturing to a CVPixelBuffer is not supported");
             return NGL_ERROR_UNSUPPORTED;
         }
+        if (async_capture) {
+            LOG(ERROR, "context does not support the framebuffer object feature, "
+                "asynchronous capture is not supported");
+            return NGL_ERROR_UNSUPPORTED;
+        }
+        if (planar_capture) {
+            LOG(ERROR, "context does not support the framebuffer object feature, "
+                "planar capture is not supported");
+            return NGL_ERROR_UNSUPPORTED;
+        }
         s->capture_buffer = ngli_calloc(config->width * config->height, 4 /* RGBA */);
         if (!s->capture_buffer)
             return NGL_ERROR_MEMORY;
@@ -273,6 +394,16 @@ static int capture_init(struct ngl_ctx *s)
 
 static void capture_reset(struct ngl_ctx *s)
 {
+#if defined(TARGET_LINUX)
+    s->capture_shm.closing = 1;
+#endif
+    /* Deliver the frames still in flight before releasing their buffers */
+    ngli_readback_flush(&s->readback);
+    ngli_readback_reset(&s->readback);
+#if defined(TARGET_LINUX)
+    ngli_capture_shm_reset(&s->capture_shm);
+#endif
+    ngli_yuvconv_reset(&s->capture_yuvconv);
     ngli_rendertarget_reset(&s->capture_rt);
     ngli_texture_reset(&s->capture_rt_color);
     ngli_rendertarget_reset(&s->oes_resolve_rt);
@@ -303,14 +434,12 @@ static int gl_configure(struct ngl_ctx *s, const struct ngl_config *config)
         return NGL_ERROR_MEMORY;
 
     struct glcontext *gl = s->glcontext;
+    ngli_glstate_probe(gl, &s->glstate);
+
     if (gl->offscreen) {
         ret = offscreen_rendertarget_init(s);
         if (ret < 0)
             return ret;
-
-        ret = capture_init(s);
-        if (ret < 0)
-            return ret;
     }
 
     s->default_rendertarget_desc.nb_colors = 1;
@@ -322,12 +451,22 @@ static int gl_configure(struct ngl_ctx *s, const struct ngl_config *config)
     s->default_rendertarget_desc.depth_stencil.resolve = gl->samples > 1;
     s->rendertarget_desc = &s->default_rendertarget_desc;
 
-    ngli_glstate_probe(gl, &s->glstate);
-
     ret = ngli_pgcache_init(&s->pgcache, s);
     if (ret < 0)
         return ret;
 
+    ret = ngli_bufcache_init(&s->bufcache, s);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_geomcache_init(&s->geomcache, s);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_ubopool_init(&s->ubopool, s);
+    if (ret < 0)
+        return ret;
+
     /* This field is used by the pipeline API in order to reduce the total
      * number of GL program switches. This means pipeline draw calls may alter
      * this value, but we don't want it to be hard-reconfigure resilient (the
@@ -351,6 +490,14 @@ static int gl_configure(struct ngl_ctx *s, const struct ngl_config *config)
     struct graphicstate *graphicstate = &s->graphicstate;
     ngli_graphicstate_init(graphicstate);
 
+    /* The capture may need the program cache and the default graphic state
+     * to convert the frames */
+    if (gl->offscreen) {
+        ret = capture_init(s);
+        if (ret < 0)
+            return ret;
+    }
+
 #if defined(HAVE_VAAPI)
     ret = ngli_vaapi_init(s);
     if (ret < 0)
@@ -370,6 +517,10 @@ static int gl_resize(struct ngl_ctx *s, int width, int height, const int *viewpo
     if (ret < 0)
         return ret;
 
+    /* The windowing system may have rebound its own framebuffer and reset
+     * the viewport while resizing */
+    ngli_glstate_probe_framebuffer(gl, &s->glstate);
+
     if (viewport && viewport[2] > 0 && viewport[3] > 0) {
         ngli_gctx_set_viewport(s, viewport);
     } else {
@@ -385,6 +536,8 @@ static int gl_resize(struct ngl_ctx *s, int width, int height, const int *viewpo
 
 static int gl_pre_draw(struct ngl_ctx *s, double t)
 {
+    s->frame_time = t;
+
     ngli_gctx_clear_color(s);
     ngli_gctx_clear_depth_stencil(s);
 
@@ -397,11 +550,12 @@ static int gl_post_draw(struct ngl_ctx *s, double t)
     struct ngl_config *config = &s->config;
 
     ngli_glstate_update(s, &s->graphicstate);
+    ngli_ubopool_end_frame(&s->ubopool);
 
+    int ret = 0;
     if (s->capture_func)
-        s->capture_func(s);
+        ret = s->capture_func(s);
 
-    int ret = 0;
     if (ngli_glcontext_check_gl_error(gl, __FUNCTION__))
         ret = -1;
 
@@ -415,8 +569,13 @@ static int gl_post_draw(struct ngl_ctx *s, double t)
 
 static void gl_destroy(struct ngl_ctx *s)
 {
-    ngli_pgcache_reset(&s->pgcache);
+    /* The capture resources may hold a program from the cache */
     capture_reset(s);
+    ngli_glstate_reset(&s->glstate);
+    ngli_pgcache_reset(&s->pgcache);
+    ngli_bufcache_reset(&s->bufcache);
+    ngli_geomcache_reset(&s->geomcache);
+    ngli_ubopool_reset(&s->ubopool);
     offscreen_rendertarget_reset(s);
 #if defined(HAVE_VAAPI)
     ngli_vaapi_reset(s);
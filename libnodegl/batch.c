@@ -0,0 +1,1207 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "batch.h"
+#include "bstr.h"
+#include "format.h"
+#include "glcontext.h"
+#include "log.h"
+#include "math_utils.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "nodes.h"
+#include "pgcache.h"
+#include "topology.h"
+#include "type.h"
+#include "utils.h"
+
+enum {
+    VARIABLE_UNIFORM,
+    VARIABLE_MODELVIEW_MATRIX,
+    VARIABLE_NORMAL_MATRIX,
+};
+
+#define NB_STAGES 2
+
+struct variable_decl {
+    int start;
+    int end;
+    char precision[16];
+};
+
+/*
+ * A variable differing between the batched Render nodes: it is removed from
+ * the uniforms of the program and fed through an instanced vertex attribute
+ * instead.
+ */
+struct batch_variable {
+    char name[MAX_ID_LEN];
+    int kind;
+    int type;
+    int offset;
+    int size;
+    struct variable_decl decls[NB_STAGES];
+};
+
+static const char * const glsl_types[NGLI_TYPE_NB] = {
+    [NGLI_TYPE_FLOAT] = "float",
+    [NGLI_TYPE_VEC2]  = "vec2",
+    [NGLI_TYPE_VEC3]  = "vec3",
+    [NGLI_TYPE_VEC4]  = "vec4",
+    [NGLI_TYPE_MAT3]  = "mat3",
+    [NGLI_TYPE_MAT4]  = "mat4",
+};
+
+static const int column_formats[NGLI_TYPE_NB] = {
+    [NGLI_TYPE_FLOAT] = NGLI_FORMAT_R32_SFLOAT,
+    [NGLI_TYPE_VEC2]  = NGLI_FORMAT_R32G32_SFLOAT,
+    [NGLI_TYPE_VEC3]  = NGLI_FORMAT_R32G32B32_SFLOAT,
+    [NGLI_TYPE_VEC4]  = NGLI_FORMAT_R32G32B32A32_SFLOAT,
+    [NGLI_TYPE_MAT3]  = NGLI_FORMAT_R32G32B32_SFLOAT,
+    [NGLI_TYPE_MAT4]  = NGLI_FORMAT_R32G32B32A32_SFLOAT,
+};
+
+static int is_transform(const struct ngl_node *node)
+{
+    switch (node->class->id) {
+    case NGL_NODE_ROTATE:
+    case NGL_NODE_ROTATEQUAT:
+    case NGL_NODE_SCALE:
+    case NGL_NODE_TRANSFORM:
+    case NGL_NODE_TRANSLATE:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static struct ngl_node *get_render(struct ngl_node *node)
+{
+    while (is_transform(node)) {
+        const struct transform_priv *transform = node->priv_data;
+        node = transform->child;
+    }
+    return node->class->id == NGL_NODE_RENDER ? node : NULL;
+}
+
+static int hmap_equal(const struct hmap *a, const struct hmap *b)
+{
+    const int count_a = a ? ngli_hmap_count(a) : 0;
+    const int count_b = b ? ngli_hmap_count(b) : 0;
+    if (count_a != count_b)
+        return 0;
+    if (!count_a)
+        return 1;
+
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(a, entry)))
+        if (ngli_hmap_get(b, entry->key) != entry->data)
+            return 0;
+    return 1;
+}
+
+static int is_instanceable(const struct ngl_node *uniform)
+{
+    if (uniform->class->category != NGLI_NODE_CATEGORY_UNIFORM)
+        return 0;
+    const struct variable_priv *variable = uniform->priv_data;
+    switch (variable->data_type) {
+    case NGLI_TYPE_FLOAT:
+    case NGLI_TYPE_VEC2:
+    case NGLI_TYPE_VEC3:
+    case NGLI_TYPE_VEC4:
+    case NGLI_TYPE_MAT4:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+#define NB_GEOMETRY_ATTRIBUTES 3
+
+static const char * const geometry_attributes[NB_GEOMETRY_ATTRIBUTES] = {
+    "ngl_position",
+    "ngl_uvcoord",
+    "ngl_normal",
+};
+
+static void get_geometry_buffers(const struct ngl_node *geometry, const struct ngl_node **buffers)
+{
+    const struct geometry_priv *geometry_priv = geometry->priv_data;
+    buffers[0] = geometry_priv->vertices_buffer;
+    buffers[1] = geometry_priv->uvcoords_buffer;
+    buffers[2] = geometry_priv->normals_buffer;
+    buffers[3] = geometry_priv->indices_buffer;
+}
+
+static int get_list_topology(int topology)
+{
+    switch (topology) {
+    case NGLI_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+        return NGLI_PRIMITIVE_TOPOLOGY_LINE_LIST;
+    case NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+    case NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+        return NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    default:
+        return topology;
+    }
+}
+
+/*
+ * Different geometries can be merged into the same buffers if they share the
+ * vertex layout, their data is static and their primitives can be expressed
+ * with the same list topology.
+ */
+static int can_merge_geometries(const struct ngl_node *a, const struct ngl_node *b)
+{
+    const struct geometry_priv *geometry_a = a->priv_data;
+    const struct geometry_priv *geometry_b = b->priv_data;
+    if (get_list_topology(geometry_a->topology) != get_list_topology(geometry_b->topology))
+        return 0;
+
+    const struct ngl_node *buffers_a[NB_GEOMETRY_ATTRIBUTES + 1];
+    const struct ngl_node *buffers_b[NB_GEOMETRY_ATTRIBUTES + 1];
+    get_geometry_buffers(a, buffers_a);
+    get_geometry_buffers(b, buffers_b);
+    for (int i = 0; i < NGLI_ARRAY_NB(buffers_a); i++) {
+        const int is_indices = i == NB_GEOMETRY_ATTRIBUTES;
+        if (!is_indices && !buffers_a[i] != !buffers_b[i])
+            return 0;
+        if (!buffers_a[i] || !buffers_b[i])
+            continue;
+        const struct buffer_priv *buffer_a = buffers_a[i]->priv_data;
+        const struct buffer_priv *buffer_b = buffers_b[i]->priv_data;
+        if (buffer_a->dynamic || buffer_b->dynamic ||
+            buffer_a->block || buffer_b->block)
+            return 0;
+        /* Indices are converted to a common format if needed */
+        if (!is_indices && buffer_a->data_format != buffer_b->data_format)
+            return 0;
+    }
+    return 1;
+}
+
+static int can_merge(const struct render_priv *a, const struct render_priv *b)
+{
+    if (a->geometry != b->geometry &&
+        (!hmap_equal(a->attributes, NULL) ||
+         !hmap_equal(b->attributes, NULL) ||
+         !can_merge_geometries(a->geometry, b->geometry)))
+        return 0;
+
+    /* The instances of a batch can not be culled individually */
+    if (a->program != b->program ||
+        a->culling || b->culling ||
+        a->specialize_uniforms || b->specialize_uniforms ||
+        a->nb_instances || b->nb_instances ||
+        !hmap_equal(a->instance_attributes, NULL) ||
+        !hmap_equal(b->instance_attributes, NULL) ||
+        !hmap_equal(a->textures, b->textures) ||
+        !hmap_equal(a->blocks, b->blocks) ||
+        !hmap_equal(a->attributes, b->attributes))
+        return 0;
+
+    const int count_a = a->uniforms ? ngli_hmap_count(a->uniforms) : 0;
+    const int count_b = b->uniforms ? ngli_hmap_count(b->uniforms) : 0;
+    if (count_a != count_b)
+        return 0;
+    if (!count_a)
+        return 1;
+
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(a->uniforms, entry))) {
+        const struct ngl_node *uniform_a = entry->data;
+        const struct ngl_node *uniform_b = ngli_hmap_get(b->uniforms, entry->key);
+        if (uniform_a == uniform_b)
+            continue;
+        if (!uniform_b || !is_instanceable(uniform_a) || !is_instanceable(uniform_b))
+            return 0;
+        const struct variable_priv *variable_a = uniform_a->priv_data;
+        const struct variable_priv *variable_b = uniform_b->priv_data;
+        if (variable_a->data_type != variable_b->data_type)
+            return 0;
+    }
+    return 1;
+}
+
+int ngli_batch_get_run_length(struct ngl_node **children, int nb_children)
+{
+    const struct ngl_node *first = get_render(children[0]);
+    if (!first)
+        return 0;
+
+    int i;
+    for (i = 1; i < nb_children; i++) {
+        const struct ngl_node *render = get_render(children[i]);
+        if (!render || !can_merge(first->priv_data, render->priv_data))
+            break;
+    }
+    return i;
+}
+
+static int add_variable(struct render_batch *s, const char *name, int kind, int type)
+{
+    struct batch_variable variable = {
+        .kind  = kind,
+        .type  = type,
+        .decls = {{.start = -1}, {.start = -1}},
+    };
+    snprintf(variable.name, sizeof(variable.name), "%s", name);
+    if (!ngli_darray_push(&s->variables, &variable))
+        return NGL_ERROR_MEMORY;
+    return 0;
+}
+
+static int is_ident_char(int c)
+{
+    return isalnum(c) || c == '_';
+}
+
+/*
+ * Minimal GLSL tokenizer: returns the position following the next token
+ * (identifier, number, preprocessor line or punctuation character), skipping
+ * blanks and comments, or NULL at the end of the source.
+ */
+static const char *next_token(const char *p, const char **tokp, int *lenp)
+{
+    for (;;) {
+        while (isspace((unsigned char)*p))
+            p++;
+        if (p[0] == '/' && p[1] == '/') {
+            p += strcspn(p, "\n");
+        } else if (p[0] == '/' && p[1] == '*') {
+            const char *end = strstr(p + 2, "*/");
+            p = end ? end + 2 : p + strlen(p);
+        } else {
+            break;
+        }
+    }
+
+    if (!*p)
+        return NULL;
+
+    const char *tok = p;
+    if (*p == '#') {
+        p += strcspn(p, "\n");
+    } else if (is_ident_char((unsigned char)*p)) {
+        while (is_ident_char((unsigned char)*p))
+            p++;
+    } else {
+        p++;
+    }
+    *tokp = tok;
+    *lenp = p - tok;
+    return p;
+}
+
+static int token_equals(const char *tok, int len, const char *str)
+{
+    return strlen(str) == len && !strncmp(tok, str, len);
+}
+
+static struct batch_variable *find_variable(struct render_batch *s, const char *tok, int len)
+{
+    struct batch_variable *variables = ngli_darray_data(&s->variables);
+    for (int i = 0; i < ngli_darray_count(&s->variables); i++)
+        if (token_equals(tok, len, variables[i].name))
+            return &variables[i];
+    return NULL;
+}
+
+static int is_precision(const char *tok, int len)
+{
+    return token_equals(tok, len, "lowp") ||
+           token_equals(tok, len, "mediump") ||
+           token_equals(tok, len, "highp");
+}
+
+/*
+ * Locate the declarations of the batched variables in the shader. Only the
+ * plain "uniform [precision] type name;" form can be rewritten, any other
+ * construct referencing them prevents the batching.
+ */
+static int parse_shader(struct render_batch *s, const char *src, int stage, int *version_endp)
+{
+    const char *tok;
+    int len;
+    const char *p = next_token(src, &tok, &len);
+    if (!p || !token_equals(tok, NGLI_MIN(len, 8), "#version")) {
+        LOG(DEBUG, "shaders without an explicit version can not be batched");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    char line[32];
+    char profile[3] = {0};
+    int version = 0;
+    snprintf(line, sizeof(line), "%.*s", len, tok);
+    sscanf(line, "#version %d %2s", &version, profile);
+    const int es = !strcmp(profile, "es");
+    if (version < (es ? 300 : 330)) {
+        LOG(DEBUG, "GLSL version %d%s is too old to be batched", version, es ? " es" : "");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+    *version_endp = p - src;
+
+    int depth = 0;
+    int qualified = 0;
+    while ((p = next_token(p, &tok, &len))) {
+        if (*tok == '{')
+            depth++;
+        else if (*tok == '}')
+            depth--;
+
+        if (depth || !token_equals(tok, len, "uniform")) {
+            qualified = *tok == ')';
+            continue;
+        }
+
+        const char *start = tok;
+        const char *words[3];
+        int lens[3];
+        int nb_words = 0;
+        int simple = !qualified;
+        int referenced = 0;
+        int block_depth = 0;
+        while ((p = next_token(p, &tok, &len))) {
+            if (*tok == ';' && !block_depth)
+                break;
+            if (*tok == '{')
+                block_depth++;
+            else if (*tok == '}')
+                block_depth--;
+
+            if (!is_ident_char((unsigned char)*tok)) {
+                simple = 0;
+                continue;
+            }
+            if (find_variable(s, tok, len))
+                referenced = 1;
+            if (nb_words < NGLI_ARRAY_NB(words)) {
+                words[nb_words] = tok;
+                lens[nb_words] = len;
+            }
+            nb_words++;
+        }
+        if (!p)
+            return NGL_ERROR_UNSUPPORTED;
+
+        const int has_precision = nb_words == 3 && is_precision(words[0], lens[0]);
+        simple &= nb_words == 2 || has_precision;
+        if (!simple) {
+            if (referenced) {
+                LOG(DEBUG, "unsupported uniform declaration: %.*s", (int)(p - start), start);
+                return NGL_ERROR_UNSUPPORTED;
+            }
+            continue;
+        }
+
+        struct batch_variable *variable = find_variable(s, words[nb_words - 1], lens[nb_words - 1]);
+        if (!variable)
+            continue;
+
+        struct variable_decl *decl = &variable->decls[stage];
+        if (decl->start >= 0 || !token_equals(words[nb_words - 2], lens[nb_words - 2], glsl_types[variable->type])) {
+            LOG(DEBUG, "unsupported declaration of uniform %s", variable->name);
+            return NGL_ERROR_UNSUPPORTED;
+        }
+        decl->start = start - src;
+        decl->end = p - src;
+        if (has_precision)
+            snprintf(decl->precision, sizeof(decl->precision), "%.*s ", lens[0], words[0]);
+    }
+
+    return 0;
+}
+
+/*
+ * Rewrite the shader so that the batched variables are read from instanced
+ * vertex attributes. The vertex shader main() is wrapped to copy the
+ * attributes into the original names, and into flat varyings for the
+ * variables used by the fragment shader.
+ */
+static char *shim_shader(struct render_batch *s, const char *src, int stage, int version_end)
+{
+    const struct batch_variable *variables = ngli_darray_data(&s->variables);
+    const int nb_variables = ngli_darray_count(&s->variables);
+    const int vert = stage == NGLI_PROGRAM_SHADER_VERT;
+
+    struct bstr *b = ngli_bstr_create();
+    if (!b)
+        return NULL;
+
+    ngli_bstr_printf(b, "%.*s\n", version_end, src);
+    if (vert)
+        ngli_bstr_print(b, "#define main ngli_main\n");
+
+    int pos = version_end;
+    for (;;) {
+        const struct batch_variable *next = NULL;
+        for (int i = 0; i < nb_variables; i++) {
+            const struct variable_decl *decl = &variables[i].decls[stage];
+            if (decl->start >= pos && (!next || decl->start < next->decls[stage].start))
+                next = &variables[i];
+        }
+        if (!next)
+            break;
+
+        const struct variable_decl *decl = &next->decls[stage];
+        const char *qualifier = !vert ? "flat in "
+                              : next->decls[NGLI_PROGRAM_SHADER_FRAG].start >= 0 ? "flat out "
+                              : "";
+        ngli_bstr_printf(b, "%.*s%s%s%s %s;", decl->start - pos, src + pos,
+                         qualifier, decl->precision, glsl_types[next->type], next->name);
+        pos = decl->end;
+    }
+    ngli_bstr_print(b, src + pos);
+
+    if (vert) {
+        ngli_bstr_print(b, "\n#undef main\n");
+        for (int i = 0; i < nb_variables; i++) {
+            const struct batch_variable *variable = &variables[i];
+            const char *type = glsl_types[variable->type];
+            ngli_bstr_printf(b, "in %s ngli_instance_%s;\n", type, variable->name);
+            if (variable->decls[NGLI_PROGRAM_SHADER_VERT].start < 0) {
+                const char *precision = variable->decls[NGLI_PROGRAM_SHADER_FRAG].precision;
+                ngli_bstr_printf(b, "flat out %s%s %s;\n", precision, type, variable->name);
+            }
+        }
+        ngli_bstr_print(b, "void main()\n{\n");
+        for (int i = 0; i < nb_variables; i++)
+            ngli_bstr_printf(b, "    %s = ngli_instance_%s;\n", variables[i].name, variables[i].name);
+        ngli_bstr_print(b, "    ngli_main();\n}\n");
+    }
+
+    char *ret = ngli_bstr_strdup(b);
+    ngli_bstr_freep(&b);
+    return ret;
+}
+
+static int init_program(struct render_batch *s, const struct program_priv *program)
+{
+    int ret;
+    int version_ends[NB_STAGES];
+    if ((ret = parse_shader(s, program->vertex, NGLI_PROGRAM_SHADER_VERT, &version_ends[0])) < 0 ||
+        (ret = parse_shader(s, program->fragment, NGLI_PROGRAM_SHADER_FRAG, &version_ends[1])) < 0)
+        return ret;
+
+    /* Drop the variables unused by the shaders */
+    struct batch_variable *variables = ngli_darray_data(&s->variables);
+    int nb_variables = 0;
+    for (int i = 0; i < ngli_darray_count(&s->variables); i++) {
+        const struct batch_variable *variable = &variables[i];
+        if (variable->decls[NGLI_PROGRAM_SHADER_VERT].start < 0 &&
+            variable->decls[NGLI_PROGRAM_SHADER_FRAG].start < 0)
+            continue;
+        variables[nb_variables++] = *variable;
+    }
+    while (ngli_darray_count(&s->variables) > nb_variables)
+        ngli_darray_pop(&s->variables);
+
+    if (!nb_variables) {
+        LOG(DEBUG, "the batched Render nodes would draw identical instances");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    char *vertex = shim_shader(s, program->vertex, NGLI_PROGRAM_SHADER_VERT, version_ends[0]);
+    char *fragment = shim_shader(s, program->fragment, NGLI_PROGRAM_SHADER_FRAG, version_ends[1]);
+    if (!vertex || !fragment) {
+        ngli_free(vertex);
+        ngli_free(fragment);
+        return NGL_ERROR_MEMORY;
+    }
+
+    ret = ngli_pgcache_get_graphics_program(&s->ctx->pgcache, &s->program, vertex, fragment);
+    ngli_free(vertex);
+    ngli_free(fragment);
+    if (ret < 0) {
+        LOG(WARNING, "could not build the instanced program");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    return 0;
+}
+
+static int init_instance_data(struct render_batch *s)
+{
+    struct batch_variable *variables = ngli_darray_data(&s->variables);
+    const int nb_variables = ngli_darray_count(&s->variables);
+
+    for (int i = 0; i < nb_variables; i++) {
+        struct batch_variable *variable = &variables[i];
+        variable->offset = s->instance_stride;
+        variable->size = ngli_type_get_size(variable->type);
+        s->instance_stride += variable->size;
+    }
+
+    s->instance_data = ngli_calloc(s->nb_children, s->instance_stride);
+    s->instance_uniforms = ngli_calloc(s->nb_children * nb_variables, sizeof(*s->instance_uniforms));
+    if (!s->instance_data || !s->instance_uniforms)
+        return NGL_ERROR_MEMORY;
+
+    /* Packed vertices carry a copy of the variables of their Render */
+    const int packed = s->mode == NGLI_BATCH_MODE_PACKED;
+    if (packed) {
+        s->vertex_data = ngli_calloc(s->nb_vertices, s->instance_stride);
+        if (!s->vertex_data)
+            return NGL_ERROR_MEMORY;
+    }
+
+    for (int i = 0; i < s->nb_children; i++) {
+        const struct ngl_node *render = get_render(s->children[i]);
+        const struct render_priv *render_priv = render->priv_data;
+        for (int j = 0; j < nb_variables; j++) {
+            if (variables[j].kind == VARIABLE_UNIFORM)
+                s->instance_uniforms[i * nb_variables + j] = ngli_hmap_get(render_priv->uniforms, variables[j].name);
+        }
+    }
+
+    const int nb_rows = packed ? s->nb_vertices : s->nb_children;
+    int ret = ngli_buffer_init(&s->instance_buffer, s->ctx, nb_rows * s->instance_stride, NGLI_BUFFER_USAGE_DYNAMIC);
+    if (ret < 0)
+        return ret;
+
+    for (int i = 0; i < nb_variables; i++) {
+        const struct batch_variable *variable = &variables[i];
+
+        char name[MAX_ID_LEN];
+        snprintf(name, sizeof(name), "ngli_instance_%s", variable->name);
+        const struct program_variable_info *info = ngli_hmap_get(s->program.attributes, name);
+        if (!info)
+            continue;
+
+        const int nb_columns = variable->type == NGLI_TYPE_MAT4 ? 4
+                             : variable->type == NGLI_TYPE_MAT3 ? 3
+                             : 1;
+        const int column_size = variable->size / nb_columns;
+        for (int j = 0; j < nb_columns; j++) {
+            struct pipeline_attribute attribute = {
+                .location = info->location + j,
+                .format   = column_formats[variable->type],
+                .stride   = s->instance_stride,
+                .offset   = variable->offset + j * column_size,
+                .rate     = !packed,
+                .buffer   = &s->instance_buffer,
+            };
+            snprintf(attribute.name, sizeof(attribute.name), "%s", name);
+            if (!ngli_darray_push(&s->attributes, &attribute))
+                return NGL_ERROR_MEMORY;
+        }
+    }
+
+    return 0;
+}
+
+struct draw_elements_command {
+    uint32_t count;
+    uint32_t instance_count;
+    uint32_t first_index;
+    int32_t base_vertex;
+    uint32_t base_instance;
+};
+
+struct draw_arrays_command {
+    uint32_t count;
+    uint32_t instance_count;
+    uint32_t first;
+    uint32_t base_instance;
+};
+
+static int init_static_buffer(struct buffer *buffer, struct ngl_ctx *ctx, const void *data, int size)
+{
+    int ret = ngli_buffer_init(buffer, ctx, size, NGLI_BUFFER_USAGE_STATIC);
+    if (ret < 0)
+        return ret;
+    return ngli_buffer_upload(buffer, data, size, 0);
+}
+
+static int alloc_geometry_data(const struct ngl_node **buffers, uint8_t **data, int nb_vertices)
+{
+    for (int k = 0; k < NB_GEOMETRY_ATTRIBUTES; k++) {
+        if (!buffers[k])
+            continue;
+        const struct buffer_priv *buffer_priv = buffers[k]->priv_data;
+        data[k] = ngli_calloc(nb_vertices, buffer_priv->data_stride);
+        if (!data[k])
+            return NGL_ERROR_MEMORY;
+    }
+    return 0;
+}
+
+/* Upload the merged vertex data and reference it from the pipeline */
+static int init_geometry_attributes(struct render_batch *s, const struct ngl_node **buffers,
+                                    uint8_t **data, int nb_vertices)
+{
+    for (int k = 0; k < NB_GEOMETRY_ATTRIBUTES; k++) {
+        const struct program_variable_info *info = ngli_hmap_get(s->program.attributes, geometry_attributes[k]);
+        if (!buffers[k] || !info)
+            continue;
+
+        const struct buffer_priv *buffer_priv = buffers[k]->priv_data;
+        int ret = init_static_buffer(&s->vertex_buffers[k], s->ctx, data[k], nb_vertices * buffer_priv->data_stride);
+        if (ret < 0)
+            return ret;
+
+        struct pipeline_attribute attribute = {
+            .location = info->location,
+            .format   = buffer_priv->data_format,
+            .stride   = buffer_priv->data_stride,
+            .buffer   = &s->vertex_buffers[k],
+        };
+        snprintf(attribute.name, sizeof(attribute.name), "%s", geometry_attributes[k]);
+        if (!ngli_darray_push(&s->attributes, &attribute))
+            return NGL_ERROR_MEMORY;
+    }
+    return 0;
+}
+
+/*
+ * Concatenate the geometries of the batched Render nodes into shared vertex
+ * and index buffers, and describe each Render with an indirect draw command.
+ * The base instance of the command selects the per-instance variables of the
+ * Render, which gl_DrawID would otherwise require.
+ */
+static int init_merged_geometry(struct render_batch *s, const struct ngl_node *first_geometry)
+{
+    const struct ngl_node *first_buffers[NB_GEOMETRY_ATTRIBUTES + 1];
+    get_geometry_buffers(first_geometry, first_buffers);
+
+    const struct geometry_priv *first_geometry_priv = first_geometry->priv_data;
+    const struct ngl_node *first_indices = first_buffers[NB_GEOMETRY_ATTRIBUTES];
+
+    int ret = 0;
+    uint8_t *data[NB_GEOMETRY_ATTRIBUTES] = {NULL};
+    uint8_t *indices = NULL;
+    const struct ngl_node **geometries = ngli_calloc(s->nb_children, sizeof(*geometries));
+    struct draw_elements_command *commands = ngli_calloc(s->nb_children, sizeof(*commands));
+    if (!geometries || !commands) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    /* Describe the draws, merging the geometries shared between several Render nodes */
+    int nb_vertices = 0;
+    int nb_indices = 0;
+    int indices_format = first_indices ? ((const struct buffer_priv *)first_indices->priv_data)->data_format : 0;
+    for (int i = 0; i < s->nb_children; i++) {
+        const struct ngl_node *render = get_render(s->children[i]);
+        const struct render_priv *render_priv = render->priv_data;
+        const struct ngl_node *geometry = render_priv->geometry;
+
+        struct draw_elements_command *command = &commands[i];
+        command->instance_count = 1;
+        command->base_instance = i;
+
+        int j;
+        for (j = 0; j < i; j++)
+            if (geometries[j] == geometry)
+                break;
+        geometries[i] = geometry;
+        if (j < i) {
+            command->count = commands[j].count;
+            command->first_index = commands[j].first_index;
+            command->base_vertex = commands[j].base_vertex;
+            continue;
+        }
+
+        const struct ngl_node *buffers[NB_GEOMETRY_ATTRIBUTES + 1];
+        get_geometry_buffers(geometry, buffers);
+        const struct buffer_priv *vertices = buffers[0]->priv_data;
+        const struct buffer_priv *indices_priv = buffers[NB_GEOMETRY_ATTRIBUTES] ? buffers[NB_GEOMETRY_ATTRIBUTES]->priv_data : NULL;
+
+        command->base_vertex = nb_vertices;
+        nb_vertices += vertices->count;
+        if (indices_priv) {
+            command->count = indices_priv->count;
+            command->first_index = nb_indices;
+            nb_indices += indices_priv->count;
+            if (indices_priv->data_format != indices_format)
+                indices_format = NGLI_FORMAT_R32_UINT;
+        } else {
+            command->count = vertices->count;
+        }
+    }
+
+    /* Concatenate the attribute and index data of the unique geometries */
+    const int index_size = indices_format == NGLI_FORMAT_R16_UNORM ? sizeof(uint16_t) : sizeof(uint32_t);
+    ret = alloc_geometry_data(first_buffers, data, nb_vertices);
+    if (ret < 0)
+        goto end;
+    if (first_indices) {
+        indices = ngli_calloc(nb_indices, index_size);
+        if (!indices) {
+            ret = NGL_ERROR_MEMORY;
+            goto end;
+        }
+    }
+
+    for (int i = 0; i < s->nb_children; i++) {
+        int j;
+        for (j = 0; j < i; j++)
+            if (geometries[j] == geometries[i])
+                break;
+        if (j < i)
+            continue;
+
+        const struct draw_elements_command *command = &commands[i];
+        const struct ngl_node *buffers[NB_GEOMETRY_ATTRIBUTES + 1];
+        get_geometry_buffers(geometries[i], buffers);
+        for (int k = 0; k < NB_GEOMETRY_ATTRIBUTES; k++) {
+            if (!buffers[k])
+                continue;
+            const struct buffer_priv *buffer_priv = buffers[k]->priv_data;
+            memcpy(data[k] + command->base_vertex * buffer_priv->data_stride,
+                   buffer_priv->data, buffer_priv->count * buffer_priv->data_stride);
+        }
+
+        if (!indices)
+            continue;
+        const struct buffer_priv *indices_priv = buffers[NB_GEOMETRY_ATTRIBUTES]->priv_data;
+        if (indices_priv->data_format == indices_format) {
+            memcpy(indices + command->first_index * index_size, indices_priv->data, indices_priv->data_size);
+        } else {
+            const uint16_t *src = (const uint16_t *)indices_priv->data;
+            uint32_t *dst = (uint32_t *)indices + command->first_index;
+            for (int k = 0; k < indices_priv->count; k++)
+                dst[k] = src[k];
+        }
+    }
+
+    ret = init_geometry_attributes(s, first_buffers, data, nb_vertices);
+    if (ret < 0)
+        goto end;
+
+    if (indices) {
+        ret = init_static_buffer(&s->indices_buffer, s->ctx, indices, nb_indices * index_size);
+        if (ret < 0)
+            goto end;
+        ret = init_static_buffer(&s->draw_commands, s->ctx, commands, s->nb_children * sizeof(*commands));
+    } else {
+        struct draw_arrays_command *arrays_commands = (struct draw_arrays_command *)commands;
+        for (int i = 0; i < s->nb_children; i++) {
+            const struct draw_elements_command command = commands[i];
+            arrays_commands[i] = (struct draw_arrays_command){
+                .count          = command.count,
+                .instance_count = command.instance_count,
+                .first          = command.base_vertex,
+                .base_instance  = command.base_instance,
+            };
+        }
+        ret = init_static_buffer(&s->draw_commands, s->ctx, arrays_commands, s->nb_children * sizeof(*arrays_commands));
+    }
+    if (ret < 0)
+        goto end;
+
+    s->graphics = (struct pipeline_graphics){
+        .topology         = first_geometry_priv->topology,
+        .indices_format   = indices_format,
+        .indices          = indices ? &s->indices_buffer : NULL,
+        .draw_commands    = &s->draw_commands,
+        .nb_draw_commands = s->nb_children,
+    };
+
+    LOG(DEBUG, "merge %d vertices and %d indices for a multi-draw of %d Render nodes",
+        nb_vertices, nb_indices, s->nb_children);
+
+end:
+    for (int k = 0; k < NB_GEOMETRY_ATTRIBUTES; k++)
+        ngli_free(data[k]);
+    ngli_free(indices);
+    ngli_free(commands);
+    ngli_free(geometries);
+    return ret;
+}
+
+static int get_list_count(int topology, int count)
+{
+    switch (topology) {
+    case NGLI_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+        return count < 2 ? 0 : (count - 1) * 2;
+    case NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+    case NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+        return count < 3 ? 0 : (count - 2) * 3;
+    default:
+        return count;
+    }
+}
+
+static uint32_t get_index(const struct buffer_priv *indices, int i)
+{
+    if (!indices)
+        return i;
+    if (indices->data_format == NGLI_FORMAT_R16_UNORM)
+        return ((const uint16_t *)indices->data)[i];
+    return ((const uint32_t *)indices->data)[i];
+}
+
+/*
+ * Write the primitives of the geometry as a list of independent primitives,
+ * keeping the winding of the triangle strips.
+ */
+static uint32_t *write_list_indices(uint32_t *dst, int topology, const struct buffer_priv *indices,
+                                    int count, uint32_t base)
+{
+    switch (topology) {
+    case NGLI_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+        for (int i = 0; i < count - 1; i++) {
+            *dst++ = base + get_index(indices, i);
+            *dst++ = base + get_index(indices, i + 1);
+        }
+        break;
+    case NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP:
+        for (int i = 0; i < count - 2; i++) {
+            *dst++ = base + get_index(indices, i + (i & 1));
+            *dst++ = base + get_index(indices, i + 1 - (i & 1));
+            *dst++ = base + get_index(indices, i + 2);
+        }
+        break;
+    case NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN:
+        for (int i = 1; i < count - 1; i++) {
+            *dst++ = base + get_index(indices, 0);
+            *dst++ = base + get_index(indices, i);
+            *dst++ = base + get_index(indices, i + 1);
+        }
+        break;
+    default:
+        for (int i = 0; i < count; i++)
+            *dst++ = base + get_index(indices, i);
+        break;
+    }
+    return dst;
+}
+
+/*
+ * Pack the vertices of every batched Render into shared vertex buffers, with
+ * their primitives converted to a single list topology so that the batch is
+ * emitted with one draw call in the order of the Render nodes. Unlike the
+ * instanced paths, the per-Render variables are replicated on each vertex.
+ */
+static int init_packed_geometry(struct render_batch *s, const struct ngl_node *first_geometry)
+{
+    const struct ngl_node *first_buffers[NB_GEOMETRY_ATTRIBUTES + 1];
+    get_geometry_buffers(first_geometry, first_buffers);
+
+    const struct geometry_priv *first_geometry_priv = first_geometry->priv_data;
+    const int topology = get_list_topology(first_geometry_priv->topology);
+
+    s->vertex_counts = ngli_calloc(s->nb_children, sizeof(*s->vertex_counts));
+    if (!s->vertex_counts)
+        return NGL_ERROR_MEMORY;
+
+    int nb_indices = 0;
+    for (int i = 0; i < s->nb_children; i++) {
+        const struct ngl_node *render = get_render(s->children[i]);
+        const struct render_priv *render_priv = render->priv_data;
+        const struct geometry_priv *geometry_priv = render_priv->geometry->priv_data;
+        const struct buffer_priv *vertices = geometry_priv->vertices_buffer->priv_data;
+        const struct buffer_priv *indices = geometry_priv->indices_buffer ? geometry_priv->indices_buffer->priv_data : NULL;
+        const int count = indices ? indices->count : vertices->count;
+
+        s->vertex_counts[i] = vertices->count;
+        s->nb_vertices += vertices->count;
+        nb_indices += get_list_count(geometry_priv->topology, count);
+    }
+
+    uint8_t *data[NB_GEOMETRY_ATTRIBUTES] = {NULL};
+    uint32_t *indices = ngli_calloc(nb_indices, sizeof(*indices));
+    int ret = alloc_geometry_data(first_buffers, data, s->nb_vertices);
+    if (ret < 0 || !indices) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    int base_vertex = 0;
+    uint32_t *dst = indices;
+    for (int i = 0; i < s->nb_children; i++) {
+        const struct ngl_node *render = get_render(s->children[i]);
+        const struct render_priv *render_priv = render->priv_data;
+        const struct geometry_priv *geometry_priv = render_priv->geometry->priv_data;
+
+        const struct ngl_node *buffers[NB_GEOMETRY_ATTRIBUTES + 1];
+        get_geometry_buffers(render_priv->geometry, buffers);
+        for (int k = 0; k < NB_GEOMETRY_ATTRIBUTES; k++) {
+            if (!buffers[k])
+                continue;
+            const struct buffer_priv *buffer_priv = buffers[k]->priv_data;
+            memcpy(data[k] + base_vertex * buffer_priv->data_stride,
+                   buffer_priv->data, buffer_priv->count * buffer_priv->data_stride);
+        }
+
+        const struct buffer_priv *vertices = buffers[0]->priv_data;
+        const struct buffer_priv *indices_priv = buffers[NB_GEOMETRY_ATTRIBUTES] ? buffers[NB_GEOMETRY_ATTRIBUTES]->priv_data : NULL;
+        const int count = indices_priv ? indices_priv->count : vertices->count;
+        dst = write_list_indices(dst, geometry_priv->topology, indices_priv, count, base_vertex);
+        base_vertex += vertices->count;
+    }
+
+    ret = init_geometry_attributes(s, first_buffers, data, s->nb_vertices);
+    if (ret < 0)
+        goto end;
+
+    /* Narrow the indices when possible, as done for optimized geometries */
+    int indices_format = NGLI_FORMAT_R32_UINT;
+    int index_size = sizeof(uint32_t);
+    if (s->nb_vertices <= UINT16_MAX + 1) {
+        uint16_t *indices_u16 = (uint16_t *)indices;
+        for (int i = 0; i < nb_indices; i++)
+            indices_u16[i] = indices[i];
+        indices_format = NGLI_FORMAT_R16_UNORM;
+        index_size = sizeof(uint16_t);
+    }
+
+    ret = init_static_buffer(&s->indices_buffer, s->ctx, indices, nb_indices * index_size);
+    if (ret < 0)
+        goto end;
+
+    s->graphics = (struct pipeline_graphics){
+        .topology       = topology,
+        .nb_indices     = nb_indices,
+        .indices_format = indices_format,
+        .indices        = &s->indices_buffer,
+    };
+
+    LOG(DEBUG, "pack %d vertices and %d indices for a single draw of %d Render nodes",
+        s->nb_vertices, nb_indices, s->nb_children);
+
+end:
+    for (int k = 0; k < NB_GEOMETRY_ATTRIBUTES; k++)
+        ngli_free(data[k]);
+    ngli_free(indices);
+    return ret;
+}
+
+/*
+ * Render nodes sharing the same geometry are drawn with instances. The other
+ * ones use an indirect multi-draw when supported and their primitives are
+ * identical, and are packed into a single draw otherwise.
+ */
+static int get_mode(const struct render_batch *s)
+{
+    const struct ngl_node *first = get_render(s->children[0]);
+    const struct render_priv *first_priv = first->priv_data;
+    const struct geometry_priv *first_geometry = first_priv->geometry->priv_data;
+
+    int mode = NGLI_BATCH_MODE_INSTANCES;
+    for (int i = 1; i < s->nb_children; i++) {
+        const struct ngl_node *render = get_render(s->children[i]);
+        const struct render_priv *render_priv = render->priv_data;
+        if (render_priv->geometry == first_priv->geometry)
+            continue;
+        const struct geometry_priv *geometry = render_priv->geometry->priv_data;
+        if (geometry->topology != first_geometry->topology ||
+            !geometry->indices_buffer != !first_geometry->indices_buffer)
+            return NGLI_BATCH_MODE_PACKED;
+        mode = NGLI_BATCH_MODE_MULTI_DRAW;
+    }
+
+    struct glcontext *gl = s->ctx->glcontext;
+    if (mode == NGLI_BATCH_MODE_MULTI_DRAW && !gl->multi_draw_indirect)
+        return NGLI_BATCH_MODE_PACKED;
+    return mode;
+}
+
+int ngli_batch_init(struct render_batch *s, struct ngl_ctx *ctx, struct ngl_node **children, int nb_children)
+{
+    s->ctx = ctx;
+    s->children = children;
+    s->nb_children = nb_children;
+
+    ngli_darray_init(&s->variables, sizeof(struct batch_variable), 0);
+    ngli_darray_init(&s->attributes, sizeof(struct pipeline_attribute), 0);
+
+    struct glcontext *gl = ctx->glcontext;
+    if (!(gl->features & NGLI_FEATURE_INSTANCED_ARRAY) ||
+        !(gl->features & NGLI_FEATURE_DRAW_INSTANCED)) {
+        LOG(WARNING, "instanced draws are not supported, Render nodes will not be batched");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    const struct ngl_node *first = get_render(children[0]);
+    const struct render_priv *render = first->priv_data;
+
+    s->uniforms = ngli_hmap_create();
+    if (!s->uniforms)
+        return NGL_ERROR_MEMORY;
+
+    int ret;
+    if ((ret = add_variable(s, "ngl_modelview_matrix", VARIABLE_MODELVIEW_MATRIX, NGLI_TYPE_MAT4)) < 0 ||
+        (ret = add_variable(s, "ngl_normal_matrix", VARIABLE_NORMAL_MATRIX, NGLI_TYPE_MAT3)) < 0)
+        return ret;
+
+    if (render->uniforms) {
+        const struct hmap_entry *entry = NULL;
+        while ((entry = ngli_hmap_next(render->uniforms, entry))) {
+            int shared = 1;
+            for (int i = 1; i < nb_children && shared; i++) {
+                const struct ngl_node *node = get_render(children[i]);
+                const struct render_priv *render_priv = node->priv_data;
+                shared = ngli_hmap_get(render_priv->uniforms, entry->key) == entry->data;
+            }
+
+            if (shared) {
+                ret = ngli_hmap_set(s->uniforms, entry->key, entry->data);
+            } else {
+                const struct ngl_node *uniform = entry->data;
+                const struct variable_priv *variable = uniform->priv_data;
+                ret = add_variable(s, entry->key, VARIABLE_UNIFORM, variable->data_type);
+            }
+            if (ret < 0)
+                return ret;
+        }
+    }
+
+    ret = init_program(s, render->program->priv_data);
+    if (ret < 0)
+        return ret;
+
+    s->mode = get_mode(s);
+    if (s->mode == NGLI_BATCH_MODE_MULTI_DRAW)
+        ret = init_merged_geometry(s, render->geometry);
+    else if (s->mode == NGLI_BATCH_MODE_PACKED)
+        ret = init_packed_geometry(s, render->geometry);
+    if (ret < 0)
+        return ret;
+
+    ret = init_instance_data(s);
+    if (ret < 0)
+        return ret;
+
+    struct pass_params params = {
+        .label               = first->label,
+        .geometry            = render->geometry,
+        .program             = render->program,
+        .textures            = render->textures,
+        .uniforms            = s->uniforms,
+        .blocks              = render->blocks,
+        .attributes          = render->attributes,
+        .batch_program       = &s->program,
+        .batch_attributes    = ngli_darray_data(&s->attributes),
+        .nb_batch_attributes = ngli_darray_count(&s->attributes),
+        .batch_graphics      = s->mode != NGLI_BATCH_MODE_INSTANCES ? &s->graphics : NULL,
+        .nb_instances        = s->mode == NGLI_BATCH_MODE_INSTANCES ? nb_children : 0,
+    };
+    ret = ngli_pass_init(&s->pass, ctx, &params);
+    if (ret < 0)
+        return ret;
+
+    static const char * const mode_names[] = {
+        [NGLI_BATCH_MODE_INSTANCES]  = "instanced draw",
+        [NGLI_BATCH_MODE_MULTI_DRAW] = "multi-draw",
+        [NGLI_BATCH_MODE_PACKED]     = "packed draw",
+    };
+    LOG(DEBUG, "batch %d Render nodes with %d variables into a single %s",
+        nb_children, ngli_darray_count(&s->variables), mode_names[s->mode]);
+
+    return 0;
+}
+
+int ngli_batch_prepare(struct render_batch *s)
+{
+    return ngli_pass_prepare(&s->pass);
+}
+
+int ngli_batch_update(struct render_batch *s, double t)
+{
+    return ngli_pass_update(&s->pass, t);
+}
+
+int ngli_batch_exec(struct render_batch *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    const struct batch_variable *variables = ngli_darray_data(&s->variables);
+    const int nb_variables = ngli_darray_count(&s->variables);
+    const float *parent_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
+
+    for (int i = 0; i < s->nb_children; i++) {
+        NGLI_ALIGNED_MAT(modelview_matrix);
+        memcpy(modelview_matrix, parent_matrix, sizeof(modelview_matrix));
+
+        const struct ngl_node *node = s->children[i];
+        while (is_transform(node)) {
+            const struct transform_priv *transform = node->priv_data;
+            NGLI_ALIGNED_MAT(matrix);
+            ngli_mat4_mul(matrix, modelview_matrix, transform->matrix);
+            memcpy(modelview_matrix, matrix, sizeof(matrix));
+            node = transform->child;
+        }
+
+        uint8_t *dst = s->instance_data + i * s->instance_stride;
+        struct ngl_node **uniforms = &s->instance_uniforms[i * nb_variables];
+        for (int j = 0; j < nb_variables; j++) {
+            const struct batch_variable *variable = &variables[j];
+            if (variable->kind == VARIABLE_MODELVIEW_MATRIX) {
+                memcpy(dst + variable->offset, modelview_matrix, variable->size);
+            } else if (variable->kind == VARIABLE_NORMAL_MATRIX) {
+                float normal_matrix[3*3];
+                ngli_mat3_from_mat4(normal_matrix, modelview_matrix);
+                ngli_mat3_inverse(normal_matrix, normal_matrix);
+                ngli_mat3_transpose(normal_matrix, normal_matrix);
+                memcpy(dst + variable->offset, normal_matrix, variable->size);
+            } else {
+                const struct variable_priv *uniform = uniforms[j]->priv_data;
+                memcpy(dst + variable->offset, uniform->data, variable->size);
+            }
+        }
+    }
+
+    int ret;
+    if (s->mode == NGLI_BATCH_MODE_PACKED) {
+        uint8_t *dst = s->vertex_data;
+        for (int i = 0; i < s->nb_children; i++) {
+            const uint8_t *src = s->instance_data + i * s->instance_stride;
+            for (int j = 0; j < s->vertex_counts[i]; j++) {
+                memcpy(dst, src, s->instance_stride);
+                dst += s->instance_stride;
+            }
+        }
+        ret = ngli_buffer_upload(&s->instance_buffer, s->vertex_data,
+                                 s->nb_vertices * s->instance_stride, 0);
+    } else {
+        ret = ngli_buffer_upload(&s->instance_buffer, s->instance_data,
+                                 s->nb_children * s->instance_stride, 0);
+    }
+    if (ret < 0)
+        return ret;
+
+    return ngli_pass_exec(&s->pass);
+}
+
+void ngli_batch_reset(struct render_batch *s)
+{
+    ngli_pass_uninit(&s->pass);
+    for (int i = 0; i < NGLI_ARRAY_NB(s->vertex_buffers); i++)
+        ngli_buffer_reset(&s->vertex_buffers[i]);
+    ngli_buffer_reset(&s->indices_buffer);
+    ngli_buffer_reset(&s->draw_commands);
+    ngli_buffer_reset(&s->instance_buffer);
+    ngli_pgcache_release_program(&s->program);
+    ngli_darray_reset(&s->attributes);
+    ngli_free(s->vertex_counts);
+    ngli_free(s->vertex_data);
+    ngli_free(s->instance_uniforms);
+    ngli_free(s->instance_data);
+    ngli_hmap_freep(&s->uniforms);
+    ngli_darray_reset(&s->variables);
+    memset(s, 0, sizeof(*s));
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdint.h>
+
+#include "buffer.h"
+#include "darray.h"
+#include "hmap.h"
+#include "pass.h"
+#include "program.h"
+
+struct ngl_ctx;
+struct ngl_node;
+
+enum {
+    NGLI_BATCH_MODE_INSTANCES,
+    NGLI_BATCH_MODE_MULTI_DRAW,
+    NGLI_BATCH_MODE_PACKED,
+};
+
+struct render_batch {
+    struct ngl_ctx *ctx;
+    struct ngl_node **children;
+    int nb_children;
+
+    struct darray variables;
+    struct hmap *uniforms;
+    int instance_stride;
+    uint8_t *instance_data;
+    struct ngl_node **instance_uniforms;
+    struct buffer instance_buffer;
+    struct darray attributes;
+    struct program program;
+
+    /* Differing geometries, merged for a multi-draw or packed for a single draw */
+    int mode;
+    int nb_vertices;
+    int *vertex_counts;
+    uint8_t *vertex_data;
+    struct buffer vertex_buffers[3];
+    struct buffer indices_buffer;
+    struct buffer draw_commands;
+    struct pipeline_graphics graphics;
+
+    struct pass pass;
+};
+
+int ngli_batch_get_run_length(struct ngl_node **children, int nb_children);
+int ngli_batch_init(struct render_batch *s, struct ngl_ctx *ctx, struct ngl_node **children, int nb_children);
+int ngli_batch_prepare(struct render_batch *s);
+int ngli_batch_update(struct render_batch *s, double t);
+int ngli_batch_exec(struct render_batch *s);
+void ngli_batch_reset(struct render_batch *s);
+
+#endif
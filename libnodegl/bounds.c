@@ -0,0 +1,77 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <float.h>
+#include <stdint.h>
+
+#include "bounds.h"
+#include "math_utils.h"
+#include "utils.h"
+
+void ngli_bounds_from_points(struct bounds *s, const float *points, int count, int stride)
+{
+    for (int i = 0; i < 3; i++) {
+        s->min[i] =  FLT_MAX;
+        s->max[i] = -FLT_MAX;
+    }
+
+    const uint8_t *p = (const uint8_t *)points;
+    for (int i = 0; i < count; i++) {
+        const float *point = (const float *)(p + i * stride);
+        for (int j = 0; j < 3; j++) {
+            s->min[j] = NGLI_MIN(s->min[j], point[j]);
+            s->max[j] = NGLI_MAX(s->max[j], point[j]);
+        }
+    }
+}
+
+/*
+ * The box is projected into clip space and considered invisible only if all
+ * its corners lie outside the same frustum plane (-w <= x,y,z <= w). This is
+ * conservative: a box crossing the frustum corner diagonally may still be
+ * reported visible.
+ */
+int ngli_bounds_is_visible(const struct bounds *s, const float *mvp)
+{
+    if (s->min[0] > s->max[0])
+        return 0;
+
+    int outside[6] = {0};
+    for (int i = 0; i < 8; i++) {
+        NGLI_ALIGNED_VEC(corner) = {
+            i & 1 ? s->max[0] : s->min[0],
+            i & 2 ? s->max[1] : s->min[1],
+            i & 4 ? s->max[2] : s->min[2],
+            1.0f,
+        };
+        NGLI_ALIGNED_VEC(clip);
+        ngli_mat4_mul_vec4(clip, mvp, corner);
+        for (int j = 0; j < 3; j++) {
+            outside[j * 2    ] += clip[j] < -clip[3];
+            outside[j * 2 + 1] += clip[j] >  clip[3];
+        }
+    }
+
+    for (int i = 0; i < 6; i++)
+        if (outside[i] == 8)
+            return 0;
+    return 1;
+}
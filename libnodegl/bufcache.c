@@ -0,0 +1,157 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bufcache.h"
+#include "memory.h"
+#include "nodes.h"
+#include "utils.h"
+
+struct cached_buffer {
+    struct buffer buffer; /* must be first */
+    char key[64];
+    uint8_t *data;
+    int size;
+    int format;
+    int refcount;
+};
+
+static void free_cached_buffer(struct cached_buffer *cached_buffer)
+{
+    ngli_buffer_reset(&cached_buffer->buffer);
+    ngli_free(cached_buffer->data);
+    ngli_free(cached_buffer);
+}
+
+static void reset_cached_buffer(void *user_arg, void *data)
+{
+    free_cached_buffer(data);
+}
+
+int ngli_bufcache_init(struct bufcache *s, struct ngl_ctx *ctx)
+{
+    s->ctx = ctx;
+    s->buffers = ngli_hmap_create();
+    if (!s->buffers)
+        return NGL_ERROR_MEMORY;
+    ngli_hmap_set_free(s->buffers, reset_cached_buffer, s);
+    return 0;
+}
+
+static struct cached_buffer *create_cached_buffer(struct bufcache *s, const char *key,
+                                                  const void *data, int size, int format)
+{
+    struct cached_buffer *cached_buffer = ngli_calloc(1, sizeof(*cached_buffer));
+    if (!cached_buffer)
+        return NULL;
+
+    snprintf(cached_buffer->key, sizeof(cached_buffer->key), "%s", key);
+    cached_buffer->size = size;
+    cached_buffer->format = format;
+    cached_buffer->refcount = 1;
+
+    /* The data is kept around to rule out hash collisions */
+    cached_buffer->data = ngli_malloc(size);
+    if (!cached_buffer->data)
+        goto fail;
+    memcpy(cached_buffer->data, data, size);
+
+    int ret = ngli_buffer_init(&cached_buffer->buffer, s->ctx, size, NGLI_BUFFER_USAGE_STATIC);
+    if (ret < 0)
+        goto fail;
+
+    ret = ngli_buffer_upload(&cached_buffer->buffer, data, size, 0);
+    if (ret < 0)
+        goto fail;
+
+    return cached_buffer;
+
+fail:
+    free_cached_buffer(cached_buffer);
+    return NULL;
+}
+
+/*
+ * Returns a static GPU buffer holding the specified data: buffers with the
+ * same content and format are shared.
+ */
+int ngli_bufcache_get_buffer(struct bufcache *s, struct buffer **dst, const void *data, int size, int format)
+{
+    char key[64];
+    snprintf(key, sizeof(key), "%016" PRIx64 ":%d:%d", ngli_fnv1a64(NGLI_FNV1A64_INIT, data, size), size, format);
+
+    struct cached_buffer *cached_buffer = ngli_hmap_get(s->buffers, key);
+    if (cached_buffer && !memcmp(cached_buffer->data, data, size)) {
+        cached_buffer->refcount++;
+        *dst = &cached_buffer->buffer;
+
+        struct ngl_stats *stats = &s->ctx->stats;
+        stats->buffer_duplicates++;
+        stats->buffer_bytes_saved += size;
+        return 0;
+    }
+
+    struct cached_buffer *new_buffer = create_cached_buffer(s, key, data, size, format);
+    if (!new_buffer)
+        return NGL_ERROR_MEMORY;
+
+    /* In the unlikely event of a hash collision, the buffer is not shared */
+    if (cached_buffer) {
+        new_buffer->key[0] = 0;
+    } else {
+        int ret = ngli_hmap_set(s->buffers, key, new_buffer);
+        if (ret < 0) {
+            free_cached_buffer(new_buffer);
+            return ret;
+        }
+    }
+
+    *dst = &new_buffer->buffer;
+    return 0;
+}
+
+void ngli_bufcache_release_buffer(struct bufcache *s, struct buffer **bufferp)
+{
+    struct cached_buffer *cached_buffer = (struct cached_buffer *)*bufferp;
+    if (!cached_buffer)
+        return;
+    *bufferp = NULL;
+
+    ngli_assert(cached_buffer->refcount > 0);
+    if (--cached_buffer->refcount)
+        return;
+
+    if (cached_buffer->key[0])
+        ngli_hmap_set(s->buffers, cached_buffer->key, NULL);
+    else
+        free_cached_buffer(cached_buffer);
+}
+
+void ngli_bufcache_reset(struct bufcache *s)
+{
+    if (!s->ctx)
+        return;
+    ngli_hmap_freep(&s->buffers);
+    memset(s, 0, sizeof(*s));
+}
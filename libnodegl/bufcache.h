@@ -0,0 +1,40 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef BUFCACHE_H
+#define BUFCACHE_H
+
+#include "buffer.h"
+#include "hmap.h"
+
+struct ngl_ctx;
+
+struct bufcache {
+    struct ngl_ctx *ctx;
+    struct hmap *buffers;
+};
+
+int ngli_bufcache_init(struct bufcache *s, struct ngl_ctx *ctx);
+int ngli_bufcache_get_buffer(struct bufcache *s, struct buffer **dst, const void *data, int size, int format);
+void ngli_bufcache_release_buffer(struct bufcache *s, struct buffer **bufferp);
+void ngli_bufcache_reset(struct bufcache *s);
+
+#endif
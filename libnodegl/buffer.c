@@ -24,7 +24,9 @@
 #include "buffer.h"
 #include "glcontext.h"
 #include "glincludes.h"
+#include "log.h"
 #include "nodes.h"
+#include "utils.h"
 
 static const GLenum gl_usage_map[NGLI_BUFFER_USAGE_NB] = {
     [NGLI_BUFFER_USAGE_STATIC]  = GL_STATIC_DRAW,
@@ -36,6 +38,28 @@ static GLenum get_gl_usage(int usage)
     return gl_usage_map[usage];
 }
 
+static int buffer_init_ring(struct buffer *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    /* Segment offsets must be suitable for uniform and storage buffer bindings */
+    const int alignment = NGLI_MAX(NGLI_MAX(gl->uniform_buffer_offset_alignment,
+                                            gl->shader_storage_buffer_offset_alignment), 4);
+    s->segment_size = NGLI_ALIGN(s->size, alignment);
+
+    const int ring_size = s->segment_size * NGLI_BUFFER_NB_SEGMENTS;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    ngli_glBufferStorage(gl, GL_ARRAY_BUFFER, ring_size, NULL, flags);
+    s->mapped_data = ngli_glMapBufferRange(gl, GL_ARRAY_BUFFER, 0, ring_size, flags);
+    if (!s->mapped_data) {
+        LOG(ERROR, "could not map buffer storage");
+        return NGL_ERROR_EXTERNAL;
+    }
+
+    return 0;
+}
+
 int ngli_buffer_init(struct buffer *s, struct ngl_ctx *ctx, int size, int usage)
 {
     s->ctx = ctx;
@@ -43,17 +67,87 @@ int ngli_buffer_init(struct buffer *s, struct ngl_ctx *ctx, int size, int usage)
     s->usage = usage;
     struct glcontext *gl = ctx->glcontext;
     ngli_glGenBuffers(gl, 1, &s->id);
-    ngli_glBindBuffer(gl, GL_ARRAY_BUFFER, s->id);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_ARRAY_BUFFER, s->id);
+
+    if (usage == NGLI_BUFFER_USAGE_DYNAMIC &&
+        (gl->features & NGLI_FEATURE_BUFFER_STORAGE) &&
+        (gl->features & NGLI_FEATURE_SYNC))
+        return buffer_init_ring(s);
+
     ngli_glBufferData(gl, GL_ARRAY_BUFFER, size, NULL, get_gl_usage(usage));
     return 0;
 }
 
-int ngli_buffer_upload(struct buffer *s, const void *data, int size)
+static void wait_fence(struct glcontext *gl, GLsync *fence)
+{
+    if (!*fence)
+        return;
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    for (;;) {
+        const GLenum ret = ngli_glClientWaitSync(gl, *fence, flags, 1000000000);
+        if (ret != GL_TIMEOUT_EXPIRED)
+            break;
+        flags = 0;
+    }
+    ngli_glDeleteSync(gl, *fence);
+    *fence = NULL;
+}
+
+static int buffer_upload_ring(struct buffer *s, const void *data, int size, int offset)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    if (offset != 0 || size != s->size) {
+        /*
+         * The rest of the data only lives in the current segment, so partial
+         * updates have to be written in place once the GPU is done with it.
+         */
+        s->fences[s->segment] = ngli_glFenceSync(gl, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        wait_fence(gl, &s->fences[s->segment]);
+        memcpy(s->mapped_data + s->offset + offset, data, size);
+        return 0;
+    }
+
+    memcpy(ngli_buffer_next_segment(s), data, size);
+    return 0;
+}
+
+uint8_t *ngli_buffer_next_segment(struct buffer *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    ngli_assert(s->mapped_data);
+
+    /*
+     * All the commands reading from the current segment have been submitted
+     * at this point: fence them and move on to the next segment, waiting for
+     * the GPU to release it if needed.
+     */
+    s->fences[s->segment] = ngli_glFenceSync(gl, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    s->segment = (s->segment + 1) % NGLI_BUFFER_NB_SEGMENTS;
+    s->offset = s->segment * s->segment_size;
+    wait_fence(gl, &s->fences[s->segment]);
+    return s->mapped_data + s->offset;
+}
+
+int ngli_buffer_upload(struct buffer *s, const void *data, int size, int offset)
 {
+    ngli_assert(offset >= 0 && offset + size <= s->size);
+
+    if (s->mapped_data)
+        return buffer_upload_ring(s, data, size, offset);
+
     struct ngl_ctx *ctx = s->ctx;
     struct glcontext *gl = ctx->glcontext;
-    ngli_glBindBuffer(gl, GL_ARRAY_BUFFER, s->id);
-    ngli_glBufferSubData(gl, GL_ARRAY_BUFFER, 0, size, data);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_ARRAY_BUFFER, s->id);
+    if (s->usage == NGLI_BUFFER_USAGE_DYNAMIC && offset == 0 && size == s->size) {
+        /* Orphan the previous storage instead of waiting for the GPU to release it */
+        ngli_glBufferData(gl, GL_ARRAY_BUFFER, size, data, get_gl_usage(s->usage));
+        return 0;
+    }
+    ngli_glBufferSubData(gl, GL_ARRAY_BUFFER, offset, size, data);
     return 0;
 }
 
@@ -63,6 +157,14 @@ void ngli_buffer_reset(struct buffer *s)
     if (!ctx)
         return;
     struct glcontext *gl = ctx->glcontext;
+    for (int i = 0; i < NGLI_BUFFER_NB_SEGMENTS; i++)
+        if (s->fences[i])
+            ngli_glDeleteSync(gl, s->fences[i]);
+    if (s->mapped_data) {
+        ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_ARRAY_BUFFER, s->id);
+        ngli_glUnmapBuffer(gl, GL_ARRAY_BUFFER);
+    }
     ngli_glDeleteBuffers(gl, 1, &s->id);
+    ngli_glstate_invalidate_buffer(&ctx->glstate, s->id);
     memset(s, 0, sizeof(*s));
 }
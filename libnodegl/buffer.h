@@ -22,10 +22,21 @@
 #ifndef BUFFER_H
 #define BUFFER_H
 
+#include <stdint.h>
+
 #include "glincludes.h"
 
 struct ngl_ctx;
 
+/*
+ * Dynamic buffers are backed by a ring of NGLI_BUFFER_NB_SEGMENTS segments
+ * persistently mapped in client memory (if the context supports buffer
+ * storage): each upload is written into the next segment while the GPU may
+ * still be reading the previous ones. Users must bind the buffer at the
+ * offset of the current segment (see the offset field).
+ */
+#define NGLI_BUFFER_NB_SEGMENTS 3
+
 enum {
     NGLI_BUFFER_USAGE_STATIC,
     NGLI_BUFFER_USAGE_DYNAMIC,
@@ -37,10 +48,23 @@ struct buffer {
     int size;
     int usage;
     GLuint id;
+
+    int offset;
+    int segment;
+    int segment_size;
+    uint8_t *mapped_data;
+    GLsync fences[NGLI_BUFFER_NB_SEGMENTS];
 };
 
 int ngli_buffer_init(struct buffer *s, struct ngl_ctx *ctx, int size, int usage);
-int ngli_buffer_upload(struct buffer *s, const void *data, int size);
+int ngli_buffer_upload(struct buffer *s, const void *data, int size, int offset);
+
+/*
+ * Move a ring buffer on to its next segment (once the GPU is done with it)
+ * and return its mapped data, left as written NGLI_BUFFER_NB_SEGMENTS
+ * uploads ago so the caller may only patch what changed since then.
+ */
+uint8_t *ngli_buffer_next_segment(struct buffer *s);
 void ngli_buffer_reset(struct buffer *s);
 
 #endif
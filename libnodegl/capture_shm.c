@@ -0,0 +1,190 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#define _GNU_SOURCE // syscall()
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "capture_shm.h"
+#include "log.h"
+#include "memory.h"
+#include "utils.h"
+
+/*
+ * The counters are shared with another process, so the futex operations
+ * cannot use FUTEX_PRIVATE_FLAG.
+ */
+static int futex_wait(uint32_t *addr, uint32_t val, const struct timespec *timeout)
+{
+    return syscall(SYS_futex, addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+static void futex_wake(uint32_t *addr)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static void notify_update(struct ngl_capture_shm_header *header)
+{
+    __atomic_add_fetch(&header->update_count, 1, __ATOMIC_RELEASE);
+    futex_wake(&header->update_count);
+}
+
+int ngli_capture_shm_init(struct capture_shm *s, const char *name, int nb_slots, int frame_size)
+{
+    if (nb_slots <= 0) {
+        LOG(ERROR, "invalid number of shared memory capture slots %d", nb_slots);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    /* Page aligned slots allow the consumer to map or hand over frames individually */
+    const long page_size = sysconf(_SC_PAGESIZE);
+    const size_t align = page_size > 0 ? page_size : 4096;
+    const size_t header_size = NGLI_ALIGN(sizeof(struct ngl_capture_shm_header), align);
+    const size_t slot_size = NGLI_ALIGN(sizeof(struct ngl_capture_shm_slot) + frame_size, align);
+    if (slot_size > UINT32_MAX || (SIZE_MAX - header_size) / slot_size < (size_t)nb_slots) {
+        LOG(ERROR, "shared memory capture of %d slots of %d bytes is too large", nb_slots, frame_size);
+        return NGL_ERROR_LIMIT_EXCEEDED;
+    }
+
+    s->name = ngli_strdup(name);
+    if (!s->name)
+        return NGL_ERROR_MEMORY;
+
+    s->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (s->fd < 0) {
+        LOG(ERROR, "could not create shared memory object %s: %s", name, strerror(errno));
+        ngli_free(s->name);
+        s->name = NULL;
+        return NGL_ERROR_EXTERNAL;
+    }
+
+    s->size = header_size + nb_slots * slot_size;
+    if (ftruncate(s->fd, s->size) < 0) {
+        LOG(ERROR, "could not resize shared memory object %s to %zu bytes: %s",
+            name, s->size, strerror(errno));
+        return NGL_ERROR_EXTERNAL;
+    }
+
+    void *data = mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+    if (data == MAP_FAILED) {
+        LOG(ERROR, "could not map shared memory object %s: %s", name, strerror(errno));
+        return NGL_ERROR_EXTERNAL;
+    }
+    s->data = data;
+    s->frame_size = frame_size;
+
+    struct ngl_capture_shm_header *header = data;
+    header->version      = NGL_CAPTURE_SHM_VERSION;
+    header->nb_slots     = nb_slots;
+    header->slot_size    = slot_size;
+    header->slots_offset = header_size;
+    s->header = header;
+
+    /* Publish the magic last so a consumer polling for it sees a complete header */
+    __atomic_store_n(&header->magic, NGL_CAPTURE_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    LOG(DEBUG, "shared memory capture %s: %d slots of %zu bytes", name, nb_slots, slot_size);
+
+    return 0;
+}
+
+/*
+ * Wait for the consumer to release a slot. While the capture is being closed,
+ * the consumer only gets one timeout period: a consumer which died or never
+ * attached must not block the teardown of the context forever.
+ */
+static int wait_free_slot(struct capture_shm *s, uint32_t write_count)
+{
+    struct ngl_capture_shm_header *header = s->header;
+    const struct timespec timeout = {.tv_sec = 1};
+    int warned = 0;
+
+    for (;;) {
+        const uint32_t read_count = __atomic_load_n(&header->read_count, __ATOMIC_ACQUIRE);
+        if (write_count - read_count < header->nb_slots)
+            return 0;
+        if (futex_wait(&header->read_count, read_count, &timeout) < 0 && errno == ETIMEDOUT) {
+            if (s->closing)
+                return NGL_ERROR_EXTERNAL;
+            if (!warned) {
+                LOG(WARNING, "shared memory capture %s is full, waiting for the consumer", s->name);
+                warned = 1;
+            }
+        }
+    }
+}
+
+void ngli_capture_shm_write(void *user_data, const struct ngl_capture_frame *frame)
+{
+    struct capture_shm *s = user_data;
+    struct ngl_capture_shm_header *header = s->header;
+
+    if (s->dropping)
+        return;
+
+    /* Only the context writes this counter */
+    const uint32_t write_count = header->write_count;
+    if (wait_free_slot(s, write_count) < 0) {
+        LOG(WARNING, "shared memory capture %s: no slot released by the consumer, "
+            "dropping the remaining frames", s->name);
+        s->dropping = 1;
+        __atomic_store_n(&header->eos, 1, __ATOMIC_RELEASE);
+        notify_update(header);
+        return;
+    }
+
+    uint8_t *slot_data = s->data + header->slots_offset + (write_count % header->nb_slots) * header->slot_size;
+    struct ngl_capture_shm_slot *slot = (struct ngl_capture_shm_slot *)slot_data;
+    slot->pts      = frame->t;
+    slot->size     = s->frame_size;
+    slot->format   = frame->format;
+    slot->width    = frame->width;
+    slot->height   = frame->height;
+    slot->linesize = frame->linesize;
+    memcpy(slot_data + sizeof(*slot), frame->data, s->frame_size);
+
+    __atomic_store_n(&header->write_count, write_count + 1, __ATOMIC_RELEASE);
+    notify_update(header);
+}
+
+void ngli_capture_shm_reset(struct capture_shm *s)
+{
+    if (s->header) {
+        __atomic_store_n(&s->header->eos, 1, __ATOMIC_RELEASE);
+        notify_update(s->header);
+    }
+    if (s->data)
+        munmap(s->data, s->size);
+    if (s->name) {
+        close(s->fd);
+        shm_unlink(s->name);
+    }
+    ngli_free(s->name);
+    memset(s, 0, sizeof(*s));
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CAPTURE_SHM_H
+#define CAPTURE_SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "nodegl.h"
+
+/*
+ * Shared memory capture: the frames are copied into a ring of slots living
+ * in a named POSIX shared memory object so another process (typically an
+ * encoder) can map and consume them directly. See struct
+ * ngl_capture_shm_header in nodegl.h for the layout and the protocol.
+ */
+#define NGLI_CAPTURE_SHM_DEFAULT_SLOTS 4
+
+struct capture_shm {
+    char *name;
+    int fd;
+    uint8_t *data;
+    size_t size;
+    struct ngl_capture_shm_header *header;
+    int frame_size;
+    int closing;  /* Set before flushing the last frames, see wait_free_slot() */
+    int dropping; /* Whether the consumer gave up while closing */
+};
+
+int ngli_capture_shm_init(struct capture_shm *s, const char *name, int nb_slots, int frame_size);
+void ngli_capture_shm_write(void *user_data, const struct ngl_capture_frame *frame);
+void ngli_capture_shm_reset(struct capture_shm *s);
+
+#endif
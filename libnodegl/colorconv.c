@@ -150,3 +150,42 @@ int ngli_colorconv_get_ycbcr_to_rgb_color_matrix(float *dst, const struct color_
 
     return 0;
 }
+
+int ngli_colorconv_get_rgb_to_ycbcr_color_matrix(float *dst, const struct color_info *info)
+{
+    const int colormatrix = get_colormatrix_from_sxplayer(info->space);
+    const int video_range = info->range != SXPLAYER_COL_RNG_FULL;
+    const struct range_info range = range_infos[video_range];
+    const struct k_constants k = k_constants_infos[colormatrix];
+
+    const float y_scale  = range.y / 255;
+    const float uv_scale = range.uv / 255;
+    const float cb_scale = uv_scale / (2 * (1. - k.b));
+    const float cr_scale = uv_scale / (2 * (1. - k.r));
+
+    /* R factor */
+    dst[ 0 /* Y  */] = y_scale * k.r;
+    dst[ 1 /* Cb */] = -cb_scale * k.r;
+    dst[ 2 /* Cr */] = cr_scale * (1. - k.r);
+    dst[ 3 /* A  */] = 0;
+
+    /* G factor */
+    dst[ 4 /* Y  */] = y_scale * k.g;
+    dst[ 5 /* Cb */] = -cb_scale * k.g;
+    dst[ 6 /* Cr */] = -cr_scale * k.g;
+    dst[ 7 /* A  */] = 0;
+
+    /* B factor */
+    dst[ 8 /* Y  */] = y_scale * k.b;
+    dst[ 9 /* Cb */] = cb_scale * (1. - k.b);
+    dst[10 /* Cr */] = -cr_scale * k.b;
+    dst[11 /* A  */] = 0;
+
+    /* Offset */
+    dst[12 /* Y  */] = range.y_off / 255;
+    dst[13 /* Cb */] = 128 / 255.;
+    dst[14 /* Cr */] = 128 / 255.;
+    dst[15 /* A  */] = 1;
+
+    return 0;
+}
@@ -25,5 +25,6 @@
 #include "image.h"
 
 int ngli_colorconv_get_ycbcr_to_rgb_color_matrix(float *dst, const struct color_info *info);
+int ngli_colorconv_get_rgb_to_ycbcr_color_matrix(float *dst, const struct color_info *info);
 
 #endif
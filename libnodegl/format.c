@@ -21,6 +21,7 @@
 
 #include "format.h"
 #include "glcontext.h"
+#include "log.h"
 #include "nodes.h"
 
 static const struct {
@@ -220,3 +221,84 @@ int ngli_format_get_gl_renderbuffer_format(struct glcontext *gl, int data_format
 {
     return get_gl_format_type(gl, data_format, NULL, formatp, NULL);
 }
+
+int ngli_format_get_gl_vertex_attrib_format(struct glcontext *gl, int data_format,
+                                            GLenum *typep, GLboolean *normalizedp, int *integerp)
+{
+    static const struct entry {
+        GLenum type;
+        GLboolean normalized;
+        int integer;
+    } format_map[NGLI_FORMAT_NB] = {
+        [NGLI_FORMAT_R8_UNORM]            = {GL_UNSIGNED_BYTE,  GL_TRUE,  0},
+        [NGLI_FORMAT_R8_SNORM]            = {GL_BYTE,           GL_TRUE,  0},
+        [NGLI_FORMAT_R8_UINT]             = {GL_UNSIGNED_BYTE,  GL_FALSE, 1},
+        [NGLI_FORMAT_R8_SINT]             = {GL_BYTE,           GL_FALSE, 1},
+        [NGLI_FORMAT_R8G8_UNORM]          = {GL_UNSIGNED_BYTE,  GL_TRUE,  0},
+        [NGLI_FORMAT_R8G8_SNORM]          = {GL_BYTE,           GL_TRUE,  0},
+        [NGLI_FORMAT_R8G8_UINT]           = {GL_UNSIGNED_BYTE,  GL_FALSE, 1},
+        [NGLI_FORMAT_R8G8_SINT]           = {GL_BYTE,           GL_FALSE, 1},
+        [NGLI_FORMAT_R8G8B8_UNORM]        = {GL_UNSIGNED_BYTE,  GL_TRUE,  0},
+        [NGLI_FORMAT_R8G8B8_SNORM]        = {GL_BYTE,           GL_TRUE,  0},
+        [NGLI_FORMAT_R8G8B8_UINT]         = {GL_UNSIGNED_BYTE,  GL_FALSE, 1},
+        [NGLI_FORMAT_R8G8B8_SINT]         = {GL_BYTE,           GL_FALSE, 1},
+        [NGLI_FORMAT_R8G8B8A8_UNORM]      = {GL_UNSIGNED_BYTE,  GL_TRUE,  0},
+        [NGLI_FORMAT_R8G8B8A8_SNORM]      = {GL_BYTE,           GL_TRUE,  0},
+        [NGLI_FORMAT_R8G8B8A8_UINT]       = {GL_UNSIGNED_BYTE,  GL_FALSE, 1},
+        [NGLI_FORMAT_R8G8B8A8_SINT]       = {GL_BYTE,           GL_FALSE, 1},
+        [NGLI_FORMAT_R16_UNORM]           = {GL_UNSIGNED_SHORT, GL_TRUE,  0},
+        [NGLI_FORMAT_R16_SNORM]           = {GL_SHORT,          GL_TRUE,  0},
+        [NGLI_FORMAT_R16_UINT]            = {GL_UNSIGNED_SHORT, GL_FALSE, 1},
+        [NGLI_FORMAT_R16_SINT]            = {GL_SHORT,          GL_FALSE, 1},
+        [NGLI_FORMAT_R16_SFLOAT]          = {GL_HALF_FLOAT,     GL_FALSE, 0},
+        [NGLI_FORMAT_R16G16_UNORM]        = {GL_UNSIGNED_SHORT, GL_TRUE,  0},
+        [NGLI_FORMAT_R16G16_SNORM]        = {GL_SHORT,          GL_TRUE,  0},
+        [NGLI_FORMAT_R16G16_UINT]         = {GL_UNSIGNED_SHORT, GL_FALSE, 1},
+        [NGLI_FORMAT_R16G16_SINT]         = {GL_SHORT,          GL_FALSE, 1},
+        [NGLI_FORMAT_R16G16_SFLOAT]       = {GL_HALF_FLOAT,     GL_FALSE, 0},
+        [NGLI_FORMAT_R16G16B16_UNORM]     = {GL_UNSIGNED_SHORT, GL_TRUE,  0},
+        [NGLI_FORMAT_R16G16B16_SNORM]     = {GL_SHORT,          GL_TRUE,  0},
+        [NGLI_FORMAT_R16G16B16_UINT]      = {GL_UNSIGNED_SHORT, GL_FALSE, 1},
+        [NGLI_FORMAT_R16G16B16_SINT]      = {GL_SHORT,          GL_FALSE, 1},
+        [NGLI_FORMAT_R16G16B16_SFLOAT]    = {GL_HALF_FLOAT,     GL_FALSE, 0},
+        [NGLI_FORMAT_R16G16B16A16_UNORM]  = {GL_UNSIGNED_SHORT, GL_TRUE,  0},
+        [NGLI_FORMAT_R16G16B16A16_SNORM]  = {GL_SHORT,          GL_TRUE,  0},
+        [NGLI_FORMAT_R16G16B16A16_UINT]   = {GL_UNSIGNED_SHORT, GL_FALSE, 1},
+        [NGLI_FORMAT_R16G16B16A16_SINT]   = {GL_SHORT,          GL_FALSE, 1},
+        [NGLI_FORMAT_R16G16B16A16_SFLOAT] = {GL_HALF_FLOAT,     GL_FALSE, 0},
+        [NGLI_FORMAT_R32_UINT]            = {GL_UNSIGNED_INT,   GL_FALSE, 1},
+        [NGLI_FORMAT_R32_SINT]            = {GL_INT,            GL_FALSE, 1},
+        [NGLI_FORMAT_R32_SFLOAT]          = {GL_FLOAT,          GL_FALSE, 0},
+        [NGLI_FORMAT_R32G32_UINT]         = {GL_UNSIGNED_INT,   GL_FALSE, 1},
+        [NGLI_FORMAT_R32G32_SINT]         = {GL_INT,            GL_FALSE, 1},
+        [NGLI_FORMAT_R32G32_SFLOAT]       = {GL_FLOAT,          GL_FALSE, 0},
+        [NGLI_FORMAT_R32G32B32_UINT]      = {GL_UNSIGNED_INT,   GL_FALSE, 1},
+        [NGLI_FORMAT_R32G32B32_SINT]      = {GL_INT,            GL_FALSE, 1},
+        [NGLI_FORMAT_R32G32B32_SFLOAT]    = {GL_FLOAT,          GL_FALSE, 0},
+        [NGLI_FORMAT_R32G32B32A32_UINT]   = {GL_UNSIGNED_INT,   GL_FALSE, 1},
+        [NGLI_FORMAT_R32G32B32A32_SINT]   = {GL_INT,            GL_FALSE, 1},
+        [NGLI_FORMAT_R32G32B32A32_SFLOAT] = {GL_FLOAT,          GL_FALSE, 0},
+    };
+
+    ngli_assert(data_format >= 0 && data_format < NGLI_ARRAY_NB(format_map));
+    const struct entry *entry = &format_map[data_format];
+    if (!entry->type) {
+        LOG(ERROR, "format %d is not supported as vertex attribute", data_format);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    if (gl->backend == NGL_BACKEND_OPENGLES && gl->version < 300 &&
+        (entry->integer || entry->type == GL_HALF_FLOAT)) {
+        LOG(ERROR, "integer and half-float vertex attributes require OpenGLES >= 3.0");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    if (typep)
+        *typep = entry->type;
+    if (normalizedp)
+        *normalizedp = entry->normalized;
+    if (integerp)
+        *integerp = entry->integer;
+
+    return 0;
+}
@@ -105,5 +105,11 @@ int ngli_format_get_gl_renderbuffer_format(struct glcontext *gl,
                                            int data_format,
                                            GLint *formatp);
 
+int ngli_format_get_gl_vertex_attrib_format(struct glcontext *gl,
+                                            int data_format,
+                                            GLenum *typep,
+                                            GLboolean *normalizedp,
+                                            int *integerp);
+
 
 #endif
@@ -31,7 +31,7 @@ void ngli_gctx_set_rendertarget(struct ngl_ctx *s, struct rendertarget *rt)
         return;
 
     const GLuint fbo_id = rt ? rt->id : ngli_glcontext_get_default_framebuffer(gl);
-    ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, fbo_id);
+    ngli_glstate_bind_framebuffer(gl, &s->glstate, GL_FRAMEBUFFER, fbo_id);
 
     s->rendertarget = rt;
 }
@@ -44,7 +44,7 @@ struct rendertarget *ngli_gctx_get_rendertarget(struct ngl_ctx *s)
 void ngli_gctx_set_viewport(struct ngl_ctx *s, const int *viewport)
 {
     struct glcontext *gl = s->glcontext;
-    ngli_glViewport(gl, viewport[0], viewport[1], viewport[2], viewport[3]);
+    ngli_glstate_viewport(gl, &s->glstate, viewport);
     memcpy(&s->viewport, viewport, sizeof(s->viewport));
 }
 
@@ -56,7 +56,7 @@ void ngli_gctx_get_viewport(struct ngl_ctx *s, int *viewport)
 void ngli_gctx_set_scissor(struct ngl_ctx *s, const int *scissor)
 {
     struct glcontext *gl = s->glcontext;
-    ngli_glScissor(gl, scissor[0], scissor[1], scissor[2], scissor[3]);
+    ngli_glstate_scissor(gl, &s->glstate, scissor);
     memcpy(&s->scissor, scissor, sizeof(s->scissor));
 }
 
@@ -82,7 +82,7 @@ void ngli_gctx_clear_color(struct ngl_ctx *s)
     struct glcontext *gl = s->glcontext;
     struct glstate *glstate = &s->glstate;
 
-    const int scissor_test = glstate->scissor_test;
+    const int scissor_test = glstate->render.scissor_test;
     ngli_glDisable(gl, GL_SCISSOR_TEST);
 
     ngli_glClear(gl, GL_COLOR_BUFFER_BIT);
@@ -96,7 +96,7 @@ void ngli_gctx_clear_depth_stencil(struct ngl_ctx *s)
     struct glcontext *gl = s->glcontext;
     struct glstate *glstate = &s->glstate;
 
-    const int scissor_test = glstate->scissor_test;
+    const int scissor_test = glstate->render.scissor_test;
     ngli_glDisable(gl, GL_SCISSOR_TEST);
 
     ngli_glClear(gl, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
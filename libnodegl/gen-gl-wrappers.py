@@ -42,6 +42,7 @@ cmds_optional = [
     'glBindVertexArray',
     'glDeleteVertexArrays',
     'glGenVertexArrays',
+    'glVertexAttribIPointer',
 
     # Barrier
     'glMemoryBarrier',
@@ -49,10 +50,21 @@ cmds_optional = [
     #  Buffers
     'glBindBufferBase',
     'glBindBufferRange',
+    'glBufferStorage',
+    'glMapBufferRange',
+    'glUnmapBuffer',
 
     # Compute shaders
     'glDispatchCompute',
 
+    # Parallel shader compilation
+    'glMaxShaderCompilerThreadsKHR',
+
+    # Program binaries
+    'glGetProgramBinary',
+    'glProgramBinary',
+    'glProgramParameteri',
+
     # Shaders
     'glGetProgramResourceLocation',
     'glGetProgramResourceIndex',
@@ -63,6 +75,10 @@ cmds_optional = [
     # Polygon
     'glPolygonMode',
 
+    # Draw
+    'glMultiDrawArraysIndirect',
+    'glMultiDrawElementsIndirect',
+
     # Internal format
     'glGetInternalformativ',
 
@@ -90,6 +106,7 @@ cmds_optional = [
     'glUniformBlockBinding',
     'glGetActiveUniformBlockName',
     'glGetActiveUniformBlockiv',
+    'glGetActiveUniformsiv',
 
     # EGL OES image
     'glEGLImageTargetTexture2DOES',
@@ -98,6 +115,7 @@ cmds_optional = [
     'glFenceSync',
     'glWaitSync',
     'glClientWaitSync',
+    'glDeleteSync',
 
     # Read/Draw Buffer
     'glReadBuffer',
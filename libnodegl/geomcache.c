@@ -0,0 +1,265 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "format.h"
+#include "geomcache.h"
+#include "log.h"
+#include "memory.h"
+#include "nodes.h"
+#include "utils.h"
+
+struct cached_geometry {
+    struct optimized_geometry geometry; /* must be first */
+    char key[64];
+    uint8_t *data;
+    int size;
+    int refcount;
+};
+
+static void free_cached_geometry(struct cached_geometry *cached_geometry)
+{
+    ngli_buffer_reset(&cached_geometry->geometry.vertices);
+    ngli_buffer_reset(&cached_geometry->geometry.indices);
+    ngli_free(cached_geometry->data);
+    ngli_free(cached_geometry);
+}
+
+static void reset_cached_geometry(void *user_arg, void *data)
+{
+    free_cached_geometry(data);
+}
+
+int ngli_geomcache_init(struct geomcache *s, struct ngl_ctx *ctx)
+{
+    s->ctx = ctx;
+    s->geometries = ngli_hmap_create();
+    if (!s->geometries)
+        return NGL_ERROR_MEMORY;
+    ngli_hmap_set_free(s->geometries, reset_cached_geometry, s);
+    return 0;
+}
+
+/*
+ * Serialize everything the optimization depends on: the result of the
+ * optimization only depends on the raw attribute bytes, not on their
+ * format.
+ */
+static uint8_t *serialize_params(const struct geomopt_params *params, int *sizep)
+{
+    const int header[] = {
+        params->nb_attributes,
+        params->nb_vertices,
+        params->indices ? params->nb_indices : -1,
+        params->dedup,
+        params->cache_size,
+    };
+
+    int size = sizeof(header);
+    for (int i = 0; i < params->nb_attributes; i++)
+        size += sizeof(int) + params->nb_vertices * params->attributes[i].size;
+    if (params->indices)
+        size += params->nb_indices * sizeof(*params->indices);
+
+    uint8_t *data = ngli_malloc(size);
+    if (!data)
+        return NULL;
+
+    uint8_t *p = data;
+    memcpy(p, header, sizeof(header));
+    p += sizeof(header);
+    for (int i = 0; i < params->nb_attributes; i++) {
+        const struct geomopt_attribute *attribute = &params->attributes[i];
+        memcpy(p, &attribute->size, sizeof(int));
+        p += sizeof(int);
+        for (int v = 0; v < params->nb_vertices; v++) {
+            memcpy(p, attribute->data + v * attribute->stride, attribute->size);
+            p += attribute->size;
+        }
+    }
+    if (params->indices)
+        memcpy(p, params->indices, params->nb_indices * sizeof(*params->indices));
+
+    *sizep = size;
+    return data;
+}
+
+static int upload_geometry(struct ngl_ctx *ctx, struct optimized_geometry *geometry, const struct geomopt *geomopt)
+{
+    const int vertices_size = geomopt->nb_vertices * geomopt->stride;
+    int ret = ngli_buffer_init(&geometry->vertices, ctx, vertices_size, NGLI_BUFFER_USAGE_STATIC);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_buffer_upload(&geometry->vertices, geomopt->vertices, vertices_size, 0);
+    if (ret < 0)
+        return ret;
+
+    geometry->nb_vertices = geomopt->nb_vertices;
+    geometry->stride = geomopt->stride;
+    memcpy(geometry->offsets, geomopt->offsets, sizeof(geometry->offsets));
+    geometry->nb_indices = geomopt->nb_indices;
+
+    /* 32-bit indices are narrowed whenever possible */
+    int indices_size = geomopt->nb_indices * sizeof(*geomopt->indices);
+    uint16_t *indices16 = NULL;
+    const void *indices = geomopt->indices;
+    if (geomopt->nb_vertices <= UINT16_MAX + 1) {
+        indices16 = ngli_malloc(geomopt->nb_indices * sizeof(*indices16));
+        if (!indices16)
+            return NGL_ERROR_MEMORY;
+        for (int i = 0; i < geomopt->nb_indices; i++)
+            indices16[i] = geomopt->indices[i];
+        indices = indices16;
+        indices_size = geomopt->nb_indices * sizeof(*indices16);
+        geometry->indices_format = NGLI_FORMAT_R16_UNORM;
+    } else {
+        geometry->indices_format = NGLI_FORMAT_R32_UINT;
+    }
+
+    ret = ngli_buffer_init(&geometry->indices, ctx, indices_size, NGLI_BUFFER_USAGE_STATIC);
+    if (ret >= 0)
+        ret = ngli_buffer_upload(&geometry->indices, indices, indices_size, 0);
+    ngli_free(indices16);
+    return ret;
+}
+
+static void log_optimization(const struct geomopt_params *params, const struct geomopt *geomopt)
+{
+    const int nb_triangles = geomopt->nb_indices / 3;
+    const int misses_before = params->indices
+                            ? ngli_geomopt_get_cache_misses(params->indices, params->nb_indices,
+                                                            params->nb_vertices, params->cache_size)
+                            : params->nb_vertices;
+    const int misses_after = ngli_geomopt_get_cache_misses(geomopt->indices, geomopt->nb_indices,
+                                                           geomopt->nb_vertices, params->cache_size);
+    LOG(DEBUG, "geometry optimized: %d -> %d vertices, ACMR %.3f -> %.3f",
+        params->nb_vertices, geomopt->nb_vertices,
+        misses_before / (double)nb_triangles, misses_after / (double)nb_triangles);
+}
+
+static int create_cached_geometry(struct geomcache *s, struct cached_geometry **dst,
+                                  const char *key, uint8_t *data, int size,
+                                  const struct geomopt_params *params)
+{
+    struct cached_geometry *cached_geometry = ngli_calloc(1, sizeof(*cached_geometry));
+    if (!cached_geometry) {
+        ngli_free(data);
+        return NGL_ERROR_MEMORY;
+    }
+
+    snprintf(cached_geometry->key, sizeof(cached_geometry->key), "%s", key);
+    cached_geometry->refcount = 1;
+
+    /* The serialized parameters are kept around to rule out hash collisions */
+    cached_geometry->data = data;
+    cached_geometry->size = size;
+
+    struct geomopt geomopt = {0};
+    int ret = ngli_geomopt_optimize(&geomopt, params);
+    if (ret < 0)
+        goto fail;
+
+    log_optimization(params, &geomopt);
+
+    ret = upload_geometry(s->ctx, &cached_geometry->geometry, &geomopt);
+    ngli_geomopt_reset(&geomopt);
+    if (ret < 0)
+        goto fail;
+
+    *dst = cached_geometry;
+    return 0;
+
+fail:
+    free_cached_geometry(cached_geometry);
+    return ret;
+}
+
+/*
+ * Returns the GPU buffers of the optimized geometry described by params:
+ * the optimization is done only once for a given content.
+ */
+int ngli_geomcache_get_geometry(struct geomcache *s, struct optimized_geometry **dst,
+                                const struct geomopt_params *params)
+{
+    int size;
+    uint8_t *data = serialize_params(params, &size);
+    if (!data)
+        return NGL_ERROR_MEMORY;
+
+    char key[64];
+    snprintf(key, sizeof(key), "%016" PRIx64 ":%d", ngli_fnv1a64(NGLI_FNV1A64_INIT, data, size), size);
+
+    struct cached_geometry *cached_geometry = ngli_hmap_get(s->geometries, key);
+    if (cached_geometry && !memcmp(cached_geometry->data, data, size)) {
+        ngli_free(data);
+        cached_geometry->refcount++;
+        *dst = &cached_geometry->geometry;
+        return 0;
+    }
+
+    struct cached_geometry *new_geometry;
+    int ret = create_cached_geometry(s, &new_geometry, key, data, size, params);
+    if (ret < 0)
+        return ret;
+
+    /* In the unlikely event of a hash collision, the geometry is not shared */
+    if (cached_geometry) {
+        new_geometry->key[0] = 0;
+    } else {
+        ret = ngli_hmap_set(s->geometries, key, new_geometry);
+        if (ret < 0) {
+            free_cached_geometry(new_geometry);
+            return ret;
+        }
+    }
+
+    *dst = &new_geometry->geometry;
+    return 0;
+}
+
+void ngli_geomcache_release_geometry(struct geomcache *s, struct optimized_geometry **geometryp)
+{
+    struct cached_geometry *cached_geometry = (struct cached_geometry *)*geometryp;
+    if (!cached_geometry)
+        return;
+    *geometryp = NULL;
+
+    ngli_assert(cached_geometry->refcount > 0);
+    if (--cached_geometry->refcount)
+        return;
+
+    if (cached_geometry->key[0])
+        ngli_hmap_set(s->geometries, cached_geometry->key, NULL);
+    else
+        free_cached_geometry(cached_geometry);
+}
+
+void ngli_geomcache_reset(struct geomcache *s)
+{
+    if (!s->ctx)
+        return;
+    ngli_hmap_freep(&s->geometries);
+    memset(s, 0, sizeof(*s));
+}
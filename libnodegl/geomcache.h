@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef GEOMCACHE_H
+#define GEOMCACHE_H
+
+#include "buffer.h"
+#include "geomopt.h"
+#include "hmap.h"
+
+struct ngl_ctx;
+
+struct geomcache {
+    struct ngl_ctx *ctx;
+    struct hmap *geometries;
+};
+
+struct optimized_geometry {
+    struct buffer vertices;
+    int nb_vertices;
+    int stride;
+    int offsets[NGLI_GEOMOPT_MAX_ATTRIBUTES];
+    struct buffer indices;
+    int nb_indices;
+    int indices_format;
+};
+
+int ngli_geomcache_init(struct geomcache *s, struct ngl_ctx *ctx);
+int ngli_geomcache_get_geometry(struct geomcache *s, struct optimized_geometry **dst,
+                                const struct geomopt_params *params);
+void ngli_geomcache_release_geometry(struct geomcache *s, struct optimized_geometry **geometryp);
+void ngli_geomcache_reset(struct geomcache *s);
+
+#endif
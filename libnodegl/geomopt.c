@@ -0,0 +1,330 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "geomopt.h"
+#include "log.h"
+#include "memory.h"
+#include "nodegl.h"
+#include "utils.h"
+
+static uint64_t hash_vertex(const struct geomopt_params *params, int v)
+{
+    uint64_t hash = NGLI_FNV1A64_INIT;
+    for (int i = 0; i < params->nb_attributes; i++) {
+        const struct geomopt_attribute *attribute = &params->attributes[i];
+        hash = ngli_fnv1a64(hash, attribute->data + v * attribute->stride, attribute->size);
+    }
+    return hash;
+}
+
+static int vertex_equal(const struct geomopt_params *params, int a, int b)
+{
+    for (int i = 0; i < params->nb_attributes; i++) {
+        const struct geomopt_attribute *attribute = &params->attributes[i];
+        const uint8_t *data = attribute->data;
+        if (memcmp(data + a * attribute->stride, data + b * attribute->stride, attribute->size))
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ * Map every vertex to the first vertex sharing all its attribute values,
+ * using an open addressing hash table.
+ */
+static int dedup_vertices(int *remap, const struct geomopt_params *params)
+{
+    const int nb_vertices = params->nb_vertices;
+
+    int table_size = 1;
+    while (table_size < 2 * nb_vertices)
+        table_size <<= 1;
+
+    int *table = ngli_malloc(table_size * sizeof(*table));
+    if (!table)
+        return NGL_ERROR_MEMORY;
+    memset(table, 0xff, table_size * sizeof(*table));
+
+    const uint64_t mask = table_size - 1;
+    for (int v = 0; v < nb_vertices; v++) {
+        uint64_t pos = hash_vertex(params, v) & mask;
+        for (;;) {
+            const int u = table[pos];
+            if (u < 0) {
+                table[pos] = v;
+                remap[v] = v;
+                break;
+            }
+            if (vertex_equal(params, u, v)) {
+                remap[v] = u;
+                break;
+            }
+            pos = (pos + 1) & mask;
+        }
+    }
+
+    ngli_free(table);
+    return 0;
+}
+
+/*
+ * Triangle reordering for post-transform vertex cache efficiency, following
+ * the Tipsify algorithm from "Fast Triangle Reordering for Vertex Locality
+ * and Reduced Overdraw" (Sander, Nehab, Barczak, 2007). Triangles are
+ * emitted by fanning around vertices, picking as next fanning vertex the
+ * one that is the most likely to still be in the cache once all its
+ * remaining triangles are emitted.
+ */
+static int optimize_vertex_cache(uint32_t *dst, const uint32_t *indices, int nb_indices,
+                                 int nb_vertices, int cache_size)
+{
+    const int nb_triangles = nb_indices / 3;
+    int ret = 0;
+
+    int *live       = ngli_calloc(nb_vertices, sizeof(*live));
+    int *offsets    = ngli_calloc(nb_vertices + 1, sizeof(*offsets));
+    int *timestamps = ngli_calloc(nb_vertices, sizeof(*timestamps));
+    int *adjacency  = ngli_calloc(nb_indices, sizeof(*adjacency));
+    int *dead_ends  = ngli_calloc(nb_indices, sizeof(*dead_ends));
+    int *candidates = ngli_calloc(nb_indices, sizeof(*candidates));
+    uint8_t *emitted = ngli_calloc(nb_triangles, sizeof(*emitted));
+    if (!live || !offsets || !timestamps || !adjacency || !dead_ends || !candidates || !emitted) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    /*
+     * Vertex to triangles adjacency, stored contiguously per vertex (the
+     * timestamps are temporarily used as per-vertex fill counters)
+     */
+    for (int i = 0; i < nb_indices; i++)
+        live[indices[i]]++;
+    for (int v = 0; v < nb_vertices; v++)
+        offsets[v + 1] = offsets[v] + live[v];
+    for (int i = 0; i < nb_indices; i++)
+        adjacency[timestamps[indices[i]]++ + offsets[indices[i]]] = i / 3;
+    memset(timestamps, 0, nb_vertices * sizeof(*timestamps));
+
+    int time = cache_size + 1;
+    int cursor = 0;
+    int nb_dead_ends = 0;
+    int nb_emitted = 0;
+    int fanning = nb_indices ? indices[0] : -1;
+
+    while (fanning >= 0) {
+        int nb_candidates = 0;
+        for (int i = offsets[fanning]; i < offsets[fanning + 1]; i++) {
+            const int t = adjacency[i];
+            if (emitted[t])
+                continue;
+            for (int k = 0; k < 3; k++) {
+                const int v = indices[t * 3 + k];
+                dst[nb_emitted++] = v;
+                dead_ends[nb_dead_ends++] = v;
+                candidates[nb_candidates++] = v;
+                live[v]--;
+                if (time - timestamps[v] > cache_size)
+                    timestamps[v] = time++;
+            }
+            emitted[t] = 1;
+        }
+
+        /*
+         * Pick the candidate that entered the cache the earliest among the
+         * ones which will still be in the cache after having emitted all
+         * their live triangles.
+         */
+        int next = -1;
+        int best_priority = -1;
+        for (int i = 0; i < nb_candidates; i++) {
+            const int v = candidates[i];
+            if (!live[v])
+                continue;
+            int priority = 0;
+            if (time - timestamps[v] + 2 * live[v] <= cache_size)
+                priority = time - timestamps[v];
+            if (priority > best_priority) {
+                best_priority = priority;
+                next = v;
+            }
+        }
+
+        /* Dead-end: fallback on the recently used vertices, then on the input order */
+        while (next < 0 && nb_dead_ends > 0) {
+            const int v = dead_ends[--nb_dead_ends];
+            if (live[v])
+                next = v;
+        }
+        while (next < 0 && cursor < nb_vertices) {
+            if (live[cursor])
+                next = cursor;
+            cursor++;
+        }
+
+        fanning = next;
+    }
+
+    ngli_assert(nb_emitted == nb_indices);
+
+end:
+    ngli_free(live);
+    ngli_free(offsets);
+    ngli_free(timestamps);
+    ngli_free(adjacency);
+    ngli_free(dead_ends);
+    ngli_free(candidates);
+    ngli_free(emitted);
+    return ret;
+}
+
+static void write_vertex(struct geomopt *s, const struct geomopt_params *params, int dst, int src)
+{
+    uint8_t *vertex = s->vertices + dst * s->stride;
+    for (int i = 0; i < params->nb_attributes; i++) {
+        const struct geomopt_attribute *attribute = &params->attributes[i];
+        memcpy(vertex + s->offsets[i], attribute->data + src * attribute->stride, attribute->size);
+    }
+}
+
+int ngli_geomopt_optimize(struct geomopt *s, const struct geomopt_params *params)
+{
+    if (params->nb_attributes < 1 || params->nb_attributes > NGLI_GEOMOPT_MAX_ATTRIBUTES)
+        return NGL_ERROR_INVALID_ARG;
+
+    const int nb_vertices = params->nb_vertices;
+    const int nb_indices = params->indices ? params->nb_indices : nb_vertices;
+    if (nb_vertices <= 0 || nb_indices <= 0)
+        return NGL_ERROR_INVALID_ARG;
+    if (nb_indices % 3) {
+        LOG(ERROR, "triangle list index count (%d) is not a multiple of 3", nb_indices);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    int ret = 0;
+    uint32_t *indices = ngli_malloc(nb_indices * sizeof(*indices));
+    int *remap = ngli_malloc(nb_vertices * sizeof(*remap));
+    if (!indices || !remap) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    if (params->dedup) {
+        ret = dedup_vertices(remap, params);
+        if (ret < 0)
+            goto end;
+    } else {
+        for (int v = 0; v < nb_vertices; v++)
+            remap[v] = v;
+    }
+
+    for (int i = 0; i < nb_indices; i++) {
+        const uint32_t v = params->indices ? params->indices[i] : i;
+        if (v >= nb_vertices) {
+            LOG(ERROR, "index %u exceeds the number of vertices (%d)", v, nb_vertices);
+            ret = NGL_ERROR_INVALID_ARG;
+            goto end;
+        }
+        indices[i] = remap[v];
+    }
+
+    s->indices = ngli_malloc(nb_indices * sizeof(*s->indices));
+    if (!s->indices) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+    s->nb_indices = nb_indices;
+
+    ret = optimize_vertex_cache(s->indices, indices, nb_indices, nb_vertices, params->cache_size);
+    if (ret < 0)
+        goto end;
+
+    /* Attributes are interleaved, each of them aligned on 4 bytes */
+    s->stride = 0;
+    for (int i = 0; i < params->nb_attributes; i++) {
+        s->offsets[i] = s->stride;
+        s->stride += NGLI_ALIGN(params->attributes[i].size, 4);
+    }
+
+    s->vertices = ngli_calloc(nb_vertices, s->stride);
+    if (!s->vertices) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    if (params->dedup) {
+        /*
+         * Renumber the remaining vertices in their order of first use so
+         * that vertex fetches follow the index buffer; unreferenced
+         * vertices are dropped.
+         */
+        memset(remap, 0xff, nb_vertices * sizeof(*remap));
+        for (int i = 0; i < nb_indices; i++) {
+            const int v = s->indices[i];
+            if (remap[v] < 0) {
+                remap[v] = s->nb_vertices++;
+                write_vertex(s, params, remap[v], v);
+            }
+            s->indices[i] = remap[v];
+        }
+    } else {
+        /* Vertex indices must be preserved for the extra attributes */
+        for (int v = 0; v < nb_vertices; v++)
+            write_vertex(s, params, v, v);
+        s->nb_vertices = nb_vertices;
+    }
+
+end:
+    ngli_free(remap);
+    ngli_free(indices);
+    if (ret < 0)
+        ngli_geomopt_reset(s);
+    return ret;
+}
+
+int ngli_geomopt_get_cache_misses(const uint32_t *indices, int nb_indices, int nb_vertices, int cache_size)
+{
+    int *timestamps = ngli_calloc(nb_vertices, sizeof(*timestamps));
+    if (!timestamps)
+        return NGL_ERROR_MEMORY;
+
+    /* FIFO cache: a vertex is still cached if fewer than cache_size vertices entered after it */
+    int time = cache_size + 1;
+    int nb_misses = 0;
+    for (int i = 0; i < nb_indices; i++) {
+        const int v = indices[i];
+        if (time - timestamps[v] > cache_size) {
+            timestamps[v] = time++;
+            nb_misses++;
+        }
+    }
+
+    ngli_free(timestamps);
+    return nb_misses;
+}
+
+void ngli_geomopt_reset(struct geomopt *s)
+{
+    ngli_free(s->vertices);
+    ngli_free(s->indices);
+    memset(s, 0, sizeof(*s));
+}
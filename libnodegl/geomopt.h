@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef GEOMOPT_H
+#define GEOMOPT_H
+
+#include <stdint.h>
+
+#define NGLI_GEOMOPT_MAX_ATTRIBUTES 4
+
+struct geomopt_attribute {
+    const uint8_t *data;
+    int stride;                 // stride between 2 elements in data, in bytes
+    int size;                   // size of 1 element, in bytes
+};
+
+struct geomopt_params {
+    const struct geomopt_attribute *attributes;
+    int nb_attributes;
+    int nb_vertices;
+    const uint32_t *indices;    // triangle list, NULL for a non-indexed geometry
+    int nb_indices;
+    int dedup;                  // merge identical vertices
+    int cache_size;             // post-transform vertex cache size to optimize for
+};
+
+struct geomopt {
+    uint8_t *vertices;          // interleaved vertices
+    int nb_vertices;
+    int stride;
+    int offsets[NGLI_GEOMOPT_MAX_ATTRIBUTES];
+    uint32_t *indices;
+    int nb_indices;
+};
+
+int ngli_geomopt_optimize(struct geomopt *s, const struct geomopt_params *params);
+int ngli_geomopt_get_cache_misses(const uint32_t *indices, int nb_indices, int nb_vertices, int cache_size);
+void ngli_geomopt_reset(struct geomopt *s);
+
+#endif
@@ -296,6 +296,11 @@ static int glcontext_probe_settings(struct glcontext *glcontext)
 
     if (glcontext->features & NGLI_FEATURE_UNIFORM_BUFFER_OBJECT) {
         ngli_glGetIntegerv(glcontext, GL_MAX_UNIFORM_BLOCK_SIZE, &glcontext->max_uniform_block_size);
+        ngli_glGetIntegerv(glcontext, GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &glcontext->uniform_buffer_offset_alignment);
+    }
+
+    if (glcontext->features & NGLI_FEATURE_SHADER_STORAGE_BUFFER_OBJECT) {
+        ngli_glGetIntegerv(glcontext, GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &glcontext->shader_storage_buffer_offset_alignment);
     }
 
     if (glcontext->features & NGLI_FEATURE_COMPUTE_SHADER) {
@@ -310,6 +315,29 @@ static int glcontext_probe_settings(struct glcontext *glcontext)
         ngli_glGetIntegerv(glcontext, GL_MAX_DRAW_BUFFERS, &glcontext->max_draw_buffers);
     }
 
+    /* Non-zero base instances are required to address the per-draw data */
+    glcontext->multi_draw_indirect = glcontext->backend == NGL_BACKEND_OPENGL &&
+                                     glcontext->version >= 430 &&
+                                     glcontext->funcs.MultiDrawArraysIndirect &&
+                                     glcontext->funcs.MultiDrawElementsIndirect;
+
+    /* Some drivers expose the entry points without any binary format */
+    const int program_binary_version = glcontext->backend == NGL_BACKEND_OPENGLES ? 300 : 410;
+    if (glcontext->version >= program_binary_version &&
+        glcontext->funcs.GetProgramBinary &&
+        glcontext->funcs.ProgramBinary &&
+        glcontext->funcs.ProgramParameteri) {
+        GLint nb_formats = 0;
+        ngli_glGetIntegerv(glcontext, GL_NUM_PROGRAM_BINARY_FORMATS, &nb_formats);
+        glcontext->program_binary = nb_formats > 0;
+    }
+
+    /* Let the driver compile and link the programs on its own threads */
+    static const char *parallel_shader_compile_exts[] = {"GL_KHR_parallel_shader_compile", NULL};
+    if (glcontext->funcs.MaxShaderCompilerThreadsKHR &&
+        glcontext_check_extensions(glcontext, parallel_shader_compile_exts))
+        ngli_glMaxShaderCompilerThreadsKHR(glcontext, 0xFFFFFFFF);
+
     return 0;
 }
 
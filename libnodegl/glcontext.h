@@ -56,6 +56,7 @@
 #define NGLI_FEATURE_ROW_LENGTH                   (1 << 27)
 #define NGLI_FEATURE_SOFTWARE                     (1 << 28)
 #define NGLI_FEATURE_UINT_UNIFORMS                (1 << 29)
+#define NGLI_FEATURE_BUFFER_STORAGE               (1 << 30)
 
 #define NGLI_FEATURE_COMPUTE_SHADER_ALL (NGLI_FEATURE_COMPUTE_SHADER           | \
                                          NGLI_FEATURE_PROGRAM_INTERFACE_QUERY  | \
@@ -85,9 +86,13 @@ struct glcontext {
     int max_texture_image_units;
     int max_compute_work_group_counts[3];
     int max_uniform_block_size;
+    int uniform_buffer_offset_alignment;
+    int shader_storage_buffer_offset_alignment;
     int max_samples;
     int max_color_attachments;
     int max_draw_buffers;
+    int multi_draw_indirect;
+    int program_binary;
 
     /* GL functions */
     struct glfunctions funcs;
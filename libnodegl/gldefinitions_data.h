@@ -33,6 +33,7 @@ static const struct gldefinition {
     {"glBlendFuncSeparate", offsetof(struct glfunctions, BlendFuncSeparate), M},
     {"glBlitFramebuffer", offsetof(struct glfunctions, BlitFramebuffer), 0},
     {"glBufferData", offsetof(struct glfunctions, BufferData), M},
+    {"glBufferStorage", offsetof(struct glfunctions, BufferStorage), 0},
     {"glBufferSubData", offsetof(struct glfunctions, BufferSubData), M},
     {"glCheckFramebufferStatus", offsetof(struct glfunctions, CheckFramebufferStatus), M},
     {"glClear", offsetof(struct glfunctions, Clear), M},
@@ -50,6 +51,7 @@ static const struct gldefinition {
     {"glDeleteQueriesEXT", offsetof(struct glfunctions, DeleteQueriesEXT), 0},
     {"glDeleteRenderbuffers", offsetof(struct glfunctions, DeleteRenderbuffers), M},
     {"glDeleteShader", offsetof(struct glfunctions, DeleteShader), M},
+    {"glDeleteSync", offsetof(struct glfunctions, DeleteSync), 0},
     {"glDeleteTextures", offsetof(struct glfunctions, DeleteTextures), M},
     {"glDeleteVertexArrays", offsetof(struct glfunctions, DeleteVertexArrays), 0},
     {"glDepthFunc", offsetof(struct glfunctions, DepthFunc), M},
@@ -85,6 +87,7 @@ static const struct gldefinition {
     {"glGetActiveUniform", offsetof(struct glfunctions, GetActiveUniform), M},
     {"glGetActiveUniformBlockName", offsetof(struct glfunctions, GetActiveUniformBlockName), 0},
     {"glGetActiveUniformBlockiv", offsetof(struct glfunctions, GetActiveUniformBlockiv), 0},
+    {"glGetActiveUniformsiv", offsetof(struct glfunctions, GetActiveUniformsiv), 0},
     {"glGetAttachedShaders", offsetof(struct glfunctions, GetAttachedShaders), M},
     {"glGetAttribLocation", offsetof(struct glfunctions, GetAttribLocation), M},
     {"glGetBooleanv", offsetof(struct glfunctions, GetBooleanv), M},
@@ -92,6 +95,7 @@ static const struct gldefinition {
     {"glGetIntegeri_v", offsetof(struct glfunctions, GetIntegeri_v), M},
     {"glGetIntegerv", offsetof(struct glfunctions, GetIntegerv), M},
     {"glGetInternalformativ", offsetof(struct glfunctions, GetInternalformativ), 0},
+    {"glGetProgramBinary", offsetof(struct glfunctions, GetProgramBinary), 0},
     {"glGetProgramInfoLog", offsetof(struct glfunctions, GetProgramInfoLog), M},
     {"glGetProgramInterfaceiv", offsetof(struct glfunctions, GetProgramInterfaceiv), 0},
     {"glGetProgramResourceIndex", offsetof(struct glfunctions, GetProgramResourceIndex), 0},
@@ -112,9 +116,15 @@ static const struct gldefinition {
     {"glGetUniformiv", offsetof(struct glfunctions, GetUniformiv), M},
     {"glInvalidateFramebuffer", offsetof(struct glfunctions, InvalidateFramebuffer), 0},
     {"glLinkProgram", offsetof(struct glfunctions, LinkProgram), M},
+    {"glMapBufferRange", offsetof(struct glfunctions, MapBufferRange), 0},
+    {"glMaxShaderCompilerThreadsKHR", offsetof(struct glfunctions, MaxShaderCompilerThreadsKHR), 0},
     {"glMemoryBarrier", offsetof(struct glfunctions, MemoryBarrier), 0},
+    {"glMultiDrawArraysIndirect", offsetof(struct glfunctions, MultiDrawArraysIndirect), 0},
+    {"glMultiDrawElementsIndirect", offsetof(struct glfunctions, MultiDrawElementsIndirect), 0},
     {"glPixelStorei", offsetof(struct glfunctions, PixelStorei), M},
     {"glPolygonMode", offsetof(struct glfunctions, PolygonMode), 0},
+    {"glProgramBinary", offsetof(struct glfunctions, ProgramBinary), 0},
+    {"glProgramParameteri", offsetof(struct glfunctions, ProgramParameteri), 0},
     {"glReadBuffer", offsetof(struct glfunctions, ReadBuffer), 0},
     {"glReadPixels", offsetof(struct glfunctions, ReadPixels), M},
     {"glReleaseShaderCompiler", offsetof(struct glfunctions, ReleaseShaderCompiler), M},
@@ -153,8 +163,10 @@ static const struct gldefinition {
     {"glUniformMatrix2fv", offsetof(struct glfunctions, UniformMatrix2fv), M},
     {"glUniformMatrix3fv", offsetof(struct glfunctions, UniformMatrix3fv), M},
     {"glUniformMatrix4fv", offsetof(struct glfunctions, UniformMatrix4fv), M},
+    {"glUnmapBuffer", offsetof(struct glfunctions, UnmapBuffer), 0},
     {"glUseProgram", offsetof(struct glfunctions, UseProgram), M},
     {"glVertexAttribDivisor", offsetof(struct glfunctions, VertexAttribDivisor), 0},
+    {"glVertexAttribIPointer", offsetof(struct glfunctions, VertexAttribIPointer), 0},
     {"glVertexAttribPointer", offsetof(struct glfunctions, VertexAttribPointer), M},
     {"glViewport", offsetof(struct glfunctions, Viewport), M},
     {"glWaitSync", offsetof(struct glfunctions, WaitSync), 0},
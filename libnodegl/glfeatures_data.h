@@ -163,6 +163,7 @@ static const struct glfeature {
                                            OFFSET(UniformBlockBinding),
                                            OFFSET(GetActiveUniformBlockName),
                                            OFFSET(GetActiveUniformBlockiv),
+                                           OFFSET(GetActiveUniformsiv),
                                            -1}
     }, {
         .name           = "invalidate_subdata",
@@ -208,6 +209,7 @@ static const struct glfeature {
         .funcs_offsets  = (const size_t[]){OFFSET(FenceSync),
                                            OFFSET(ClientWaitSync),
                                            OFFSET(WaitSync),
+                                           OFFSET(DeleteSync),
                                            -1}
     }, {
         .name           = "yuv_target",
@@ -251,5 +253,14 @@ static const struct glfeature {
                                            OFFSET(Uniform3uiv),
                                            OFFSET(Uniform4uiv),
                                            -1}
+    }, {
+        .name           = "buffer_storage",
+        .flag           = NGLI_FEATURE_BUFFER_STORAGE,
+        .version        = 440,
+        .extensions     = (const char*[]){"GL_ARB_buffer_storage", NULL},
+        .funcs_offsets  = (const size_t[]){OFFSET(BufferStorage),
+                                           OFFSET(MapBufferRange),
+                                           OFFSET(UnmapBuffer),
+                                           -1}
     }
 };
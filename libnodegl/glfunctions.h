@@ -32,6 +32,7 @@ struct glfunctions {
     NGLI_GL_APIENTRY void (*BlendFuncSeparate)(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha);
     NGLI_GL_APIENTRY void (*BlitFramebuffer)(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
     NGLI_GL_APIENTRY void (*BufferData)(GLenum target, GLsizeiptr size, const void * data, GLenum usage);
+    NGLI_GL_APIENTRY void (*BufferStorage)(GLenum target, GLsizeiptr size, const void * data, GLbitfield flags);
     NGLI_GL_APIENTRY void (*BufferSubData)(GLenum target, GLintptr offset, GLsizeiptr size, const void * data);
     NGLI_GL_APIENTRY GLenum (*CheckFramebufferStatus)(GLenum target);
     NGLI_GL_APIENTRY void (*Clear)(GLbitfield mask);
@@ -49,6 +50,7 @@ struct glfunctions {
     NGLI_GL_APIENTRY void (*DeleteQueriesEXT)(GLsizei n, const GLuint * ids);
     NGLI_GL_APIENTRY void (*DeleteRenderbuffers)(GLsizei n, const GLuint * renderbuffers);
     NGLI_GL_APIENTRY void (*DeleteShader)(GLuint shader);
+    NGLI_GL_APIENTRY void (*DeleteSync)(GLsync sync);
     NGLI_GL_APIENTRY void (*DeleteTextures)(GLsizei n, const GLuint * textures);
     NGLI_GL_APIENTRY void (*DeleteVertexArrays)(GLsizei n, const GLuint * arrays);
     NGLI_GL_APIENTRY void (*DepthFunc)(GLenum func);
@@ -84,6 +86,7 @@ struct glfunctions {
     NGLI_GL_APIENTRY void (*GetActiveUniform)(GLuint program, GLuint index, GLsizei bufSize, GLsizei * length, GLint * size, GLenum * type, GLchar * name);
     NGLI_GL_APIENTRY void (*GetActiveUniformBlockName)(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei * length, GLchar * uniformBlockName);
     NGLI_GL_APIENTRY void (*GetActiveUniformBlockiv)(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint * params);
+    NGLI_GL_APIENTRY void (*GetActiveUniformsiv)(GLuint program, GLsizei uniformCount, const GLuint * uniformIndices, GLenum pname, GLint * params);
     NGLI_GL_APIENTRY void (*GetAttachedShaders)(GLuint program, GLsizei maxCount, GLsizei * count, GLuint * shaders);
     NGLI_GL_APIENTRY GLint (*GetAttribLocation)(GLuint program, const GLchar * name);
     NGLI_GL_APIENTRY void (*GetBooleanv)(GLenum pname, GLboolean * data);
@@ -91,6 +94,7 @@ struct glfunctions {
     NGLI_GL_APIENTRY void (*GetIntegeri_v)(GLenum target, GLuint index, GLint * data);
     NGLI_GL_APIENTRY void (*GetIntegerv)(GLenum pname, GLint * data);
     NGLI_GL_APIENTRY void (*GetInternalformativ)(GLenum target, GLenum internalformat, GLenum pname, GLsizei count, GLint * params);
+    NGLI_GL_APIENTRY void (*GetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei * length, GLenum * binaryFormat, void * binary);
     NGLI_GL_APIENTRY void (*GetProgramInfoLog)(GLuint program, GLsizei bufSize, GLsizei * length, GLchar * infoLog);
     NGLI_GL_APIENTRY void (*GetProgramInterfaceiv)(GLuint program, GLenum programInterface, GLenum pname, GLint * params);
     NGLI_GL_APIENTRY GLuint (*GetProgramResourceIndex)(GLuint program, GLenum programInterface, const GLchar * name);
@@ -111,9 +115,15 @@ struct glfunctions {
     NGLI_GL_APIENTRY void (*GetUniformiv)(GLuint program, GLint location, GLint * params);
     NGLI_GL_APIENTRY void (*InvalidateFramebuffer)(GLenum target, GLsizei numAttachments, const GLenum * attachments);
     NGLI_GL_APIENTRY void (*LinkProgram)(GLuint program);
+    NGLI_GL_APIENTRY void * (*MapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+    NGLI_GL_APIENTRY void (*MaxShaderCompilerThreadsKHR)(GLuint count);
     NGLI_GL_APIENTRY void (*MemoryBarrier)(GLbitfield barriers);
+    NGLI_GL_APIENTRY void (*MultiDrawArraysIndirect)(GLenum mode, const void * indirect, GLsizei drawcount, GLsizei stride);
+    NGLI_GL_APIENTRY void (*MultiDrawElementsIndirect)(GLenum mode, GLenum type, const void * indirect, GLsizei drawcount, GLsizei stride);
     NGLI_GL_APIENTRY void (*PixelStorei)(GLenum pname, GLint param);
     NGLI_GL_APIENTRY void (*PolygonMode)(GLenum face, GLenum mode);
+    NGLI_GL_APIENTRY void (*ProgramBinary)(GLuint program, GLenum binaryFormat, const void * binary, GLsizei length);
+    NGLI_GL_APIENTRY void (*ProgramParameteri)(GLuint program, GLenum pname, GLint value);
     NGLI_GL_APIENTRY void (*ReadBuffer)(GLenum src);
     NGLI_GL_APIENTRY void (*ReadPixels)(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void * pixels);
     NGLI_GL_APIENTRY void (*ReleaseShaderCompiler)();
@@ -152,8 +162,10 @@ struct glfunctions {
     NGLI_GL_APIENTRY void (*UniformMatrix2fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value);
     NGLI_GL_APIENTRY void (*UniformMatrix3fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value);
     NGLI_GL_APIENTRY void (*UniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value);
+    NGLI_GL_APIENTRY GLboolean (*UnmapBuffer)(GLenum target);
     NGLI_GL_APIENTRY void (*UseProgram)(GLuint program);
     NGLI_GL_APIENTRY void (*VertexAttribDivisor)(GLuint index, GLuint divisor);
+    NGLI_GL_APIENTRY void (*VertexAttribIPointer)(GLuint index, GLint size, GLenum type, GLsizei stride, const void * pointer);
     NGLI_GL_APIENTRY void (*VertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void * pointer);
     NGLI_GL_APIENTRY void (*Viewport)(GLint x, GLint y, GLsizei width, GLsizei height);
     NGLI_GL_APIENTRY void (*WaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
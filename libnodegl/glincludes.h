@@ -177,6 +177,7 @@ typedef void* GLeglImageOES;
 # define GL_FILL                               0x1B02
 # define GL_TEXTURE_3D                         0x806F
 # define GL_TEXTURE_WRAP_R                     0x8072
+# define GL_TEXTURE_BINDING_3D                 0x806A
 # define GL_MIN                                0x8007
 # define GL_MAX                                0x8008
 # define GL_DRAW_FRAMEBUFFER_BINDING           0x8CA6
@@ -189,6 +190,16 @@ typedef void* GLeglImageOES;
 # define GL_UNIFORM_BUFFER                     0x8A11
 # define GL_UNIFORM_BLOCK_BINDING              0x8A3F
 # define GL_MAX_UNIFORM_BLOCK_SIZE             0x8A30
+# define GL_UNIFORM_BLOCK_INDEX                0x8A3A
+# define GL_UNIFORM_OFFSET                     0x8A3B
+# define GL_UNIFORM_ARRAY_STRIDE               0x8A3C
+# define GL_UNIFORM_MATRIX_STRIDE              0x8A3D
+# define GL_UNIFORM_BLOCK_DATA_SIZE            0x8A40
+# define GL_UNIFORM_BUFFER_BINDING             0x8A28
+# define GL_UNIFORM_BUFFER_START               0x8A29
+# define GL_UNIFORM_BUFFER_SIZE                0x8A2A
+# define GL_MAX_UNIFORM_BUFFER_BINDINGS        0x8A2F
+# define GL_VERTEX_ARRAY_BINDING               0x85B5
 # define GL_TEXTURE_CUBE_MAP                   0x8513
 # define GL_TEXTURE_BINDING_CUBE_MAP           0x8514
 # define GL_TEXTURE_CUBE_MAP_POSITIVE_X        0x8515
@@ -198,6 +209,31 @@ typedef void* GLeglImageOES;
 # define GL_TEXTURE_CUBE_MAP_POSITIVE_Z        0x8519
 # define GL_TEXTURE_CUBE_MAP_NEGATIVE_Z        0x851A
 # define GL_TEXTURE_CUBE_MAP_SEAMLESS          0x884F
+# define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT    0x8A34
+# define GL_MAP_READ_BIT                       0x0001
+# define GL_MAP_WRITE_BIT                      0x0002
+# define GL_PIXEL_PACK_BUFFER                  0x88EB
+# define GL_SYNC_FLUSH_COMMANDS_BIT            0x00000001
+# define GL_ALREADY_SIGNALED                   0x911A
+# define GL_TIMEOUT_EXPIRED                    0x911B
+# define GL_CONDITION_SATISFIED                0x911C
+# define GL_WAIT_FAILED                        0x911D
+#endif
+
+#ifndef GL_MAP_PERSISTENT_BIT
+# define GL_MAP_PERSISTENT_BIT                 0x0040
+# define GL_MAP_COHERENT_BIT                   0x0080
+#endif
+
+#ifndef GL_DRAW_INDIRECT_BUFFER
+# define GL_DRAW_INDIRECT_BUFFER               0x8F3F
+# define GL_DRAW_INDIRECT_BUFFER_BINDING       0x8F43
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+# define GL_PROGRAM_BINARY_RETRIEVABLE_HINT    0x8257
+# define GL_PROGRAM_BINARY_LENGTH              0x8741
+# define GL_NUM_PROGRAM_BINARY_FORMATS         0x87FE
 #endif
 
 #if NGL_CS_COMPAT_INCLUDES
@@ -210,7 +246,9 @@ typedef void* GLeglImageOES;
 # define GL_SHADER_STORAGE_BUFFER_BINDING      0x90D3
 # define GL_SHADER_STORAGE_BUFFER_START        0x90D4
 # define GL_SHADER_STORAGE_BUFFER_SIZE         0x90D5
+# define GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS 0x90DD
 # define GL_SHADER_STORAGE_BLOCK               0x92E6
+# define GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT 0x90DF
 # define GL_BUFFER_BINDING                     0x9302
 # define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT    0x00000001
 # define GL_ELEMENT_ARRAY_BARRIER_BIT          0x00000002
@@ -25,7 +25,9 @@
 #include "glincludes.h"
 #include "glstate.h"
 #include "graphicstate.h"
+#include "log.h"
 #include "nodes.h"
+#include "utils.h"
 
 static const GLenum gl_blend_factor_map[NGLI_BLEND_FACTOR_NB] = {
     [NGLI_BLEND_FACTOR_ZERO]                = GL_ZERO,
@@ -101,7 +103,21 @@ static GLenum get_gl_cull_mode(int cull_mode)
     return gl_cull_mode_map[cull_mode];
 }
 
-void ngli_glstate_probe(const struct glcontext *gl, struct glstate *state)
+/* The element array buffer binding is recorded in the vertex array object */
+#define UNKNOWN_BINDING ((GLuint)-1)
+
+/* Transition from a registered render state to another */
+struct transition {
+    int id;
+    int changes;
+};
+
+struct render_state {
+    struct glstate_render_state state;
+    struct darray transitions; /* cached transitions from this state */
+};
+
+static void probe_render_state(const struct glcontext *gl, struct glstate_render_state *state)
 {
     /* Blend */
     ngli_glGetIntegerv(gl, GL_BLEND,                   (GLint *)&state->blend);
@@ -136,10 +152,181 @@ void ngli_glstate_probe(const struct glcontext *gl, struct glstate *state)
 
     /* Scissor */
     ngli_glGetBooleanv(gl, GL_SCISSOR_TEST,            &state->scissor_test);
+
+}
+
+static void probe_indexed_buffers(const struct glcontext *gl,
+                                  struct glstate_buffer_binding *bindings,
+                                  GLenum max_pname, GLenum binding_pname,
+                                  GLenum start_pname, GLenum size_pname)
+{
+    GLint nb_bindings = 0;
+    ngli_glGetIntegerv(gl, max_pname, &nb_bindings);
+    nb_bindings = NGLI_MIN(nb_bindings, NGLI_GLSTATE_MAX_BUFFER_BINDINGS);
+    for (int i = 0; i < nb_bindings; i++) {
+        GLint buffer, offset, size;
+        ngli_glGetIntegeri_v(gl, binding_pname, i, &buffer);
+        ngli_glGetIntegeri_v(gl, start_pname,   i, &offset);
+        ngli_glGetIntegeri_v(gl, size_pname,    i, &size);
+        bindings[i].buffer = buffer;
+        bindings[i].offset = offset;
+        bindings[i].size   = size;
+    }
+}
+
+static void probe_buffer_state(const struct glcontext *gl, struct glstate *state)
+{
+    ngli_glGetIntegerv(gl, GL_ARRAY_BUFFER_BINDING,         (GLint *)&state->array_buffer);
+    ngli_glGetIntegerv(gl, GL_ELEMENT_ARRAY_BUFFER_BINDING, (GLint *)&state->element_array_buffer);
+
+    if (gl->features & NGLI_FEATURE_UNIFORM_BUFFER_OBJECT) {
+        ngli_glGetIntegerv(gl, GL_UNIFORM_BUFFER_BINDING, (GLint *)&state->uniform_buffer);
+        probe_indexed_buffers(gl, state->uniform_buffers,
+                              GL_MAX_UNIFORM_BUFFER_BINDINGS, GL_UNIFORM_BUFFER_BINDING,
+                              GL_UNIFORM_BUFFER_START, GL_UNIFORM_BUFFER_SIZE);
+    }
+
+    if (gl->features & NGLI_FEATURE_SHADER_STORAGE_BUFFER_OBJECT) {
+        ngli_glGetIntegerv(gl, GL_SHADER_STORAGE_BUFFER_BINDING, (GLint *)&state->shader_storage_buffer);
+        probe_indexed_buffers(gl, state->shader_storage_buffers,
+                              GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, GL_SHADER_STORAGE_BUFFER_BINDING,
+                              GL_SHADER_STORAGE_BUFFER_START, GL_SHADER_STORAGE_BUFFER_SIZE);
+    }
+
+    if (gl->multi_draw_indirect)
+        ngli_glGetIntegerv(gl, GL_DRAW_INDIRECT_BUFFER_BINDING, (GLint *)&state->draw_indirect_buffer);
+
+    if (gl->features & NGLI_FEATURE_VERTEX_ARRAY_OBJECT)
+        ngli_glGetIntegerv(gl, GL_VERTEX_ARRAY_BINDING, (GLint *)&state->vertex_array);
+}
+
+void ngli_glstate_probe_framebuffer(const struct glcontext *gl, struct glstate *state)
+{
+    ngli_glGetIntegerv(gl, GL_DRAW_FRAMEBUFFER_BINDING, (GLint *)&state->draw_framebuffer);
+    if (gl->features & NGLI_FEATURE_FRAMEBUFFER_OBJECT)
+        ngli_glGetIntegerv(gl, GL_READ_FRAMEBUFFER_BINDING, (GLint *)&state->read_framebuffer);
+    else
+        state->read_framebuffer = state->draw_framebuffer;
+
+    ngli_glGetIntegerv(gl, GL_VIEWPORT,    state->viewport);
+    ngli_glGetIntegerv(gl, GL_SCISSOR_BOX, state->scissor);
 }
 
-static void init_state(struct glstate *s, const struct graphicstate *gc)
+void ngli_glstate_probe(const struct glcontext *gl, struct glstate *state)
 {
+    memset(state, 0, sizeof(*state));
+
+    probe_render_state(gl, &state->render);
+    state->render_state_id = -1;
+    ngli_darray_init(&state->render_states, sizeof(struct render_state), 0);
+
+    /* Texture bindings */
+    GLint active_texture;
+    ngli_glGetIntegerv(gl, GL_ACTIVE_TEXTURE, &active_texture);
+    state->active_texture = active_texture - GL_TEXTURE0;
+    state->texture_unit = state->active_texture;
+
+    probe_buffer_state(gl, state);
+    ngli_glstate_probe_framebuffer(gl, state);
+}
+
+#ifdef DEBUG_GLSTATE
+static const struct {
+    int index;
+    GLenum pname;
+    int features;
+} texture_binding_queries[] = {
+    {NGLI_GLSTATE_TEXTURE_TARGET_2D,           GL_TEXTURE_BINDING_2D,           0},
+    {NGLI_GLSTATE_TEXTURE_TARGET_3D,           GL_TEXTURE_BINDING_3D,           NGLI_FEATURE_TEXTURE_3D},
+    {NGLI_GLSTATE_TEXTURE_TARGET_CUBE_MAP,     GL_TEXTURE_BINDING_CUBE_MAP,     NGLI_FEATURE_TEXTURE_CUBE_MAP},
+    {NGLI_GLSTATE_TEXTURE_TARGET_EXTERNAL_OES, GL_TEXTURE_BINDING_EXTERNAL_OES, NGLI_FEATURE_OES_EGL_EXTERNAL_IMAGE},
+};
+
+static int check_binding(const char *name, int index, GLint cached, GLint probed)
+{
+    if (cached == probed)
+        return 0;
+    LOG(ERROR, "%s[%d] binding mismatch: %d in the shadow state, %d in the GL", name, index, cached, probed);
+    return -1;
+}
+
+static int check_indexed_buffers(const char *name,
+                                 const struct glstate_buffer_binding *cached,
+                                 const struct glstate_buffer_binding *probed)
+{
+    int ret = 0;
+    for (int i = 0; i < NGLI_GLSTATE_MAX_BUFFER_BINDINGS; i++) {
+        ret |= check_binding(name, i, cached[i].buffer, probed[i].buffer);
+        if (!cached[i].buffer)
+            continue;
+        ret |= check_binding(name, i, cached[i].offset, probed[i].offset);
+        ret |= check_binding(name, i, cached[i].size, probed[i].size);
+    }
+    return ret;
+}
+
+/*
+ * Verifies the shadow state against the actual GL state: any mismatch means
+ * some GL state has been altered without going through the glstate API.
+ */
+static void check_state(const struct glcontext *gl, const struct glstate *glstate)
+{
+    struct glstate probed;
+    ngli_glstate_probe(gl, &probed);
+
+    int ret = 0;
+    if (memcmp(&glstate->render, &probed.render, sizeof(probed.render))) {
+        LOG(ERROR, "render state mismatch");
+        ret = -1;
+    }
+
+    ret |= check_binding("active_texture", 0, glstate->active_texture, probed.active_texture);
+    const int nb_units = NGLI_MIN(gl->max_texture_image_units, NGLI_GLSTATE_MAX_TEXTURE_UNITS);
+    for (int i = 0; i < nb_units; i++) {
+        ngli_glActiveTexture(gl, GL_TEXTURE0 + i);
+        for (int j = 0; j < NGLI_ARRAY_NB(texture_binding_queries); j++) {
+            const int features = texture_binding_queries[j].features;
+            if ((gl->features & features) != features)
+                continue;
+            const int index = texture_binding_queries[j].index;
+            GLint texture;
+            ngli_glGetIntegerv(gl, texture_binding_queries[j].pname, &texture);
+            ret |= check_binding("texture", i, glstate->textures[i][index], texture);
+        }
+    }
+    ngli_glActiveTexture(gl, GL_TEXTURE0 + probed.active_texture);
+
+    ret |= check_binding("array_buffer", 0, glstate->array_buffer, probed.array_buffer);
+    if (glstate->element_array_buffer != UNKNOWN_BINDING)
+        ret |= check_binding("element_array_buffer", 0, glstate->element_array_buffer, probed.element_array_buffer);
+    ret |= check_binding("uniform_buffer", 0, glstate->uniform_buffer, probed.uniform_buffer);
+    ret |= check_binding("shader_storage_buffer", 0, glstate->shader_storage_buffer, probed.shader_storage_buffer);
+    ret |= check_binding("draw_indirect_buffer", 0, glstate->draw_indirect_buffer, probed.draw_indirect_buffer);
+    ret |= check_indexed_buffers("uniform_buffers", glstate->uniform_buffers, probed.uniform_buffers);
+    ret |= check_indexed_buffers("shader_storage_buffers", glstate->shader_storage_buffers, probed.shader_storage_buffers);
+    ret |= check_binding("draw_framebuffer", 0, glstate->draw_framebuffer, probed.draw_framebuffer);
+    ret |= check_binding("read_framebuffer", 0, glstate->read_framebuffer, probed.read_framebuffer);
+    ret |= check_binding("vertex_array", 0, glstate->vertex_array, probed.vertex_array);
+    if (memcmp(glstate->viewport, probed.viewport, sizeof(probed.viewport))) {
+        LOG(ERROR, "viewport mismatch");
+        ret = -1;
+    }
+    if (memcmp(glstate->scissor, probed.scissor, sizeof(probed.scissor))) {
+        LOG(ERROR, "scissor mismatch");
+        ret = -1;
+    }
+
+    ngli_assert(!ret);
+}
+# define CHECK_STATE(gl, glstate) check_state(gl, glstate)
+#else
+# define CHECK_STATE(gl, glstate)
+#endif
+
+static void init_state(struct glstate_render_state *s, const struct graphicstate *gc)
+{
+    memset(s, 0, sizeof(*s));
+
     s->blend              = gc->blend;
     s->blend_dst_factor   = get_gl_blend_factor(gc->blend_dst_factor);
     s->blend_src_factor   = get_gl_blend_factor(gc->blend_src_factor);
@@ -170,25 +357,98 @@ static void init_state(struct glstate *s, const struct graphicstate *gc)
     s->scissor_test = gc->scissor_test;
 }
 
-static int honor_state(const struct glcontext *gl,
-                       const struct glstate *next,
-                       const struct glstate *prev)
+enum {
+    CHANGE_BLEND          = 1 << 0,
+    CHANGE_BLEND_FUNC     = 1 << 1,
+    CHANGE_BLEND_EQUATION = 1 << 2,
+    CHANGE_COLOR_MASK     = 1 << 3,
+    CHANGE_DEPTH_TEST     = 1 << 4,
+    CHANGE_DEPTH_MASK     = 1 << 5,
+    CHANGE_DEPTH_FUNC     = 1 << 6,
+    CHANGE_STENCIL_TEST   = 1 << 7,
+    CHANGE_STENCIL_MASK   = 1 << 8,
+    CHANGE_STENCIL_FUNC   = 1 << 9,
+    CHANGE_STENCIL_OP     = 1 << 10,
+    CHANGE_CULL_FACE      = 1 << 11,
+    CHANGE_CULL_FACE_MODE = 1 << 12,
+    CHANGE_SCISSOR_TEST   = 1 << 13,
+};
+
+static int get_state_changes(const struct glstate_render_state *next,
+                             const struct glstate_render_state *prev)
 {
-    if (!memcmp(prev, next, sizeof(*prev)))
-        return 0;
+    int changes = 0;
 
-    /* Blend */
-    if (next->blend != prev->blend) {
-        if (next->blend)
-            ngli_glEnable(gl, GL_BLEND);
-        else
-            ngli_glDisable(gl, GL_BLEND);
-    }
+    if (next->blend != prev->blend)
+        changes |= CHANGE_BLEND;
 
     if (next->blend_dst_factor   != prev->blend_dst_factor   ||
         next->blend_src_factor   != prev->blend_src_factor   ||
         next->blend_dst_factor_a != prev->blend_dst_factor_a ||
-        next->blend_src_factor_a != prev->blend_src_factor_a) {
+        next->blend_src_factor_a != prev->blend_src_factor_a)
+        changes |= CHANGE_BLEND_FUNC;
+
+    if (next->blend_op   != prev->blend_op ||
+        next->blend_op_a != prev->blend_op_a)
+        changes |= CHANGE_BLEND_EQUATION;
+
+    if (memcmp(next->color_write_mask, prev->color_write_mask, sizeof(prev->color_write_mask)))
+        changes |= CHANGE_COLOR_MASK;
+
+    if (next->depth_test != prev->depth_test)
+        changes |= CHANGE_DEPTH_TEST;
+
+    if (next->depth_write_mask != prev->depth_write_mask)
+        changes |= CHANGE_DEPTH_MASK;
+
+    if (next->depth_func != prev->depth_func)
+        changes |= CHANGE_DEPTH_FUNC;
+
+    if (next->stencil_test != prev->stencil_test)
+        changes |= CHANGE_STENCIL_TEST;
+
+    if (next->stencil_write_mask != prev->stencil_write_mask)
+        changes |= CHANGE_STENCIL_MASK;
+
+    if (next->stencil_func      != prev->stencil_func ||
+        next->stencil_ref       != prev->stencil_ref  ||
+        next->stencil_read_mask != prev->stencil_read_mask)
+        changes |= CHANGE_STENCIL_FUNC;
+
+    if (next->stencil_fail       != prev->stencil_fail       ||
+        next->stencil_depth_fail != prev->stencil_depth_fail ||
+        next->stencil_depth_pass != prev->stencil_depth_pass)
+        changes |= CHANGE_STENCIL_OP;
+
+    if (next->cull_face != prev->cull_face)
+        changes |= CHANGE_CULL_FACE;
+
+    if (next->cull_face_mode != prev->cull_face_mode)
+        changes |= CHANGE_CULL_FACE_MODE;
+
+    if (next->scissor_test != prev->scissor_test)
+        changes |= CHANGE_SCISSOR_TEST;
+
+    return changes;
+}
+
+static void set_capability(const struct glcontext *gl, GLenum cap, int enable)
+{
+    if (enable)
+        ngli_glEnable(gl, cap);
+    else
+        ngli_glDisable(gl, cap);
+}
+
+static void honor_state(const struct glcontext *gl,
+                        const struct glstate_render_state *next,
+                        int changes)
+{
+    /* Blend */
+    if (changes & CHANGE_BLEND)
+        set_capability(gl, GL_BLEND, next->blend);
+
+    if (changes & CHANGE_BLEND_FUNC) {
         ngli_glBlendFuncSeparate(gl,
                                  next->blend_src_factor,
                                  next->blend_dst_factor,
@@ -196,15 +456,14 @@ static int honor_state(const struct glcontext *gl,
                                  next->blend_dst_factor_a);
     }
 
-    if (next->blend_op   != prev->blend_op ||
-        next->blend_op_a != prev->blend_op_a) {
+    if (changes & CHANGE_BLEND_EQUATION) {
         ngli_glBlendEquationSeparate(gl,
                                      next->blend_op,
                                      next->blend_op_a);
     }
 
     /* Color */
-    if (memcmp(next->color_write_mask, prev->color_write_mask, sizeof(prev->color_write_mask))) {
+    if (changes & CHANGE_COLOR_MASK) {
         ngli_glColorMask(gl,
                          next->color_write_mask[0],
                          next->color_write_mask[1],
@@ -213,45 +472,30 @@ static int honor_state(const struct glcontext *gl,
     }
 
     /* Depth */
-    if (next->depth_test != prev->depth_test) {
-        if (next->depth_test)
-            ngli_glEnable(gl, GL_DEPTH_TEST);
-        else
-            ngli_glDisable(gl, GL_DEPTH_TEST);
-    }
+    if (changes & CHANGE_DEPTH_TEST)
+        set_capability(gl, GL_DEPTH_TEST, next->depth_test);
 
-    if (next->depth_write_mask != prev->depth_write_mask) {
+    if (changes & CHANGE_DEPTH_MASK)
         ngli_glDepthMask(gl, next->depth_write_mask);
-    }
 
-    if (next->depth_func != prev->depth_func) {
+    if (changes & CHANGE_DEPTH_FUNC)
         ngli_glDepthFunc(gl, next->depth_func);
-    }
 
     /* Stencil */
-    if (next->stencil_test != prev->stencil_test) {
-        if (next->stencil_test)
-            ngli_glEnable(gl, GL_STENCIL_TEST);
-        else
-            ngli_glDisable(gl, GL_STENCIL_TEST);
-    }
+    if (changes & CHANGE_STENCIL_TEST)
+        set_capability(gl, GL_STENCIL_TEST, next->stencil_test);
 
-    if (next->stencil_write_mask != prev->stencil_write_mask) {
+    if (changes & CHANGE_STENCIL_MASK)
         ngli_glStencilMask(gl, next->stencil_write_mask);
-    }
 
-    if (next->stencil_func      != prev->stencil_func ||
-        next->stencil_ref       != prev->stencil_ref  ||
-        next->stencil_read_mask != prev->stencil_read_mask) {
+    if (changes & CHANGE_STENCIL_FUNC) {
         ngli_glStencilFunc(gl,
                            next->stencil_func,
                            next->stencil_ref,
                            next->stencil_read_mask);
     }
 
-    if (next->stencil_fail       != prev->stencil_fail       ||
-        next->stencil_depth_fail != prev->stencil_depth_fail ||
-        next->stencil_depth_pass != prev->stencil_depth_pass) {
+    if (changes & CHANGE_STENCIL_OP) {
         ngli_glStencilOp(gl,
                          next->stencil_fail,
                          next->stencil_depth_fail,
@@ -259,35 +503,328 @@ static int honor_state(const struct glcontext *gl,
     }
 
     /* Face Culling */
-    if (next->cull_face != prev->cull_face) {
-        if (next->cull_face)
-            ngli_glEnable(gl, GL_CULL_FACE);
-        else
-            ngli_glDisable(gl, GL_CULL_FACE);
-    }
+    if (changes & CHANGE_CULL_FACE)
+        set_capability(gl, GL_CULL_FACE, next->cull_face);
 
-    if (next->cull_face_mode != prev->cull_face_mode) {
+    if (changes & CHANGE_CULL_FACE_MODE)
         ngli_glCullFace(gl, next->cull_face_mode);
-    }
 
-    if (next->scissor_test != prev->scissor_test) {
-        if (next->scissor_test)
-            ngli_glEnable(gl, GL_SCISSOR_TEST);
-        else
-            ngli_glDisable(gl, GL_SCISSOR_TEST);
-    }
+    /* Scissor */
+    if (changes & CHANGE_SCISSOR_TEST)
+        set_capability(gl, GL_SCISSOR_TEST, next->scissor_test);
+}
+
+void ngli_glstate_reset(struct glstate *glstate)
+{
+    struct render_state *render_states = ngli_darray_data(&glstate->render_states);
+    for (int i = 0; i < ngli_darray_count(&glstate->render_states); i++)
+        ngli_darray_reset(&render_states[i].transitions);
+    ngli_darray_reset(&glstate->render_states);
+    glstate->render_state_id = -1;
+}
+
+/*
+ * Translates a graphic state into its GL counterpart once and for all and
+ * returns its identifier. Identical render states share the same identifier.
+ */
+int ngli_glstate_register_render_state(struct glstate *glstate, const struct graphicstate *state)
+{
+    struct glstate_render_state render_state;
+    init_state(&render_state, state);
 
-    return 1;
+    const struct render_state *render_states = ngli_darray_data(&glstate->render_states);
+    for (int i = 0; i < ngli_darray_count(&glstate->render_states); i++)
+        if (!memcmp(&render_states[i].state, &render_state, sizeof(render_state)))
+            return i;
+
+    struct render_state *entry = ngli_darray_push(&glstate->render_states, NULL);
+    if (!entry)
+        return NGL_ERROR_MEMORY;
+    memcpy(&entry->state, &render_state, sizeof(render_state));
+    ngli_darray_init(&entry->transitions, sizeof(struct transition), 0);
+
+    return ngli_darray_count(&glstate->render_states) - 1;
+}
+
+static int get_transition_changes(struct render_state *prev, int next_id, const struct render_state *next)
+{
+    const struct transition *transitions = ngli_darray_data(&prev->transitions);
+    for (int i = 0; i < ngli_darray_count(&prev->transitions); i++)
+        if (transitions[i].id == next_id)
+            return transitions[i].changes;
+
+    const struct transition transition = {
+        .id      = next_id,
+        .changes = get_state_changes(&next->state, &prev->state),
+    };
+    ngli_darray_push(&prev->transitions, &transition);
+    return transition.changes;
+}
+
+void ngli_glstate_use_render_state(const struct glcontext *gl, struct glstate *glstate, int id)
+{
+    const int prev_id = glstate->render_state_id;
+    if (prev_id == id)
+        return;
+
+    ngli_assert(id >= 0 && id < ngli_darray_count(&glstate->render_states));
+    struct render_state *render_states = ngli_darray_data(&glstate->render_states);
+    const struct render_state *next = &render_states[id];
+
+    const int changes = prev_id < 0 ? get_state_changes(&next->state, &glstate->render)
+                                    : get_transition_changes(&render_states[prev_id], id, next);
+    honor_state(gl, &next->state, changes);
+
+    memcpy(&glstate->render, &next->state, sizeof(glstate->render));
+    glstate->render_state_id = id;
+    CHECK_STATE(gl, glstate);
 }
 
 void ngli_glstate_update(struct ngl_ctx *ctx, const struct graphicstate *state)
 {
     struct glcontext *gl = ctx->glcontext;
+    struct glstate *glstate = &ctx->glstate;
 
-    struct glstate glstate = {0};
-    init_state(&glstate, state);
+    const int id = ngli_glstate_register_render_state(glstate, state);
+    if (id < 0) {
+        LOG(ERROR, "could not register render state");
+        return;
+    }
+    ngli_glstate_use_render_state(gl, glstate, id);
+}
+
+static int get_texture_target_index(GLenum target)
+{
+    switch (target) {
+    case GL_TEXTURE_2D:           return NGLI_GLSTATE_TEXTURE_TARGET_2D;
+    case GL_TEXTURE_3D:           return NGLI_GLSTATE_TEXTURE_TARGET_3D;
+    case GL_TEXTURE_CUBE_MAP:     return NGLI_GLSTATE_TEXTURE_TARGET_CUBE_MAP;
+    case GL_TEXTURE_RECTANGLE:    return NGLI_GLSTATE_TEXTURE_TARGET_RECTANGLE;
+    case GL_TEXTURE_EXTERNAL_OES: return NGLI_GLSTATE_TEXTURE_TARGET_EXTERNAL_OES;
+    }
+    ngli_assert(0);
+    return -1;
+}
+
+/*
+ * The texture unit switch is deferred to the next binding which actually
+ * needs to reach the GL.
+ */
+void ngli_glstate_active_texture(const struct glcontext *gl, struct glstate *glstate, int unit)
+{
+    ngli_assert(unit >= 0 && unit < NGLI_GLSTATE_MAX_TEXTURE_UNITS);
+    glstate->texture_unit = unit;
+}
+
+void ngli_glstate_bind_texture(const struct glcontext *gl, struct glstate *glstate, GLenum target, GLuint texture)
+{
+    const int unit = glstate->texture_unit;
+    const int target_index = get_texture_target_index(target);
+    GLuint *binding = &glstate->textures[unit][target_index];
+    /*
+     * The unit must be made active even if the binding is already in place
+     * since the caller may operate on the bound texture right after
+     * (glTexImage2D() and friends act on the active unit).
+     */
+    if (glstate->active_texture != unit) {
+        ngli_glActiveTexture(gl, GL_TEXTURE0 + unit);
+        glstate->active_texture = unit;
+    }
+    if (*binding == texture)
+        return;
+    ngli_glBindTexture(gl, target, texture);
+    *binding = texture;
+    CHECK_STATE(gl, glstate);
+}
+
+/*
+ * Must be called whenever a texture is destroyed (by us or by a third party
+ * such as the VideoToolbox texture cache) since its name can be recycled by
+ * the GL for a new texture.
+ */
+void ngli_glstate_invalidate_texture(struct glstate *glstate, GLuint texture)
+{
+    if (!texture)
+        return;
+    for (int i = 0; i < NGLI_GLSTATE_MAX_TEXTURE_UNITS; i++)
+        for (int j = 0; j < NGLI_GLSTATE_TEXTURE_TARGET_NB; j++)
+            if (glstate->textures[i][j] == texture)
+                glstate->textures[i][j] = 0;
+}
+
+static GLuint *get_buffer_binding(struct glstate *glstate, GLenum target)
+{
+    switch (target) {
+    case GL_ARRAY_BUFFER:          return &glstate->array_buffer;
+    case GL_ELEMENT_ARRAY_BUFFER:  return &glstate->element_array_buffer;
+    case GL_UNIFORM_BUFFER:        return &glstate->uniform_buffer;
+    case GL_SHADER_STORAGE_BUFFER: return &glstate->shader_storage_buffer;
+    case GL_DRAW_INDIRECT_BUFFER:  return &glstate->draw_indirect_buffer;
+    }
+    ngli_assert(0);
+    return NULL;
+}
 
-    int ret = honor_state(gl, &glstate, &ctx->glstate);
-    if (ret > 0)
-        ctx->glstate = glstate;
+static struct glstate_buffer_binding *get_indexed_buffer_bindings(struct glstate *glstate, GLenum target)
+{
+    switch (target) {
+    case GL_UNIFORM_BUFFER:        return glstate->uniform_buffers;
+    case GL_SHADER_STORAGE_BUFFER: return glstate->shader_storage_buffers;
+    }
+    ngli_assert(0);
+    return NULL;
+}
+
+void ngli_glstate_bind_buffer(const struct glcontext *gl, struct glstate *glstate, GLenum target, GLuint buffer)
+{
+    GLuint *binding = get_buffer_binding(glstate, target);
+    if (*binding == buffer)
+        return;
+    ngli_glBindBuffer(gl, target, buffer);
+    *binding = buffer;
+    CHECK_STATE(gl, glstate);
+}
+
+static void bind_indexed_buffer(const struct glcontext *gl, struct glstate *glstate,
+                                GLenum target, GLuint index, GLuint buffer,
+                                GLintptr offset, GLsizeiptr size)
+{
+    struct glstate_buffer_binding *bindings = get_indexed_buffer_bindings(glstate, target);
+    const int cached = index < NGLI_GLSTATE_MAX_BUFFER_BINDINGS;
+    if (cached) {
+        const struct glstate_buffer_binding *binding = &bindings[index];
+        if (binding->buffer == buffer && binding->offset == offset && binding->size == size)
+            return;
+    }
+
+    if (size)
+        ngli_glBindBufferRange(gl, target, index, buffer, offset, size);
+    else
+        ngli_glBindBufferBase(gl, target, index, buffer);
+
+    if (cached) {
+        bindings[index].buffer = buffer;
+        bindings[index].offset = offset;
+        bindings[index].size   = size;
+    }
+
+    /* Indexed bindings also bind the buffer to the generic binding point */
+    *get_buffer_binding(glstate, target) = buffer;
+    CHECK_STATE(gl, glstate);
+}
+
+void ngli_glstate_bind_buffer_base(const struct glcontext *gl, struct glstate *glstate,
+                                   GLenum target, GLuint index, GLuint buffer)
+{
+    bind_indexed_buffer(gl, glstate, target, index, buffer, 0, 0);
+}
+
+void ngli_glstate_bind_buffer_range(const struct glcontext *gl, struct glstate *glstate,
+                                    GLenum target, GLuint index, GLuint buffer,
+                                    GLintptr offset, GLsizeiptr size)
+{
+    ngli_assert(size > 0);
+    bind_indexed_buffer(gl, glstate, target, index, buffer, offset, size);
+}
+
+static void invalidate_indexed_buffers(struct glstate_buffer_binding *bindings, GLuint buffer)
+{
+    for (int i = 0; i < NGLI_GLSTATE_MAX_BUFFER_BINDINGS; i++)
+        if (bindings[i].buffer == buffer)
+            memset(&bindings[i], 0, sizeof(bindings[i]));
+}
+
+/*
+ * Must be called whenever a buffer is deleted: the GL resets all the
+ * bindings referencing it in the current context.
+ */
+void ngli_glstate_invalidate_buffer(struct glstate *glstate, GLuint buffer)
+{
+    if (!buffer)
+        return;
+    GLuint *bindings[] = {
+        &glstate->array_buffer,
+        &glstate->element_array_buffer,
+        &glstate->uniform_buffer,
+        &glstate->shader_storage_buffer,
+        &glstate->draw_indirect_buffer,
+    };
+    for (int i = 0; i < NGLI_ARRAY_NB(bindings); i++)
+        if (*bindings[i] == buffer)
+            *bindings[i] = 0;
+    invalidate_indexed_buffers(glstate->uniform_buffers, buffer);
+    invalidate_indexed_buffers(glstate->shader_storage_buffers, buffer);
+}
+
+void ngli_glstate_bind_framebuffer(const struct glcontext *gl, struct glstate *glstate, GLenum target, GLuint framebuffer)
+{
+    switch (target) {
+    case GL_FRAMEBUFFER:
+        if (glstate->draw_framebuffer == framebuffer &&
+            glstate->read_framebuffer == framebuffer)
+            return;
+        glstate->draw_framebuffer = framebuffer;
+        glstate->read_framebuffer = framebuffer;
+        break;
+    case GL_DRAW_FRAMEBUFFER:
+        if (glstate->draw_framebuffer == framebuffer)
+            return;
+        glstate->draw_framebuffer = framebuffer;
+        break;
+    case GL_READ_FRAMEBUFFER:
+        if (glstate->read_framebuffer == framebuffer)
+            return;
+        glstate->read_framebuffer = framebuffer;
+        break;
+    default:
+        ngli_assert(0);
+    }
+    ngli_glBindFramebuffer(gl, target, framebuffer);
+    CHECK_STATE(gl, glstate);
+}
+
+void ngli_glstate_invalidate_framebuffer(struct glstate *glstate, GLuint framebuffer)
+{
+    if (!framebuffer)
+        return;
+    if (glstate->draw_framebuffer == framebuffer)
+        glstate->draw_framebuffer = 0;
+    if (glstate->read_framebuffer == framebuffer)
+        glstate->read_framebuffer = 0;
+}
+
+void ngli_glstate_bind_vertex_array(const struct glcontext *gl, struct glstate *glstate, GLuint vertex_array)
+{
+    if (glstate->vertex_array == vertex_array)
+        return;
+    ngli_glBindVertexArray(gl, vertex_array);
+    glstate->vertex_array = vertex_array;
+    glstate->element_array_buffer = UNKNOWN_BINDING;
+    CHECK_STATE(gl, glstate);
+}
+
+void ngli_glstate_invalidate_vertex_array(struct glstate *glstate, GLuint vertex_array)
+{
+    if (!vertex_array || glstate->vertex_array != vertex_array)
+        return;
+    glstate->vertex_array = 0;
+    glstate->element_array_buffer = UNKNOWN_BINDING;
+}
+
+void ngli_glstate_viewport(const struct glcontext *gl, struct glstate *glstate, const GLint *viewport)
+{
+    if (!memcmp(glstate->viewport, viewport, sizeof(glstate->viewport)))
+        return;
+    ngli_glViewport(gl, viewport[0], viewport[1], viewport[2], viewport[3]);
+    memcpy(glstate->viewport, viewport, sizeof(glstate->viewport));
+    CHECK_STATE(gl, glstate);
+}
+
+void ngli_glstate_scissor(const struct glcontext *gl, struct glstate *glstate, const GLint *scissor)
+{
+    if (!memcmp(glstate->scissor, scissor, sizeof(glstate->scissor)))
+        return;
+    ngli_glScissor(gl, scissor[0], scissor[1], scissor[2], scissor[3]);
+    memcpy(glstate->scissor, scissor, sizeof(glstate->scissor));
+    CHECK_STATE(gl, glstate);
 }
@@ -22,11 +22,30 @@
 #ifndef GLSTATE_H
 #define GLSTATE_H
 
+#include "darray.h"
 #include "glcontext.h"
 #include "glincludes.h"
 #include "graphicstate.h"
 
-struct glstate {
+#define NGLI_GLSTATE_MAX_TEXTURE_UNITS 64
+#define NGLI_GLSTATE_MAX_BUFFER_BINDINGS 64
+
+enum {
+    NGLI_GLSTATE_TEXTURE_TARGET_2D,
+    NGLI_GLSTATE_TEXTURE_TARGET_3D,
+    NGLI_GLSTATE_TEXTURE_TARGET_CUBE_MAP,
+    NGLI_GLSTATE_TEXTURE_TARGET_RECTANGLE,
+    NGLI_GLSTATE_TEXTURE_TARGET_EXTERNAL_OES,
+    NGLI_GLSTATE_TEXTURE_TARGET_NB
+};
+
+struct glstate_buffer_binding {
+    GLuint buffer;
+    GLintptr offset;
+    GLsizeiptr size; /* 0 if the whole buffer is bound */
+};
+
+struct glstate_render_state {
     GLenum blend;
     GLenum blend_dst_factor;
     GLenum blend_src_factor;
@@ -56,10 +75,109 @@ struct glstate {
     GLboolean scissor_test;
 };
 
+struct glstate {
+    /* Render state */
+    struct glstate_render_state render;
+    int render_state_id;        /* registered render state currently applied, -1 if unknown */
+    struct darray render_states;
+
+    /* Texture bindings */
+    int active_texture;     /* texture unit currently active in the GL */
+    int texture_unit;       /* texture unit selected for the next bindings */
+    GLuint textures[NGLI_GLSTATE_MAX_TEXTURE_UNITS][NGLI_GLSTATE_TEXTURE_TARGET_NB];
+
+    /* Buffer bindings */
+    GLuint array_buffer;
+    GLuint element_array_buffer; /* part of the vertex array state */
+    GLuint uniform_buffer;
+    GLuint shader_storage_buffer;
+    GLuint draw_indirect_buffer;
+    struct glstate_buffer_binding uniform_buffers[NGLI_GLSTATE_MAX_BUFFER_BINDINGS];
+    struct glstate_buffer_binding shader_storage_buffers[NGLI_GLSTATE_MAX_BUFFER_BINDINGS];
+
+    /* Framebuffer and vertex array bindings */
+    GLuint draw_framebuffer;
+    GLuint read_framebuffer;
+    GLuint vertex_array;
+
+    /* Viewport and scissor */
+    GLint viewport[4];
+    GLint scissor[4];
+};
+
 void ngli_glstate_probe(const struct glcontext *gl,
                         struct glstate *glstate);
 
+void ngli_glstate_probe_framebuffer(const struct glcontext *gl,
+                                    struct glstate *glstate);
+
+void ngli_glstate_reset(struct glstate *glstate);
+
+int ngli_glstate_register_render_state(struct glstate *glstate,
+                                       const struct graphicstate *state);
+
+void ngli_glstate_use_render_state(const struct glcontext *gl,
+                                   struct glstate *glstate,
+                                   int id);
+
 void ngli_glstate_update(struct ngl_ctx *ctx,
                          const struct graphicstate *state);
 
+void ngli_glstate_active_texture(const struct glcontext *gl,
+                                 struct glstate *glstate,
+                                 int unit);
+
+void ngli_glstate_bind_texture(const struct glcontext *gl,
+                               struct glstate *glstate,
+                               GLenum target,
+                               GLuint texture);
+
+void ngli_glstate_invalidate_texture(struct glstate *glstate,
+                                     GLuint texture);
+
+void ngli_glstate_bind_buffer(const struct glcontext *gl,
+                              struct glstate *glstate,
+                              GLenum target,
+                              GLuint buffer);
+
+void ngli_glstate_bind_buffer_base(const struct glcontext *gl,
+                                   struct glstate *glstate,
+                                   GLenum target,
+                                   GLuint index,
+                                   GLuint buffer);
+
+void ngli_glstate_bind_buffer_range(const struct glcontext *gl,
+                                    struct glstate *glstate,
+                                    GLenum target,
+                                    GLuint index,
+                                    GLuint buffer,
+                                    GLintptr offset,
+                                    GLsizeiptr size);
+
+void ngli_glstate_invalidate_buffer(struct glstate *glstate,
+                                    GLuint buffer);
+
+void ngli_glstate_bind_framebuffer(const struct glcontext *gl,
+                                   struct glstate *glstate,
+                                   GLenum target,
+                                   GLuint framebuffer);
+
+void ngli_glstate_invalidate_framebuffer(struct glstate *glstate,
+                                         GLuint framebuffer);
+
+void ngli_glstate_bind_vertex_array(const struct glcontext *gl,
+                                    struct glstate *glstate,
+                                    GLuint vertex_array);
+
+void ngli_glstate_invalidate_vertex_array(struct glstate *glstate,
+                                          GLuint vertex_array);
+
+void ngli_glstate_viewport(const struct glcontext *gl,
+                           struct glstate *glstate,
+                           const GLint *viewport);
+
+void ngli_glstate_scissor(const struct glcontext *gl,
+                          struct glstate *glstate,
+                          const GLint *scissor);
+
 #endif
@@ -128,6 +128,12 @@ static inline void ngli_glBufferData(const struct glcontext *gl, GLenum target,
     check_error_code(gl, "glBufferData");
 }
 
+static inline void ngli_glBufferStorage(const struct glcontext *gl, GLenum target, GLsizeiptr size, const void * data, GLbitfield flags)
+{
+    gl->funcs.BufferStorage(target, size, data, flags);
+    check_error_code(gl, "glBufferStorage");
+}
+
 static inline void ngli_glBufferSubData(const struct glcontext *gl, GLenum target, GLintptr offset, GLsizeiptr size, const void * data)
 {
     gl->funcs.BufferSubData(target, offset, size, data);
@@ -234,6 +240,12 @@ static inline void ngli_glDeleteShader(const struct glcontext *gl, GLuint shader
     check_error_code(gl, "glDeleteShader");
 }
 
+static inline void ngli_glDeleteSync(const struct glcontext *gl, GLsync sync)
+{
+    gl->funcs.DeleteSync(sync);
+    check_error_code(gl, "glDeleteSync");
+}
+
 static inline void ngli_glDeleteTextures(const struct glcontext *gl, GLsizei n, const GLuint * textures)
 {
     gl->funcs.DeleteTextures(n, textures);
@@ -445,6 +457,12 @@ static inline void ngli_glGetActiveUniformBlockiv(const struct glcontext *gl, GL
     check_error_code(gl, "glGetActiveUniformBlockiv");
 }
 
+static inline void ngli_glGetActiveUniformsiv(const struct glcontext *gl, GLuint program, GLsizei uniformCount, const GLuint * uniformIndices, GLenum pname, GLint * params)
+{
+    gl->funcs.GetActiveUniformsiv(program, uniformCount, uniformIndices, pname, params);
+    check_error_code(gl, "glGetActiveUniformsiv");
+}
+
 static inline void ngli_glGetAttachedShaders(const struct glcontext *gl, GLuint program, GLsizei maxCount, GLsizei * count, GLuint * shaders)
 {
     gl->funcs.GetAttachedShaders(program, maxCount, count, shaders);
@@ -487,6 +505,12 @@ static inline void ngli_glGetInternalformativ(const struct glcontext *gl, GLenum
     check_error_code(gl, "glGetInternalformativ");
 }
 
+static inline void ngli_glGetProgramBinary(const struct glcontext *gl, GLuint program, GLsizei bufSize, GLsizei * length, GLenum * binaryFormat, void * binary)
+{
+    gl->funcs.GetProgramBinary(program, bufSize, length, binaryFormat, binary);
+    check_error_code(gl, "glGetProgramBinary");
+}
+
 static inline void ngli_glGetProgramInfoLog(const struct glcontext *gl, GLuint program, GLsizei bufSize, GLsizei * length, GLchar * infoLog)
 {
     gl->funcs.GetProgramInfoLog(program, bufSize, length, infoLog);
@@ -613,12 +637,37 @@ static inline void ngli_glLinkProgram(const struct glcontext *gl, GLuint program
     check_error_code(gl, "glLinkProgram");
 }
 
+static inline void * ngli_glMapBufferRange(const struct glcontext *gl, GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    void * ret = gl->funcs.MapBufferRange(target, offset, length, access);
+    check_error_code(gl, "glMapBufferRange");
+    return ret;
+}
+
+static inline void ngli_glMaxShaderCompilerThreadsKHR(const struct glcontext *gl, GLuint count)
+{
+    gl->funcs.MaxShaderCompilerThreadsKHR(count);
+    check_error_code(gl, "glMaxShaderCompilerThreadsKHR");
+}
+
 static inline void ngli_glMemoryBarrier(const struct glcontext *gl, GLbitfield barriers)
 {
     gl->funcs.MemoryBarrier(barriers);
     check_error_code(gl, "glMemoryBarrier");
 }
 
+static inline void ngli_glMultiDrawArraysIndirect(const struct glcontext *gl, GLenum mode, const void * indirect, GLsizei drawcount, GLsizei stride)
+{
+    gl->funcs.MultiDrawArraysIndirect(mode, indirect, drawcount, stride);
+    check_error_code(gl, "glMultiDrawArraysIndirect");
+}
+
+static inline void ngli_glMultiDrawElementsIndirect(const struct glcontext *gl, GLenum mode, GLenum type, const void * indirect, GLsizei drawcount, GLsizei stride)
+{
+    gl->funcs.MultiDrawElementsIndirect(mode, type, indirect, drawcount, stride);
+    check_error_code(gl, "glMultiDrawElementsIndirect");
+}
+
 static inline void ngli_glPixelStorei(const struct glcontext *gl, GLenum pname, GLint param)
 {
     gl->funcs.PixelStorei(pname, param);
@@ -631,6 +680,18 @@ static inline void ngli_glPolygonMode(const struct glcontext *gl, GLenum face, G
     check_error_code(gl, "glPolygonMode");
 }
 
+static inline void ngli_glProgramBinary(const struct glcontext *gl, GLuint program, GLenum binaryFormat, const void * binary, GLsizei length)
+{
+    gl->funcs.ProgramBinary(program, binaryFormat, binary, length);
+    check_error_code(gl, "glProgramBinary");
+}
+
+static inline void ngli_glProgramParameteri(const struct glcontext *gl, GLuint program, GLenum pname, GLint value)
+{
+    gl->funcs.ProgramParameteri(program, pname, value);
+    check_error_code(gl, "glProgramParameteri");
+}
+
 static inline void ngli_glReadBuffer(const struct glcontext *gl, GLenum src)
 {
     gl->funcs.ReadBuffer(src);
@@ -859,6 +920,13 @@ static inline void ngli_glUniformMatrix4fv(const struct glcontext *gl, GLint loc
     check_error_code(gl, "glUniformMatrix4fv");
 }
 
+static inline GLboolean ngli_glUnmapBuffer(const struct glcontext *gl, GLenum target)
+{
+    GLboolean ret = gl->funcs.UnmapBuffer(target);
+    check_error_code(gl, "glUnmapBuffer");
+    return ret;
+}
+
 static inline void ngli_glUseProgram(const struct glcontext *gl, GLuint program)
 {
     gl->funcs.UseProgram(program);
@@ -871,6 +939,12 @@ static inline void ngli_glVertexAttribDivisor(const struct glcontext *gl, GLuint
     check_error_code(gl, "glVertexAttribDivisor");
 }
 
+static inline void ngli_glVertexAttribIPointer(const struct glcontext *gl, GLuint index, GLint size, GLenum type, GLsizei stride, const void * pointer)
+{
+    gl->funcs.VertexAttribIPointer(index, size, type, stride, pointer);
+    check_error_code(gl, "glVertexAttribIPointer");
+}
+
 static inline void ngli_glVertexAttribPointer(const struct glcontext *gl, GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void * pointer)
 {
     gl->funcs.VertexAttribPointer(index, size, type, normalized, stride, pointer);
@@ -134,6 +134,38 @@ static const struct hwconv_desc {
     },
 };
 
+static int is_supported_layout(enum image_layout layout)
+{
+    return layout == NGLI_IMAGE_LAYOUT_NV12 ||
+           layout == NGLI_IMAGE_LAYOUT_NV12_RECTANGLE ||
+           layout == NGLI_IMAGE_LAYOUT_MEDIACODEC;
+}
+
+static char *get_fragment_data(const struct glcontext *gl, const struct hwconv_desc *desc)
+{
+    const char *uv = gl->version < 300 ? "ra": "rg";
+    return ngli_asprintf(desc->fragment_data, uv);
+}
+
+/*
+ * Submit the conversion program of the specified layout ahead of the first
+ * frame which needs it
+ */
+int ngli_hwconv_prefetch_program(struct ngl_ctx *ctx, enum image_layout src_layout)
+{
+    if (!is_supported_layout(src_layout))
+        return NGL_ERROR_UNSUPPORTED;
+    const struct hwconv_desc *desc = &hwconv_descs[src_layout];
+
+    char *fragment_data = get_fragment_data(ctx->glcontext, desc);
+    if (!fragment_data)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngli_pgcache_prefetch_graphics_program(&ctx->pgcache, desc->vertex_data, fragment_data);
+    ngli_free(fragment_data);
+    return ret;
+}
+
 int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
                      const struct image *dst_image,
                      const struct image_params *src_params)
@@ -166,16 +198,13 @@ int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
         return ret;
 
     enum image_layout src_layout = src_params->layout;
-    if (src_layout != NGLI_IMAGE_LAYOUT_NV12 &&
-        src_layout != NGLI_IMAGE_LAYOUT_NV12_RECTANGLE &&
-        src_layout != NGLI_IMAGE_LAYOUT_MEDIACODEC) {
+    if (!is_supported_layout(src_layout)) {
         LOG(ERROR, "unsupported texture layout: 0x%x", src_layout);
         return NGL_ERROR_UNSUPPORTED;
     }
     const struct hwconv_desc *desc = &hwconv_descs[src_layout];
 
-    const char *uv = gl->version < 300 ? "ra": "rg";
-    char *fragment_data = ngli_asprintf(desc->fragment_data, uv);
+    char *fragment_data = get_fragment_data(gl, desc);
     if (!fragment_data)
         return NGL_ERROR_MEMORY;
 
@@ -194,7 +223,7 @@ int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
     if (ret < 0)
         return ret;
 
-    ret = ngli_buffer_upload(&hwconv->vertices, vertices, sizeof(vertices));
+    ret = ngli_buffer_upload(&hwconv->vertices, vertices, sizeof(vertices), 0);
     if (ret < 0)
         return ret;
 
@@ -295,12 +324,12 @@ int ngli_hwconv_convert_image(struct hwconv *hwconv, const struct image *image)
     ngli_pipeline_update_uniform(&hwconv->pipeline, hwconv->tex_coord_matrix_index, image->coordinates_matrix);
     ngli_pipeline_update_uniform(&hwconv->pipeline, hwconv->tex_dimensions_index, dimensions);
 
-    ngli_pipeline_exec(&hwconv->pipeline);
+    int ret = ngli_pipeline_exec(&hwconv->pipeline);
 
     ngli_gctx_set_rendertarget(ctx, prev_rt);
     ngli_gctx_set_viewport(ctx, prev_vp);
 
-    return 0;
+    return ret;
 }
 
 void ngli_hwconv_reset(struct hwconv *hwconv)
@@ -46,6 +46,7 @@ struct hwconv {
     int tex_dimensions_index;
 };
 
+int ngli_hwconv_prefetch_program(struct ngl_ctx *ctx, enum image_layout src_layout);
 int ngli_hwconv_init(struct hwconv *hwconv, struct ngl_ctx *ctx,
                      const struct image *dst_image,
                      const struct image_params *src_params);
@@ -191,6 +191,28 @@ end:
     return ret;
 }
 
+/*
+ * Prepare the conversion program required by the frames of the platform
+ * hardware decoder if the texture can not use them directly
+ */
+int ngli_hwupload_warmup(struct ngl_node *node)
+{
+    struct texture_priv *s = node->priv_data;
+
+    enum image_layout layout = NGLI_IMAGE_LAYOUT_NONE;
+#if defined(TARGET_ANDROID)
+    layout = NGLI_IMAGE_LAYOUT_MEDIACODEC;
+#elif defined(TARGET_DARWIN)
+    layout = NGLI_IMAGE_LAYOUT_NV12_RECTANGLE;
+#elif defined(TARGET_IPHONE) || defined(HAVE_VAAPI)
+    layout = NGLI_IMAGE_LAYOUT_NV12;
+#endif
+    if (layout == NGLI_IMAGE_LAYOUT_NONE || (s->supported_image_layouts & (1 << layout)))
+        return 0;
+
+    return ngli_hwconv_prefetch_program(node->ctx, layout);
+}
+
 void ngli_hwupload_uninit(struct ngl_node *node)
 {
     struct texture_priv *s = node->priv_data;
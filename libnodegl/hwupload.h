@@ -50,6 +50,7 @@ struct hwupload {
 };
 
 int ngli_hwupload_upload_frame(struct ngl_node *node);
+int ngli_hwupload_warmup(struct ngl_node *node);
 void ngli_hwupload_uninit(struct ngl_node *node);
 
 #endif /* HWUPLOAD_H */
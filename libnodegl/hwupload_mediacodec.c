@@ -72,10 +72,10 @@ static int mc_init(struct ngl_node *node, struct sxplayer_frame *frame)
     const GLint min_filter = ngli_texture_get_gl_min_filter(params->min_filter, params->mipmap_filter);
     const GLint mag_filter = ngli_texture_get_gl_mag_filter(params->mag_filter);
 
-    ngli_glBindTexture(gl, target, id);
+    ngli_glstate_bind_texture(gl, &ctx->glstate, target, id);
     ngli_glTexParameteri(gl, target, GL_TEXTURE_MIN_FILTER, min_filter);
     ngli_glTexParameteri(gl, target, GL_TEXTURE_MAG_FILTER, mag_filter);
-    ngli_glBindTexture(gl, target, 0);
+    ngli_glstate_bind_texture(gl, &ctx->glstate, target, 0);
 
     struct image_params image_params = {
         .width = frame->width,
@@ -245,7 +245,7 @@ static int vaapi_map_frame(struct ngl_node *node, struct sxplayer_frame *frame)
         struct texture *plane = &vaapi->planes[i];
         ngli_texture_set_dimensions(plane, width, height, 0);
 
-        ngli_glBindTexture(gl, plane->target, plane->id);
+        ngli_glstate_bind_texture(gl, &ctx->glstate, plane->target, plane->id);
         ngli_glEGLImageTargetTexture2DOES(gl, plane->target, vaapi->egl_images[i]);
     }
 
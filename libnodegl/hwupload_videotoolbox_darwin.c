@@ -69,7 +69,7 @@ static int vt_darwin_map_frame(struct ngl_node *node, struct sxplayer_frame *fra
     for (int i = 0; i < 2; i++) {
         struct texture *plane = &vt->planes[i];
 
-        ngli_glBindTexture(gl, plane->target, plane->id);
+        ngli_glstate_bind_texture(gl, &ctx->glstate, plane->target, plane->id);
 
         int width = IOSurfaceGetWidthOfPlane(surface, i);
         int height = IOSurfaceGetHeightOfPlane(surface, i);
@@ -83,7 +83,7 @@ static int vt_darwin_map_frame(struct ngl_node *node, struct sxplayer_frame *fra
             return -1;
         }
 
-        ngli_glBindTexture(gl, GL_TEXTURE_RECTANGLE, 0);
+        ngli_glstate_bind_texture(gl, &ctx->glstate, GL_TEXTURE_RECTANGLE, 0);
     }
 
     return 0;
@@ -214,7 +214,7 @@ void ngli_mat3_adjugate(float *dst, const float* m)
     memcpy(dst, tmp, sizeof(tmp));
 }
 
-void ngli_mat3_inverse(float *dst, const float *m)
+void ngli_mat3_inverse_c(float *dst, const float *m)
 {
     float a[3*3];
     float det = ngli_mat3_determinant(m);
@@ -453,7 +453,7 @@ void ngli_mat4_scale(float *dst, float x, float y, float z)
 
 #define COS_ALPHA_THRESHOLD 0.9995f
 
-void ngli_quat_slerp(float *dst, const float *q1, const float *q2, float t)
+void ngli_quat_slerp_c(float *dst, const float *q1, const float *q2, float t)
 {
     float tmp_q1[4];
     const float *tmp_q1p = q1;
@@ -491,3 +491,10 @@ void ngli_quat_slerp(float *dst, const float *q1, const float *q2, float t)
     ngli_vec4_scale(tmp2, tmp, sin(theta));
     ngli_vec4_add(dst, tmp1, tmp2);
 }
+
+void ngli_math_utils_init(void)
+{
+#if defined(ARCH_X86_64)
+    ngli_math_utils_init_x86_64();
+#endif
+}
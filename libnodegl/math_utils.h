@@ -49,7 +49,7 @@ void ngli_mat3_mul_scalar(float *dst, const float *m, float s);
 void ngli_mat3_transpose(float *dst, const float *m);
 float ngli_mat3_determinant(const float *m);
 void ngli_mat3_adjugate(float *dst, const float* m);
-void ngli_mat3_inverse(float *dst, const float *m);
+void ngli_mat3_inverse_c(float *dst, const float *m);
 
 #define NGLI_MAT4_IDENTITY {1.0f, 0.0f, 0.0f, 0.0f, \
                             0.0f, 1.0f, 0.0f, 0.0f, \
@@ -67,21 +67,46 @@ void ngli_mat4_rotate_from_quat(float *dst, const float *quat);
 void ngli_mat4_translate(float *dst, float x, float y, float z);
 void ngli_mat4_scale(float *dst, float x, float y, float z);
 
+#define NGLI_QUAT_IDENTITY {0.0f, 0.0f, 0.0f, 1.0f}
+
+void ngli_quat_slerp_c(float *dst, const float *q1, const float *q2, float t);
+
+/*
+ * Select the arch specific versions depending on the CPU features, once for
+ * the whole library (the baseline versions are used until then)
+ */
+void ngli_math_utils_init(void);
+
 /* Arch specific versions */
 
-#ifdef ARCH_AARCH64
+#if defined(ARCH_AARCH64)
+# define ngli_mat3_inverse      ngli_mat3_inverse_c
 # define ngli_mat4_mul          ngli_mat4_mul_aarch64
 # define ngli_mat4_mul_vec4     ngli_mat4_mul_vec4_aarch64
+# define ngli_quat_slerp        ngli_quat_slerp_c
+#elif defined(ARCH_X86_64)
+# define ngli_mat3_inverse      ngli_mat3_inverse_sse
+# define ngli_mat4_mul          ngli_mat4_mul_x86_64
+# define ngli_mat4_mul_vec4     ngli_mat4_mul_vec4_sse
+# define ngli_quat_slerp        ngli_quat_slerp_sse
 #else
+# define ngli_mat3_inverse      ngli_mat3_inverse_c
 # define ngli_mat4_mul          ngli_mat4_mul_c
 # define ngli_mat4_mul_vec4     ngli_mat4_mul_vec4_c
+# define ngli_quat_slerp        ngli_quat_slerp_c
 #endif
 
 void ngli_mat4_mul_aarch64(float *dst, const float *m1, const float *m2);
 void ngli_mat4_mul_vec4_aarch64(float *dst, const float *m, const float *v);
 
-#define NGLI_QUAT_IDENTITY {0.0f, 0.0f, 0.0f, 1.0f}
-
-void ngli_quat_slerp(float *dst, const float *q1, const float *q2, float t);
+/* x86-64: the mat4 multiplication uses AVX when the CPU supports it */
+int ngli_cpu_has_avx(void);
+void ngli_math_utils_init_x86_64(void);
+void ngli_mat3_inverse_sse(float *dst, const float *m);
+extern void (*ngli_mat4_mul_x86_64)(float *dst, const float *m1, const float *m2);
+void ngli_mat4_mul_sse(float *dst, const float *m1, const float *m2);
+void ngli_mat4_mul_avx(float *dst, const float *m1, const float *m2);
+void ngli_mat4_mul_vec4_sse(float *dst, const float *m, const float *v);
+void ngli_quat_slerp_sse(float *dst, const float *q1, const float *q2, float t);
 
 #endif
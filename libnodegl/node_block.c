@@ -122,11 +122,20 @@ int ngli_node_block_ref(struct ngl_node *node)
         if (ret < 0)
             return ret;
 
-        ret = ngli_buffer_upload(&s->buffer, s->data, s->data_size);
+        ret = ngli_buffer_upload(&s->buffer, s->data, s->data_size, 0);
         if (ret < 0)
             return ret;
 
+        /* The other ring segments hold no data yet */
+        for (int i = 0; i < NGLI_BUFFER_NB_SEGMENTS; i++)
+            s->segments_serial[i] = -1;
+        s->upload_serial = 0;
+        memset(s->fields_serial, 0, s->nb_fields * sizeof(*s->fields_serial));
+        s->segments_serial[s->buffer.segment] = s->upload_serial;
+
         s->buffer_last_upload_time = -1.;
+        s->has_changed = 0;
+        memset(s->fields_changed, 0, s->nb_fields);
     }
 
     return 0;
@@ -141,12 +150,111 @@ void ngli_node_block_unref(struct ngl_node *node)
         ngli_buffer_reset(&s->buffer);
 }
 
+/*
+ * Each glBufferSubData() call has a fixed cost, so partial uploads are only
+ * worth it while the changed data is sparse: dirty fields separated by less
+ * than MAX_RANGE_GAP bytes are merged into the same range, and the whole
+ * block is uploaded at once if more than MAX_UPLOAD_RANGES ranges are needed
+ * or if they cover more than half of the block.
+ */
+#define MAX_UPLOAD_RANGES 4
+#define MAX_RANGE_GAP 64
+
+/*
+ * A ring segment is left as it was written NGLI_BUFFER_NB_SEGMENTS uploads
+ * ago: only the fields changed by any of the uploads since then are copied
+ * into it. This is a plain memcpy() into mapped memory, so no range merging
+ * is needed.
+ */
+static void upload_block_data_ring(struct block_priv *s)
+{
+    const int64_t serial = ++s->upload_serial;
+    for (int i = 0; i < s->nb_fields; i++) {
+        if (s->fields_changed[i]) {
+            s->fields_serial[i] = serial;
+            s->fields_changed[i] = 0;
+        }
+    }
+
+    uint8_t *dst = ngli_buffer_next_segment(&s->buffer);
+    const int64_t segment_serial = s->segments_serial[s->buffer.segment];
+    s->segments_serial[s->buffer.segment] = serial;
+
+    if (segment_serial < 0) {
+        memcpy(dst, s->data, s->data_size);
+        return;
+    }
+
+    const struct block_field *field_info = ngli_darray_data(&s->block.fields);
+    for (int i = 0; i < s->nb_fields; i++) {
+        if (s->fields_serial[i] <= segment_serial)
+            continue;
+        const struct block_field *fi = &field_info[i];
+        memcpy(dst + fi->offset, s->data + fi->offset, fi->size);
+    }
+}
+
+static int upload_block_data(struct block_priv *s)
+{
+    if (s->buffer.mapped_data) {
+        upload_block_data_ring(s);
+        return 0;
+    }
+
+    struct {
+        int offset;
+        int size;
+    } ranges[MAX_UPLOAD_RANGES];
+    int nb_ranges = 0;
+    int dirty_size = 0;
+    int full_upload = 0;
+
+    const struct block_field *field_info = ngli_darray_data(&s->block.fields);
+    for (int i = 0; i < s->nb_fields; i++) {
+        if (!s->fields_changed[i])
+            continue;
+        s->fields_changed[i] = 0;
+        if (full_upload)
+            continue;
+        const struct block_field *fi = &field_info[i];
+        if (nb_ranges) {
+            const int end = ranges[nb_ranges - 1].offset + ranges[nb_ranges - 1].size;
+            const int gap = fi->offset - end;
+            if (gap <= MAX_RANGE_GAP) {
+                ranges[nb_ranges - 1].size += gap + fi->size;
+                dirty_size += gap + fi->size;
+                continue;
+            }
+        }
+        if (nb_ranges == MAX_UPLOAD_RANGES) {
+            full_upload = 1;
+            continue;
+        }
+        ranges[nb_ranges].offset = fi->offset;
+        ranges[nb_ranges].size = fi->size;
+        nb_ranges++;
+        dirty_size += fi->size;
+    }
+
+    if (full_upload || dirty_size > s->data_size / 2)
+        return ngli_buffer_upload(&s->buffer, s->data, s->data_size, 0);
+
+    for (int i = 0; i < nb_ranges; i++) {
+        int ret = ngli_buffer_upload(&s->buffer, s->data + ranges[i].offset,
+                                     ranges[i].size, ranges[i].offset);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 int ngli_node_block_upload(struct ngl_node *node)
 {
     struct block_priv *s = node->priv_data;
 
     if (s->has_changed && s->buffer_last_upload_time != node->last_update_time) {
-        int ret = ngli_buffer_upload(&s->buffer, s->data, s->data_size);
+        int ret = upload_block_data(s);
         if (ret < 0)
             return ret;
         s->buffer_last_upload_time = node->last_update_time;
@@ -232,7 +340,8 @@ static void update_block_data(struct block_priv *s, int forced)
         if (!forced && !field_funcs[fi->count ? IS_ARRAY : IS_SINGLE].has_changed(field_node))
             continue;
         field_funcs[fi->count ? IS_ARRAY : IS_SINGLE].update_data(s->data + fi->offset, field_node, fi);
-        s->has_changed = 1; // TODO: only re-upload the changing data segments
+        s->fields_changed[i] = 1;
+        s->has_changed = 1;
     }
 }
 
@@ -283,6 +392,14 @@ static int block_init(struct ngl_node *node)
     if (!s->data)
         return NGL_ERROR_MEMORY;
 
+    s->fields_changed = ngli_calloc(s->nb_fields, sizeof(*s->fields_changed));
+    if (!s->fields_changed)
+        return NGL_ERROR_MEMORY;
+
+    s->fields_serial = ngli_calloc(s->nb_fields, sizeof(*s->fields_serial));
+    if (!s->fields_serial)
+        return NGL_ERROR_MEMORY;
+
     update_block_data(s, 1);
     return 0;
 }
@@ -314,6 +431,8 @@ static void block_uninit(struct ngl_node *node)
 
     ngli_block_reset(&s->block);
     ngli_free(s->data);
+    ngli_free(s->fields_changed);
+    ngli_free(s->fields_serial);
 }
 
 const struct node_class ngli_block_class = {
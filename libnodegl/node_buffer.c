@@ -58,14 +58,18 @@ int ngli_node_buffer_ref(struct ngl_node *node)
         return ngli_node_block_ref(s->block);
 
     if (s->buffer_refcount++ == 0) {
-        int ret = ngli_buffer_init(&s->buffer, ctx, s->data_size, s->usage);
+        if (!s->dynamic)
+            return ngli_bufcache_get_buffer(&ctx->bufcache, &s->buffer, s->data, s->data_size, s->data_format);
+
+        int ret = ngli_buffer_init(&s->dynamic_buffer, ctx, s->data_size, s->usage);
         if (ret < 0)
             return ret;
 
-        ret = ngli_buffer_upload(&s->buffer, s->data, s->data_size);
+        ret = ngli_buffer_upload(&s->dynamic_buffer, s->data, s->data_size, 0);
         if (ret < 0)
             return ret;
 
+        s->buffer = &s->dynamic_buffer;
         s->buffer_last_upload_time = -1.;
     }
 
@@ -74,14 +78,20 @@ int ngli_node_buffer_ref(struct ngl_node *node)
 
 void ngli_node_buffer_unref(struct ngl_node *node)
 {
+    struct ngl_ctx *ctx = node->ctx;
     struct buffer_priv *s = node->priv_data;
 
     if (s->block)
         return ngli_node_block_unref(s->block);
 
     ngli_assert(s->buffer_refcount);
-    if (s->buffer_refcount-- == 1)
-        ngli_buffer_reset(&s->buffer);
+    if (s->buffer_refcount-- == 1) {
+        if (s->dynamic)
+            ngli_buffer_reset(&s->dynamic_buffer);
+        else
+            ngli_bufcache_release_buffer(&ctx->bufcache, &s->buffer);
+        s->buffer = NULL;
+    }
 }
 
 int ngli_node_buffer_upload(struct ngl_node *node)
@@ -92,7 +102,7 @@ int ngli_node_buffer_upload(struct ngl_node *node)
         return ngli_node_block_upload(s->block);
 
     if (s->dynamic && s->buffer_last_upload_time != node->last_update_time) {
-        int ret = ngli_buffer_upload(&s->buffer, s->data, s->data_size);
+        int ret = ngli_buffer_upload(s->buffer, s->data, s->data_size, 0);
         if (ret < 0)
             return ret;
         s->buffer_last_upload_time = node->last_update_time;
@@ -311,6 +321,10 @@ DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERUSHORT, "BufferUShort", ushort, NGLI_FORMAT_R
 DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERUSVEC2, "BufferUSVec2", usvec2, NGLI_FORMAT_R16G16_UNORM,        NGLI_TYPE_NONE)
 DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERUSVEC3, "BufferUSVec3", usvec3, NGLI_FORMAT_R16G16B16_UNORM,     NGLI_TYPE_NONE)
 DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERUSVEC4, "BufferUSVec4", usvec4, NGLI_FORMAT_R16G16B16A16_UNORM,  NGLI_TYPE_NONE)
+DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERHALF,   "BufferHalf",   half,   NGLI_FORMAT_R16_SFLOAT,          NGLI_TYPE_NONE)
+DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERHVEC2,  "BufferHVec2",  hvec2,  NGLI_FORMAT_R16G16_SFLOAT,       NGLI_TYPE_NONE)
+DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERHVEC3,  "BufferHVec3",  hvec3,  NGLI_FORMAT_R16G16B16_SFLOAT,    NGLI_TYPE_NONE)
+DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERHVEC4,  "BufferHVec4",  hvec4,  NGLI_FORMAT_R16G16B16A16_SFLOAT, NGLI_TYPE_NONE)
 DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERFLOAT,  "BufferFloat",  float,  NGLI_FORMAT_R32_SFLOAT,          NGLI_TYPE_FLOAT)
 DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERVEC2,   "BufferVec2",   vec2,   NGLI_FORMAT_R32G32_SFLOAT,       NGLI_TYPE_VEC2)
 DEFINE_BUFFER_CLASS(NGL_NODE_BUFFERVEC3,   "BufferVec3",   vec3,   NGLI_FORMAT_R32G32B32_SFLOAT,    NGLI_TYPE_VEC3)
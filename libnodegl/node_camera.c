@@ -57,6 +57,7 @@ struct camera_priv {
 
     NGLI_ALIGNED_MAT(modelview_matrix);
     NGLI_ALIGNED_MAT(projection_matrix);
+    int64_t modelview_version;
 };
 
 #define OFFSET(x) offsetof(struct camera_priv, x)
@@ -147,10 +148,11 @@ static int camera_update(struct ngl_node *node, double t)
         int ret = ngli_node_update(s->what##_transform, t);                 \
         if (ret < 0)                                                        \
             return ret;                                                     \
-        if (!ngli_darray_push(&ctx->modelview_matrix_stack, id_matrix))     \
-            return NGL_ERROR_MEMORY;                                        \
+        ret = ngli_transform_push_modelview(ctx, id_matrix, 0);             \
+        if (ret < 0)                                                        \
+            return ret;                                                     \
         ngli_node_draw(s->what##_transform);                                \
-        ngli_darray_pop(&ctx->modelview_matrix_stack);                      \
+        ngli_transform_pop_modelview(ctx);                                  \
         const float *matrix = s->what##_transform_matrix;                   \
         if (matrix)                                                         \
             ngli_mat4_mul_vec4(what, matrix, what);                         \
@@ -167,7 +169,13 @@ static int camera_update(struct ngl_node *node, double t)
         ngli_vec3_cross(up, up, s->ground);
     }
 
-    ngli_mat4_look_at(s->modelview_matrix, eye, center, up);
+    /* A new modelview version invalidates the world matrices cached below */
+    NGLI_ALIGNED_MAT(modelview_matrix);
+    ngli_mat4_look_at(modelview_matrix, eye, center, up);
+    if (!s->modelview_version || memcmp(modelview_matrix, s->modelview_matrix, sizeof(modelview_matrix))) {
+        memcpy(s->modelview_matrix, modelview_matrix, sizeof(modelview_matrix));
+        s->modelview_version = ++ctx->modelview_version;
+    }
 
     if (s->fov_anim) {
         struct ngl_node *anim_node = s->fov_anim;
@@ -204,13 +212,16 @@ static void camera_draw(struct ngl_node *node)
     struct ngl_ctx *ctx = node->ctx;
     struct camera_priv *s = node->priv_data;
 
-    if (!ngli_darray_push(&ctx->modelview_matrix_stack, s->modelview_matrix) ||
-        !ngli_darray_push(&ctx->projection_matrix_stack, s->projection_matrix))
+    if (ngli_transform_push_modelview(ctx, s->modelview_matrix, s->modelview_version) < 0)
+        return;
+    if (!ngli_darray_push(&ctx->projection_matrix_stack, s->projection_matrix)) {
+        ngli_transform_pop_modelview(ctx);
         return;
+    }
 
     ngli_node_draw(s->child);
 
-    ngli_darray_pop(&ctx->modelview_matrix_stack);
+    ngli_transform_pop_modelview(ctx);
     ngli_darray_pop(&ctx->projection_matrix_stack);
 }
 
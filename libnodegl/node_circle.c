@@ -104,6 +104,7 @@ static int circle_init(struct ngl_node *node)
         goto end;
 
     s->topology = NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN;
+    ngli_node_geometry_update_bounds(node);
 
     ret = 0;
 
@@ -39,6 +39,7 @@ struct compute_priv {
     struct hmap *textures;
     struct hmap *uniforms;
     struct hmap *blocks;
+    int specialize_uniforms;
 
     struct pass pass;
 };
@@ -99,6 +100,10 @@ static const struct node_param compute_params[] = {
                    .desc=NGLI_DOCSTRING("uniforms made accessible to the compute `program`")},
     {"blocks",     PARAM_TYPE_NODEDICT, OFFSET(blocks),     .node_types=(const int[]){NGL_NODE_BLOCK, -1},
                    .desc=NGLI_DOCSTRING("input and output blocks made accessible to the compute `program`")},
+    {"specialize_uniforms", PARAM_TYPE_BOOL, OFFSET(specialize_uniforms),
+                   .desc=NGLI_DOCSTRING("compile the values of the non-animated `uniforms` as constants in a "
+                                        "specialized variant of the compute `program`; these uniforms can not be "
+                                        "live changed anymore")},
     {NULL}
 };
 
@@ -112,6 +117,7 @@ static int compute_init(struct ngl_node *node)
         .textures = s->textures,
         .uniforms = s->uniforms,
         .blocks = s->blocks,
+        .specialize_uniforms = s->specialize_uniforms,
         .nb_group_x = s->nb_group_x,
         .nb_group_y = s->nb_group_y,
         .nb_group_z = s->nb_group_z,
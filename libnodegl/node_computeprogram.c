@@ -41,7 +41,7 @@ static int computeprogram_init(struct ngl_node *node)
     struct ngl_ctx *ctx = node->ctx;
     struct program_priv *s = node->priv_data;
 
-    return ngli_pgcache_get_compute_program(&ctx->pgcache, &s->program, s->compute);
+    return ngli_pgcache_get_hashed_compute_program(&ctx->pgcache, &s->program, s->compute, s->compute_hash);
 }
 
 static void computeprogram_uninit(struct ngl_node *node)
@@ -24,6 +24,8 @@
 #include <string.h>
 #include <stdint.h>
 
+#include "bounds.h"
+#include "format.h"
 #include "log.h"
 #include "nodegl.h"
 #include "nodes.h"
@@ -49,6 +51,22 @@ fail:
     return NULL;
 }
 
+/*
+ * The bounds are only known for float positions available on the CPU side;
+ * geometries without bounds are never culled.
+ */
+void ngli_node_geometry_update_bounds(struct ngl_node *node)
+{
+    struct geometry_priv *s = node->priv_data;
+    const struct buffer_priv *vertices = s->vertices_buffer->priv_data;
+
+    s->has_bounds = !vertices->block && vertices->data &&
+                    vertices->data_format == NGLI_FORMAT_R32G32B32_SFLOAT;
+    if (s->has_bounds)
+        ngli_bounds_from_points(&s->bounds, (const float *)vertices->data,
+                                vertices->count, vertices->data_stride);
+}
+
 static const struct param_choices topology_choices = {
     .name = "topology",
     .consts = {
@@ -65,15 +83,33 @@ static const struct param_choices topology_choices = {
 #define TEXCOORDS_TYPES_LIST (const int[]){NGL_NODE_BUFFERFLOAT,            \
                                            NGL_NODE_BUFFERVEC2,             \
                                            NGL_NODE_BUFFERVEC3,             \
+                                           NGL_NODE_BUFFERHALF,             \
+                                           NGL_NODE_BUFFERHVEC2,            \
+                                           NGL_NODE_BUFFERHVEC3,            \
+                                           NGL_NODE_BUFFERUSHORT,           \
+                                           NGL_NODE_BUFFERUSVEC2,           \
+                                           NGL_NODE_BUFFERUSVEC3,           \
                                            NGL_NODE_ANIMATEDBUFFERFLOAT,    \
                                            NGL_NODE_ANIMATEDBUFFERVEC2,     \
                                            NGL_NODE_ANIMATEDBUFFERVEC3,     \
                                            -1}
 
+#define VERTICES_TYPES_LIST (const int[]){NGL_NODE_BUFFERVEC3,             \
+                                          NGL_NODE_BUFFERHVEC3,            \
+                                          NGL_NODE_ANIMATEDBUFFERVEC3,     \
+                                          -1}
+
+#define NORMALS_TYPES_LIST (const int[]){NGL_NODE_BUFFERVEC3,              \
+                                         NGL_NODE_BUFFERHVEC3,             \
+                                         NGL_NODE_BUFFERSVEC3,             \
+                                         NGL_NODE_BUFFERBVEC3,             \
+                                         NGL_NODE_ANIMATEDBUFFERVEC3,      \
+                                         -1}
+
 #define OFFSET(x) offsetof(struct geometry_priv, x)
 static const struct node_param geometry_params[] = {
     {"vertices",  PARAM_TYPE_NODE, OFFSET(vertices_buffer),
-                  .node_types=(const int[]){NGL_NODE_BUFFERVEC3, NGL_NODE_ANIMATEDBUFFERVEC3, -1},
+                  .node_types=VERTICES_TYPES_LIST,
                   .flags=PARAM_FLAG_CONSTRUCTOR | PARAM_FLAG_DOT_DISPLAY_FIELDNAME,
                   .desc=NGLI_DOCSTRING("vertice coordinates defining the geometry")},
     {"uvcoords",  PARAM_TYPE_NODE, OFFSET(uvcoords_buffer),
@@ -81,7 +117,7 @@ static const struct node_param geometry_params[] = {
                   .flags=PARAM_FLAG_DOT_DISPLAY_FIELDNAME,
                   .desc=NGLI_DOCSTRING("coordinates used for UV mapping of each `vertices`")},
     {"normals",   PARAM_TYPE_NODE, OFFSET(normals_buffer),
-                  .node_types=(const int[]){NGL_NODE_BUFFERVEC3, NGL_NODE_ANIMATEDBUFFERVEC3, -1},
+                  .node_types=NORMALS_TYPES_LIST,
                   .flags=PARAM_FLAG_DOT_DISPLAY_FIELDNAME,
                   .desc=NGLI_DOCSTRING("normal vectors of each `vertices`")},
     {"indices",   PARAM_TYPE_NODE, OFFSET(indices_buffer),
@@ -91,6 +127,9 @@ static const struct node_param geometry_params[] = {
     {"topology",  PARAM_TYPE_SELECT, OFFSET(topology), {.i64=NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST},
                   .choices=&topology_choices,
                   .desc=NGLI_DOCSTRING("primitive topology")},
+    {"optimize",  PARAM_TYPE_BOOL, OFFSET(optimize), {.i64=0},
+                  .desc=NGLI_DOCSTRING("optimize the static triangle lists for rendering: merge identical vertices, "
+                                       "reorder the triangles for the vertex cache and interleave the attributes")},
     {NULL}
 };
 
@@ -140,6 +179,8 @@ static int geometry_init(struct ngl_node *node)
         }
     }
 
+    ngli_node_geometry_update_bounds(node);
+
     return 0;
 }
 
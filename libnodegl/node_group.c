@@ -22,21 +22,98 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#include "batch.h"
+#include "log.h"
+#include "memory.h"
 #include "nodegl.h"
 #include "nodes.h"
 
 struct group_priv {
     struct ngl_node **children;
     int nb_children;
+    int batch;
+
+    struct darray batches;
+    int *batch_ids;
 };
 
 #define OFFSET(x) offsetof(struct group_priv, x)
 static const struct node_param group_params[] = {
     {"children", PARAM_TYPE_NODELIST, OFFSET(children),
                  .desc=NGLI_DOCSTRING("a set of scenes")},
+    {"batch",    PARAM_TYPE_BOOL, OFFSET(batch),
+                 .desc=NGLI_DOCSTRING("merge consecutive children rendering the same geometry with the same program "
+                                      "into instanced draws, where the differing uniforms and transforms become "
+                                      "per-instance data; children with different geometries sharing the same "
+                                      "vertex layout are merged into indirect multi-draws on OpenGL 4.3+, or "
+                                      "packed into a single draw; children with `culling` enabled are not "
+                                      "merged")},
     {NULL}
 };
 
+static int group_init(struct ngl_node *node)
+{
+    struct group_priv *s = node->priv_data;
+
+    ngli_darray_init(&s->batches, sizeof(struct render_batch *), 0);
+
+    if (!s->batch || s->nb_children < 2)
+        return 0;
+
+    s->batch_ids = ngli_calloc(s->nb_children, sizeof(*s->batch_ids));
+    if (!s->batch_ids)
+        return NGL_ERROR_MEMORY;
+
+    for (int i = 0; i < s->nb_children; i++)
+        s->batch_ids[i] = -1;
+
+    int i = 0;
+    while (i < s->nb_children) {
+        const int count = ngli_batch_get_run_length(&s->children[i], s->nb_children - i);
+        if (count < 2) {
+            i++;
+            continue;
+        }
+
+        struct render_batch *batch = ngli_calloc(1, sizeof(*batch));
+        if (!batch)
+            return NGL_ERROR_MEMORY;
+
+        int ret = ngli_batch_init(batch, node->ctx, &s->children[i], count);
+        if (ret == NGL_ERROR_UNSUPPORTED) {
+            LOG(VERBOSE, "children %d to %d of %s can not be batched", i, i + count - 1, node->label);
+            ngli_batch_reset(batch);
+            ngli_free(batch);
+            i += count;
+            continue;
+        }
+        if (ret < 0 || !ngli_darray_push(&s->batches, &batch)) {
+            ngli_batch_reset(batch);
+            ngli_free(batch);
+            return ret < 0 ? ret : NGL_ERROR_MEMORY;
+        }
+
+        const int id = ngli_darray_count(&s->batches) - 1;
+        for (int j = 0; j < count; j++)
+            s->batch_ids[i + j] = id;
+        i += count;
+    }
+
+    return 0;
+}
+
+/*
+ * Batched children are only prepared and drawn through their batch, which
+ * takes the render node of the first child of the run.
+ */
+static struct render_batch *get_batch(const struct group_priv *s, int i)
+{
+    if (!s->batch_ids || s->batch_ids[i] < 0)
+        return NULL;
+    struct render_batch **batches = ngli_darray_data(&s->batches);
+    return batches[s->batch_ids[i]];
+}
+
 static int group_prepare(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
@@ -50,6 +127,16 @@ static int group_prepare(struct ngl_node *node)
             return NGL_ERROR_MEMORY;
         ctx->rnode_pos = rnode;
 
+        struct render_batch *batch = get_batch(s, i);
+        if (batch) {
+            if (batch->children == &s->children[i]) {
+                ret = ngli_batch_prepare(batch);
+                if (ret < 0)
+                    goto done;
+            }
+            continue;
+        }
+
         struct ngl_node *child = s->children[i];
         ret = ngli_node_prepare(child);
         if (ret < 0)
@@ -72,6 +159,13 @@ static int group_update(struct ngl_node *node, double t)
             return ret;
     }
 
+    struct render_batch **batches = ngli_darray_data(&s->batches);
+    for (int i = 0; i < ngli_darray_count(&s->batches); i++) {
+        int ret = ngli_batch_update(batches[i], t);
+        if (ret < 0)
+            return ret;
+    }
+
     return 0;
 }
 
@@ -84,18 +178,42 @@ static void group_draw(struct ngl_node *node)
     struct rnode *rnodes = ngli_darray_data(&rnode_pos->children);
     for (int i = 0; i < s->nb_children; i++) {
         ctx->rnode_pos = &rnodes[i];
+
+        struct render_batch *batch = get_batch(s, i);
+        if (batch) {
+            if (batch->children == &s->children[i])
+                ngli_batch_exec(batch);
+            continue;
+        }
+
         struct ngl_node *child = s->children[i];
         ngli_node_draw(child);
     }
     ctx->rnode_pos = rnode_pos;
 }
 
+static void group_uninit(struct ngl_node *node)
+{
+    struct group_priv *s = node->priv_data;
+
+    struct render_batch **batches = ngli_darray_data(&s->batches);
+    for (int i = 0; i < ngli_darray_count(&s->batches); i++) {
+        ngli_batch_reset(batches[i]);
+        ngli_free(batches[i]);
+    }
+    ngli_darray_reset(&s->batches);
+    ngli_free(s->batch_ids);
+    s->batch_ids = NULL;
+}
+
 const struct node_class ngli_group_class = {
     .id        = NGL_NODE_GROUP,
     .name      = "Group",
+    .init      = group_init,
     .prepare   = group_prepare,
     .update    = group_update,
     .draw      = group_draw,
+    .uninit    = group_uninit,
     .priv_size = sizeof(struct group_priv),
     .params    = group_params,
     .file      = __FILE__,
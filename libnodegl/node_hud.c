@@ -126,6 +126,7 @@ enum {
     DRAWCALL_COMPUTES,
     DRAWCALL_GRAPHICCONFIGS,
     DRAWCALL_RENDERS,
+    DRAWCALL_CULLED,
     DRAWCALL_RTTS,
     NB_DRAWCALL
 };
@@ -235,6 +236,7 @@ static const struct activity_spec {
 static const struct drawcall_spec {
     const char *label;
     const int *node_types;
+    int culling;        // 1: exclude the culled draws, 2: only count them
 } drawcall_specs[] = {
     [DRAWCALL_COMPUTES] = {
         .label="Computes",
@@ -247,6 +249,12 @@ static const struct drawcall_spec {
     [DRAWCALL_RENDERS] = {
         .label="Renders",
         .node_types=(const int[]){NGL_NODE_RENDER, -1},
+        .culling=1,
+    },
+    [DRAWCALL_CULLED] = {
+        .label="Culled",
+        .node_types=(const int[]){NGL_NODE_RENDER, -1},
+        .culling=2,
     },
     [DRAWCALL_RTTS] = {
         .label="RTTs",
@@ -554,14 +562,28 @@ static void widget_activity_make_stats(struct ngl_node *node, struct widget *wid
         priv->nb_actives += nodes[i]->is_active;
 }
 
+static int get_cull_count(const struct ngl_node *node)
+{
+    const struct render_priv *render = node->priv_data;
+    return render->pass.cull_count;
+}
+
 static void widget_drawcall_make_stats(struct ngl_node *node, struct widget *widget)
 {
+    const struct drawcall_spec *spec = widget->user_data;
     struct widget_drawcall *priv = widget->priv_data;
     struct darray *nodes_array = &priv->nodes;
     struct ngl_node **nodes = ngli_darray_data(nodes_array);
+
+    /* Culled draws are counted by the Render nodes of the HUD child */
     priv->nb_draws = 0;
-    for (int i = 0; i < ngli_darray_count(nodes_array); i++)
-        priv->nb_draws += nodes[i]->draw_count;
+    for (int i = 0; i < ngli_darray_count(nodes_array); i++) {
+        const int nb_culled = spec->culling ? get_cull_count(nodes[i]) : 0;
+        if (spec->culling == 2)
+            priv->nb_draws += nb_culled;
+        else
+            priv->nb_draws += nodes[i]->draw_count - nb_culled;
+    }
 }
 
 /* Draw utils */
@@ -1101,8 +1123,13 @@ static void widget_drawcall_reset_draws(struct widget *widget)
     for (int i = 0; i < NB_DRAWCALL; i++) {
         struct darray *nodes_array = &priv->nodes;
         struct ngl_node **nodes = ngli_darray_data(nodes_array);
-        for (int i = 0; i < ngli_darray_count(nodes_array); i++)
+        for (int i = 0; i < ngli_darray_count(nodes_array); i++) {
             nodes[i]->draw_count = 0;
+            if (nodes[i]->class->id == NGL_NODE_RENDER) {
+                struct render_priv *render = nodes[i]->priv_data;
+                render->pass.cull_count = 0;
+            }
+        }
     }
 }
 
@@ -1278,7 +1305,7 @@ static int hud_init(struct ngl_node *node)
     if (ret < 0)
         return ret;
 
-    ret = ngli_buffer_upload(&s->coords, coords, sizeof(coords));
+    ret = ngli_buffer_upload(&s->coords, coords, sizeof(coords), 0);
     if (ret < 0)
         return ret;
 
@@ -48,7 +48,9 @@ static int program_init(struct ngl_node *node)
         return NGL_ERROR_INVALID_USAGE;
     }
 
-    return ngli_pgcache_get_graphics_program(&ctx->pgcache, &s->program, s->vertex, s->fragment);
+    return ngli_pgcache_get_hashed_graphics_program(&ctx->pgcache, &s->program,
+                                                    s->vertex, s->vertex_hash,
+                                                    s->fragment, s->fragment_hash);
 }
 
 static void program_uninit(struct ngl_node *node)
@@ -105,6 +105,7 @@ static int quad_init(struct ngl_node *node)
         return NGL_ERROR_MEMORY;
 
     s->topology = NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN;
+    ngli_node_geometry_update_bounds(node);
 
     return 0;
 }
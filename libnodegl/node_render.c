@@ -32,19 +32,6 @@
 #include "topology.h"
 #include "utils.h"
 
-struct render_priv {
-    struct ngl_node *geometry;
-    struct ngl_node *program;
-    struct hmap *textures;
-    struct hmap *uniforms;
-    struct hmap *blocks;
-    struct hmap *attributes;
-    struct hmap *instance_attributes;
-    int nb_instances;
-
-    struct pass pass;
-};
-
 #define TEXTURES_TYPES_LIST (const int[]){NGL_NODE_TEXTURE2D,       \
                                           NGL_NODE_TEXTURE3D,       \
                                           NGL_NODE_TEXTURECUBE,     \
@@ -103,7 +90,35 @@ struct render_priv {
                                           NGL_NODE_STREAMEDMAT4,    \
                                           -1}
 
-#define ATTRIBUTES_TYPES_LIST (const int[]){NGL_NODE_BUFFERFLOAT,   \
+#define ATTRIBUTES_TYPES_LIST (const int[]){NGL_NODE_BUFFERBYTE,    \
+                                            NGL_NODE_BUFFERBVEC2,   \
+                                            NGL_NODE_BUFFERBVEC3,   \
+                                            NGL_NODE_BUFFERBVEC4,   \
+                                            NGL_NODE_BUFFERINT,     \
+                                            NGL_NODE_BUFFERIVEC2,   \
+                                            NGL_NODE_BUFFERIVEC3,   \
+                                            NGL_NODE_BUFFERIVEC4,   \
+                                            NGL_NODE_BUFFERSHORT,   \
+                                            NGL_NODE_BUFFERSVEC2,   \
+                                            NGL_NODE_BUFFERSVEC3,   \
+                                            NGL_NODE_BUFFERSVEC4,   \
+                                            NGL_NODE_BUFFERUBYTE,   \
+                                            NGL_NODE_BUFFERUBVEC2,  \
+                                            NGL_NODE_BUFFERUBVEC3,  \
+                                            NGL_NODE_BUFFERUBVEC4,  \
+                                            NGL_NODE_BUFFERUINT,    \
+                                            NGL_NODE_BUFFERUIVEC2,  \
+                                            NGL_NODE_BUFFERUIVEC3,  \
+                                            NGL_NODE_BUFFERUIVEC4,  \
+                                            NGL_NODE_BUFFERUSHORT,  \
+                                            NGL_NODE_BUFFERUSVEC2,  \
+                                            NGL_NODE_BUFFERUSVEC3,  \
+                                            NGL_NODE_BUFFERUSVEC4,  \
+                                            NGL_NODE_BUFFERHALF,    \
+                                            NGL_NODE_BUFFERHVEC2,   \
+                                            NGL_NODE_BUFFERHVEC3,   \
+                                            NGL_NODE_BUFFERHVEC4,   \
+                                            NGL_NODE_BUFFERFLOAT,   \
                                             NGL_NODE_BUFFERVEC2,    \
                                             NGL_NODE_BUFFERVEC3,    \
                                             NGL_NODE_BUFFERVEC4,    \
@@ -141,6 +156,16 @@ static const struct node_param render_params[] = {
                  .desc=NGLI_DOCSTRING("per instance extra vertex attributes made accessible to the `program`")},
     {"nb_instances", PARAM_TYPE_INT, OFFSET(nb_instances),
                  .desc=NGLI_DOCSTRING("number of instances to draw")},
+    {"culling",  PARAM_TYPE_BOOL, OFFSET(culling),
+                 .desc=NGLI_DOCSTRING("skip the draw when the bounding box of the `geometry` is entirely outside "
+                                      "the view frustum; the `program` must transform `ngl_position` with the "
+                                      "modelview and projection matrices; it can not be combined with "
+                                      "`nb_instances` or `instance_attributes`, and prevents the batching of "
+                                      "this node")},
+    {"specialize_uniforms", PARAM_TYPE_BOOL, OFFSET(specialize_uniforms),
+                 .desc=NGLI_DOCSTRING("compile the values of the non-animated `uniforms` as constants in a "
+                                      "specialized variant of the `program`; these uniforms can not be live "
+                                      "changed anymore")},
     {NULL}
 };
 
@@ -164,6 +189,8 @@ static int render_init(struct ngl_node *node)
         .attributes = s->attributes,
         .instance_attributes = s->instance_attributes,
         .nb_instances = s->nb_instances,
+        .culling = s->culling,
+        .specialize_uniforms = s->specialize_uniforms,
     };
     return ngli_pass_init(&s->pass, ctx, &params);
 }
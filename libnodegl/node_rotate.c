@@ -56,6 +56,7 @@ static void update_trf_matrix(struct ngl_node *node, float deg_angle)
         ngli_mat4_translate(transm, -a[0], -a[1], -a[2]);
         ngli_mat4_mul(matrix, matrix, transm);
     }
+    trf->matrix_version++;
 }
 
 static int rotate_init(struct ngl_node *node)
@@ -70,7 +71,8 @@ static int rotate_init(struct ngl_node *node)
     ngli_vec3_norm(s->normed_axis, s->axis);
     if (!s->anim)
         update_trf_matrix(node, s->angle);
-    return 0;
+    s->trf.animated = !!s->anim;
+    return ngli_transform_init(node);
 }
 
 static int update_angle(struct ngl_node *node)
@@ -81,6 +83,7 @@ static int update_angle(struct ngl_node *node)
         return NGL_ERROR_INVALID_USAGE;
     }
     update_trf_matrix(node, s->angle);
+    node->ctx->static_transforms_version++;
     return 0;
 }
 
@@ -125,8 +128,10 @@ const struct node_class ngli_rotate_class = {
     .id        = NGL_NODE_ROTATE,
     .name      = "Rotate",
     .init      = rotate_init,
+    .prepare   = ngli_transform_prepare,
     .update    = rotate_update,
     .draw      = ngli_transform_draw,
+    .uninit    = ngli_transform_uninit,
     .priv_size = sizeof(struct rotate_priv),
     .params    = rotate_params,
     .file      = __FILE__,
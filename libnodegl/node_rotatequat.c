@@ -53,6 +53,7 @@ static void update_trf_matrix(struct ngl_node *node, const float *quat)
         ngli_mat4_translate(transm, -a[0], -a[1], -a[2]);
         ngli_mat4_mul(matrix, matrix, transm);
     }
+    trf->matrix_version++;
 }
 
 static int rotatequat_init(struct ngl_node *node)
@@ -62,7 +63,8 @@ static int rotatequat_init(struct ngl_node *node)
     s->use_anchor = memcmp(s->anchor, zvec, sizeof(zvec));
     if (!s->anim)
         update_trf_matrix(node, s->quat);
-    return 0;
+    s->trf.animated = !!s->anim;
+    return ngli_transform_init(node);
 }
 
 static int update_quat(struct ngl_node *node)
@@ -73,6 +75,7 @@ static int update_quat(struct ngl_node *node)
         return NGL_ERROR_INVALID_USAGE;
     }
     update_trf_matrix(node, s->quat);
+    node->ctx->static_transforms_version++;
     return 0;
 }
 
@@ -115,8 +118,10 @@ const struct node_class ngli_rotatequat_class = {
     .id        = NGL_NODE_ROTATEQUAT,
     .name      = "RotateQuat",
     .init      = rotatequat_init,
+    .prepare   = ngli_transform_prepare,
     .update    = rotatequat_update,
     .draw      = ngli_transform_draw,
+    .uninit    = ngli_transform_uninit,
     .priv_size = sizeof(struct rotatequat_priv),
     .params    = rotatequat_params,
     .file      = __FILE__,
@@ -52,6 +52,7 @@ static void update_trf_matrix(struct ngl_node *node, const float *f)
         ngli_mat4_translate(tm, -a[0], -a[1], -a[2]);
         ngli_mat4_mul(matrix, matrix, tm);
     }
+    trf->matrix_version++;
 }
 
 static int scale_init(struct ngl_node *node)
@@ -61,7 +62,8 @@ static int scale_init(struct ngl_node *node)
     s->use_anchor = memcmp(s->anchor, zero_anchor, sizeof(s->anchor));
     if (!s->anim)
         update_trf_matrix(node, s->factors);
-    return 0;
+    s->trf.animated = !!s->anim;
+    return ngli_transform_init(node);
 }
 
 static int update_factors(struct ngl_node *node)
@@ -72,6 +74,7 @@ static int update_factors(struct ngl_node *node)
         return NGL_ERROR_INVALID_USAGE;
     }
     update_trf_matrix(node, s->factors);
+    node->ctx->static_transforms_version++;
     return 0;
 }
 
@@ -115,8 +118,10 @@ const struct node_class ngli_scale_class = {
     .id        = NGL_NODE_SCALE,
     .name      = "Scale",
     .init      = scale_init,
+    .prepare   = ngli_transform_prepare,
     .update    = scale_update,
     .draw      = ngli_transform_draw,
+    .uninit    = ngli_transform_uninit,
     .priv_size = sizeof(struct scale_priv),
     .params    = scale_params,
     .file      = __FILE__,
@@ -245,7 +245,7 @@ static int text_init(struct ngl_node *node)
     if (ret < 0)
         return ret;
 
-    ret = ngli_buffer_upload(&s->vertices, vertices, sizeof(vertices));
+    ret = ngli_buffer_upload(&s->vertices, vertices, sizeof(vertices), 0);
     if (ret < 0)
         return ret;
 
@@ -253,7 +253,7 @@ static int text_init(struct ngl_node *node)
     if (ret < 0)
         return ret;
 
-    ret = ngli_buffer_upload(&s->uvcoords, uvs, sizeof(uvs));
+    ret = ngli_buffer_upload(&s->uvcoords, uvs, sizeof(uvs), 0);
     if (ret < 0)
         return ret;
 
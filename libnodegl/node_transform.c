@@ -27,12 +27,21 @@
 #include "math_utils.h"
 #include "transforms.h"
 
+static int update_matrix(struct ngl_node *node)
+{
+    struct transform_priv *s = node->priv_data;
+    s->matrix_version++;
+    node->ctx->static_transforms_version++;
+    return 0;
+}
+
 #define OFFSET(x) offsetof(struct transform_priv, x)
 static const struct node_param transform_params[] = {
     {"child",  PARAM_TYPE_NODE, OFFSET(child), .flags=PARAM_FLAG_CONSTRUCTOR,
                .desc=NGLI_DOCSTRING("scene to apply the transform to")},
     {"matrix", PARAM_TYPE_MAT4, OFFSET(matrix), {.mat=NGLI_MAT4_IDENTITY},
                .flags=PARAM_FLAG_ALLOW_LIVE_CHANGE,
+               .update_func=update_matrix,
                .desc=NGLI_DOCSTRING("transformation matrix")},
     {NULL}
 };
@@ -47,8 +56,11 @@ static int transform_update(struct ngl_node *node, double t)
 const struct node_class ngli_transform_class = {
     .id        = NGL_NODE_TRANSFORM,
     .name      = "Transform",
+    .init      = ngli_transform_init,
+    .prepare   = ngli_transform_prepare,
     .update    = transform_update,
     .draw      = ngli_transform_draw,
+    .uninit    = ngli_transform_uninit,
     .priv_size = sizeof(struct transform_priv),
     .params    = transform_params,
     .file      = __FILE__,
@@ -38,6 +38,7 @@ static void update_trf_matrix(struct ngl_node *node, const float *vec)
     struct translate_priv *s = node->priv_data;
     struct transform_priv *trf = &s->trf;
     ngli_mat4_translate(trf->matrix, vec[0], vec[1], vec[2]);
+    trf->matrix_version++;
 }
 
 static int update_vector(struct ngl_node *node)
@@ -48,6 +49,7 @@ static int update_vector(struct ngl_node *node)
         return NGL_ERROR_INVALID_USAGE;
     }
     update_trf_matrix(node, s->vector);
+    node->ctx->static_transforms_version++;
     return 0;
 }
 
@@ -56,7 +58,8 @@ static int translate_init(struct ngl_node *node)
     struct translate_priv *s = node->priv_data;
     if (!s->anim)
         update_trf_matrix(node, s->vector);
-    return 0;
+    s->trf.animated = !!s->anim;
+    return ngli_transform_init(node);
 }
 
 static int translate_update(struct ngl_node *node, double t)
@@ -96,8 +99,10 @@ const struct node_class ngli_translate_class = {
     .id        = NGL_NODE_TRANSLATE,
     .name      = "Translate",
     .init      = translate_init,
+    .prepare   = ngli_transform_prepare,
     .update    = translate_update,
     .draw      = ngli_transform_draw,
+    .uninit    = ngli_transform_uninit,
     .priv_size = sizeof(struct translate_priv),
     .params    = translate_params,
     .file      = __FILE__,
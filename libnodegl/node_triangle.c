@@ -87,6 +87,7 @@ static int triangle_init(struct ngl_node *node)
         return NGL_ERROR_MEMORY;
 
     s->topology = NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    ngli_node_geometry_update_bounds(node);
 
     return 0;
 }
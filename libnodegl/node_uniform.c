@@ -163,10 +163,11 @@ static int uniformmat4_update(struct ngl_node *node, double t)
         if (ret < 0)
             return ret;
         static const NGLI_ALIGNED_MAT(id_matrix) = NGLI_MAT4_IDENTITY;
-        if (!ngli_darray_push(&ctx->modelview_matrix_stack, id_matrix))
-            return NGL_ERROR_MEMORY;
+        ret = ngli_transform_push_modelview(ctx, id_matrix, 0);
+        if (ret < 0)
+            return ret;
         ngli_node_draw(s->transform);
-        ngli_darray_pop(&ctx->modelview_matrix_stack);
+        ngli_transform_pop_modelview(ctx);
         if (s->transform_matrix)
             memcpy(s->matrix, s->transform_matrix, sizeof(s->matrix));
     }
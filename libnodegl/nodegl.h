@@ -131,6 +131,10 @@ struct ngl_node;
 #define NGL_NODE_BUFFERUSVEC2           NGLI_FOURCC('B','u','s','2')
 #define NGL_NODE_BUFFERUSVEC3           NGLI_FOURCC('B','u','s','3')
 #define NGL_NODE_BUFFERUSVEC4           NGLI_FOURCC('B','u','s','4')
+#define NGL_NODE_BUFFERHALF             NGLI_FOURCC('B','h','v','1')
+#define NGL_NODE_BUFFERHVEC2            NGLI_FOURCC('B','h','v','2')
+#define NGL_NODE_BUFFERHVEC3            NGLI_FOURCC('B','h','v','3')
+#define NGL_NODE_BUFFERHVEC4            NGLI_FOURCC('B','h','v','4')
 #define NGL_NODE_BUFFERFLOAT            NGLI_FOURCC('B','f','v','1')
 #define NGL_NODE_BUFFERVEC2             NGLI_FOURCC('B','f','v','2')
 #define NGL_NODE_BUFFERVEC3             NGLI_FOURCC('B','f','v','3')
@@ -347,6 +351,89 @@ enum {
     NGL_BACKEND_OPENGLES,
 };
 
+/**
+ * Pixel formats of the captured frames
+ *
+ * NV12 and I420 frames are made of a full resolution luma plane directly
+ * followed by the chroma planes subsampled by 2 in both directions, either
+ * interleaved (NV12) or one after the other (I420).
+ */
+enum {
+    NGL_CAPTURE_FORMAT_RGBA,
+    NGL_CAPTURE_FORMAT_BGRA,
+    NGL_CAPTURE_FORMAT_NV12,
+    NGL_CAPTURE_FORMAT_I420,
+};
+
+/**
+ * Color matrices used to capture NV12 and I420 frames
+ */
+enum {
+    NGL_CAPTURE_COLOR_MATRIX_BT709,
+    NGL_CAPTURE_COLOR_MATRIX_BT601,
+};
+
+/**
+ * Frame delivered by the asynchronous capture
+ */
+struct ngl_capture_frame {
+    const uint8_t *data; /* Pixels of the frame, top row first. The data is
+                            only valid for the duration of the callback. */
+    int width;           /* Width of the frame in pixels */
+    int height;          /* Height of the frame in pixels */
+    int linesize;        /* Number of bytes between two consecutive rows
+                            (of the luma plane for NV12 and I420) */
+    int format;          /* Pixel format (any of NGL_CAPTURE_FORMAT_*) */
+    double t;            /* Time of the frame as passed to ngl_draw() */
+};
+
+typedef void (*ngl_capture_callback)(void *user_data, const struct ngl_capture_frame *frame);
+
+/**
+ * Layout of the shared memory capture (see capture_shm_name)
+ *
+ * The shared memory object starts with a struct ngl_capture_shm_header and
+ * holds nb_slots slots of slot_size bytes starting at slots_offset. Each slot
+ * starts with a struct ngl_capture_shm_slot directly followed by the frame
+ * data.
+ *
+ * write_count and read_count are wrapping frame counters: frame n is stored
+ * in slot n % nb_slots and is available as soon as write_count is past n.
+ * The consumer must atomically increment read_count and wake up its futex(2)
+ * waiters once it is done with a frame, the context waiting on it for a free
+ * slot when nb_slots frames are pending. eos is set once the context stops
+ * writing frames. Every change of write_count or eos is followed by an
+ * increment of update_count and a wake up of its futex waiters: this is the
+ * word the consumer is expected to wait on, after loading it and before
+ * checking the other fields.
+ */
+#define NGL_CAPTURE_SHM_MAGIC   0x53474c4e /* "NGLS" */
+#define NGL_CAPTURE_SHM_VERSION 1
+
+struct ngl_capture_shm_header {
+    uint32_t magic;        /* NGL_CAPTURE_SHM_MAGIC */
+    uint32_t version;      /* NGL_CAPTURE_SHM_VERSION */
+    uint32_t nb_slots;     /* Number of frame slots */
+    uint32_t slot_size;    /* Size of a slot in bytes, header included */
+    uint32_t slots_offset; /* Offset of the first slot in bytes */
+    uint32_t write_count;  /* Number of frames written by the context */
+    uint32_t read_count;   /* Number of frames released by the consumer */
+    uint32_t eos;          /* Whether the context stopped writing frames */
+    uint32_t update_count; /* Number of updates of write_count and eos */
+    uint32_t reserved[7];
+};
+
+struct ngl_capture_shm_slot {
+    double pts;            /* Time of the frame as passed to ngl_draw() */
+    uint32_t size;         /* Size of the frame data in bytes */
+    int32_t format;        /* Pixel format (any of NGL_CAPTURE_FORMAT_*) */
+    int32_t width;         /* Width of the frame in pixels */
+    int32_t height;        /* Height of the frame in pixels */
+    int32_t linesize;      /* Number of bytes between two consecutive rows
+                              (of the luma plane for NV12 and I420) */
+    uint32_t reserved[9];
+};
+
 /**
  * node.gl configuration
  */
@@ -383,9 +470,63 @@ struct ngl_config {
 
     float clear_color[4]; /* Clear color (red, green, blue, alpha) */
 
-    uint8_t *capture_buffer; /* RGBA offscreen capture buffer. If allocated,
-                                its size must be at least width * height * 4
-                                bytes. */
+    uint8_t *capture_buffer; /* Offscreen capture buffer. If allocated, its
+                                size must be at least width * height * 4
+                                bytes (width * height * 3 / 2 bytes for NV12
+                                and I420). */
+
+    ngl_capture_callback capture_callback; /* Asynchronous offscreen capture
+                                              callback (optional, cannot be
+                                              combined with capture_buffer).
+                                              It is called from the rendering
+                                              thread with each frame once
+                                              capture_latency more frames have
+                                              been drawn. The remaining frames
+                                              are delivered when the context is
+                                              reconfigured or destroyed. */
+
+    void *capture_user_data; /* Opaque pointer passed to capture_callback */
+
+    int capture_latency; /* Number of frames drawn before a captured frame is
+                            delivered to capture_callback, between 1 and 8
+                            (0 selects the default of 2) */
+
+    int capture_format; /* Pixel format of the captured frames (any of
+                           NGL_CAPTURE_FORMAT_*, RGBA by default). NV12 and
+                           I420 are converted on the GPU before the readback
+                           and require a width multiple of 4 and an even
+                           height. With capture_callback, RGBA frames may be
+                           delivered as BGRA if the driver prefers it. */
+
+    int capture_color_matrix; /* Color matrix of the NV12 and I420 frames
+                                 (any of NGL_CAPTURE_COLOR_MATRIX_*) */
+
+    int capture_full_range; /* Whether the NV12 and I420 frames use the full
+                               range instead of the limited (video) range */
+
+    const char *capture_shm_name; /* Name of a POSIX shared memory object
+                                     (such as "/ngl-capture") created to hand
+                                     the captured frames over to another
+                                     process (optional, Linux only, cannot be
+                                     combined with capture_buffer or
+                                     capture_callback). The object must not
+                                     exist yet and is removed when the context
+                                     is reconfigured or destroyed. While
+                                     drawing, the context waits for the
+                                     consumer to release a slot. When the
+                                     frames in flight are flushed on
+                                     reconfiguration or destruction, it only
+                                     waits up to 1 second: it then drops the
+                                     remaining frames and sets eos. See struct
+                                     ngl_capture_shm_header for its layout. */
+
+    int capture_shm_slots; /* Number of frame slots of the shared memory
+                              capture (0 selects the default of 4) */
+
+    const char *program_cache_dir; /* Existing directory where the compiled
+                                      programs are stored and reused across
+                                      runs (optional, requires program binary
+                                      support from the driver) */
 };
 
 /**
@@ -471,6 +612,53 @@ int ngl_set_scene(struct ngl_ctx *s, struct ngl_node *scene);
  */
 int ngl_draw(struct ngl_ctx *s, double t);
 
+/**
+ * Prepare the resources of the scene ahead of its playback over a time range.
+ *
+ * Programs and pipelines are already created when the scene is set. This
+ * function goes through every time range of the scene starting within
+ * [t_start, t_end] so each resource involved is prefetched and released
+ * once, and submits the conversion programs required by the hardware
+ * decoded media. The scene is left ready to be drawn at t_start. The time
+ * spent is accounted in the warmup_time field of struct ngl_stats.
+ *
+ * Passing the same value for t_start and t_end only prefetches the resources
+ * needed at that time.
+ *
+ * @param s        pointer to the configured node.gl context
+ * @param t_start  start of the time range in seconds
+ * @param t_end    end of the time range in seconds
+ *
+ * @return 0 on success, NGL_ERROR_* (< 0) on error
+ */
+int ngl_warmup(struct ngl_ctx *s, double t_start, double t_end);
+
+/**
+ * Rendering statistics, accumulated since the last ngl_configure() call
+ */
+struct ngl_stats {
+    int64_t uniform_updates_issued;     /* number of uniform values sent to the GPU */
+    int64_t uniform_updates_skipped;    /* number of uniform values left untouched since unchanged */
+    int64_t buffer_duplicates;          /* number of static buffers sharing the GPU buffer of an identical one */
+    int64_t buffer_bytes_saved;         /* GPU memory spared by the static buffer sharing, in bytes */
+    int64_t draws_issued;               /* number of graphics draws submitted to the GPU */
+    int64_t draws_culled;               /* number of graphics draws skipped since outside the view frustum */
+    int64_t program_cache_hits;         /* number of program requests served by an already built program */
+    int64_t program_cache_misses;       /* number of programs which had to be built */
+    int64_t program_cache_evictions;    /* number of unused programs destroyed to respect the cache limit */
+    int64_t warmup_time;                /* time spent in ngl_warmup(), in microseconds */
+};
+
+/**
+ * Retrieve the rendering statistics of a node.gl context.
+ *
+ * @param s      pointer to the configured node.gl context
+ * @param stats  pointer to the destination statistics structure
+ *
+ * @return 0 on success, NGL_ERROR_* (< 0) on error
+ */
+int ngl_get_stats(struct ngl_ctx *s, struct ngl_stats *stats);
+
 /**
  * Serialize the current scene in Graphviz format (.dot) a node graph at the
  * specified time. Non active nodes will be grayed.
@@ -391,9 +391,104 @@ static int node_set_ctx(struct ngl_node *node, struct ngl_ctx *ctx, struct ngl_c
     return 0;
 }
 
+static int submit_programs(struct ngl_node *node, struct ngl_ctx *ctx, struct hmap *visited);
+
+static int submit_children_programs(uint8_t *base_ptr, const struct node_param *params,
+                                    struct ngl_ctx *ctx, struct hmap *visited)
+{
+    if (!params)
+        return 0;
+    for (int i = 0; params[i].key; i++) {
+        const struct node_param *par = &params[i];
+
+        if (par->type == PARAM_TYPE_NODE) {
+            uint8_t *node_p = base_ptr + par->offset;
+            struct ngl_node *node = *(struct ngl_node **)node_p;
+            if (node) {
+                int ret = submit_programs(node, ctx, visited);
+                if (ret < 0)
+                    return ret;
+            }
+        } else if (par->type == PARAM_TYPE_NODELIST) {
+            uint8_t *elems_p = base_ptr + par->offset;
+            uint8_t *nb_elems_p = base_ptr + par->offset + sizeof(struct ngl_node **);
+            struct ngl_node **elems = *(struct ngl_node ***)elems_p;
+            const int nb_elems = *(int *)nb_elems_p;
+            for (int j = 0; j < nb_elems; j++) {
+                int ret = submit_programs(elems[j], ctx, visited);
+                if (ret < 0)
+                    return ret;
+            }
+        } else if (par->type == PARAM_TYPE_NODEDICT) {
+            struct hmap *hmap = *(struct hmap **)(base_ptr + par->offset);
+            if (!hmap)
+                continue;
+            const struct hmap_entry *entry = NULL;
+            while ((entry = ngli_hmap_next(hmap, entry))) {
+                int ret = submit_programs(entry->data, ctx, visited);
+                if (ret < 0)
+                    return ret;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Submit the compilation of every program of the graph before any node gets
+ * initialized: the driver can then build them concurrently while the link
+ * results are only checked when the program nodes are initialized. Errors
+ * are ignored here since they will be reported at that point, except for the
+ * allocation of the visited set, which keeps the walk linear on graphs
+ * sharing subgraphs.
+ */
+static int submit_programs(struct ngl_node *node, struct ngl_ctx *ctx, struct hmap *visited)
+{
+    /* The programs of initialized nodes are already available */
+    if (node->ctx)
+        return 0;
+
+    char key[32];
+    (void)snprintf(key, sizeof(key), "%p", node);
+    if (ngli_hmap_get(visited, key))
+        return 0;
+    int ret = ngli_hmap_set(visited, key, node);
+    if (ret < 0)
+        return ret;
+
+    /*
+     * The sources of the program nodes cannot change while they are attached,
+     * so they are hashed here once for the prefetch and the initialization
+     */
+    struct program_priv *program = node->priv_data;
+    if (node->class->id == NGL_NODE_PROGRAM && program->vertex && program->fragment) {
+        program->vertex_hash = ngli_pgcache_hash_shader(program->vertex);
+        program->fragment_hash = ngli_pgcache_hash_shader(program->fragment);
+        ngli_pgcache_prefetch_hashed_graphics_program(&ctx->pgcache,
+                                                      program->vertex, program->vertex_hash,
+                                                      program->fragment, program->fragment_hash);
+    } else if (node->class->id == NGL_NODE_COMPUTEPROGRAM && program->compute) {
+        program->compute_hash = ngli_pgcache_hash_shader(program->compute);
+        ngli_pgcache_prefetch_hashed_compute_program(&ctx->pgcache, program->compute, program->compute_hash);
+    }
+
+    if ((ret = submit_children_programs(node->priv_data, node->class->params, ctx, visited)) < 0 ||
+        (ret = submit_children_programs((uint8_t *)node, ngli_base_node_params, ctx, visited)) < 0)
+        return ret;
+    return 0;
+}
+
 int ngli_node_attach_ctx(struct ngl_node *node, struct ngl_ctx *ctx)
 {
-    int ret = node_set_ctx(node, ctx, ctx);
+    struct hmap *visited = ngli_hmap_create();
+    if (!visited)
+        return NGL_ERROR_MEMORY;
+    int ret = submit_programs(node, ctx, visited);
+    ngli_hmap_freep(&visited);
+    if (ret < 0)
+        return ret;
+
+    ret = node_set_ctx(node, ctx, ctx);
     if (ret < 0)
         return ret;
 
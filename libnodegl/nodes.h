@@ -49,6 +49,7 @@
 
 #include "animation.h"
 #include "block.h"
+#include "bounds.h"
 #include "drawutils.h"
 #include "glincludes.h"
 #include "glcontext.h"
@@ -60,20 +61,27 @@
 #include "image.h"
 #include "nodegl.h"
 #include "params.h"
+#include "pass.h"
 #include "pgcache.h"
+#include "readback.h"
 #include "program.h"
 #include "darray.h"
+#include "bufcache.h"
+#include "geomcache.h"
 #include "buffer.h"
+#include "capture_shm.h"
 #include "format.h"
 #include "rendertarget.h"
 #include "rnode.h"
 #include "texture.h"
+#include "ubopool.h"
+#include "yuvconv.h"
 
 struct node_class;
 
 typedef int (*cmd_func_type)(struct ngl_ctx *s, void *arg);
 
-typedef void (*capture_func_type)(struct ngl_ctx *s);
+typedef int (*capture_func_type)(struct ngl_ctx *s);
 
 struct ngl_ctx {
     /* Controller-only fields */
@@ -95,10 +103,18 @@ struct ngl_ctx {
     float clear_color[4];
     int program_id;
     struct pgcache pgcache;
+    struct bufcache bufcache;
+    struct geomcache geomcache;
+    struct ubopool ubopool;
+    double frame_time;
+    struct ngl_stats stats;
     struct ngl_node *scene;
     struct ngl_config config;
     int timer_active;
     struct darray modelview_matrix_stack;
+    struct darray modelview_version_stack;
+    int64_t modelview_version;
+    int64_t static_transforms_version;
     struct darray projection_matrix_stack;
     struct darray activitycheck_nodes;
 #if defined(HAVE_VAAPI_X11)
@@ -122,6 +138,11 @@ struct ngl_ctx {
     struct rendertarget capture_rt;
     struct texture capture_rt_color;
     uint8_t *capture_buffer;
+    struct yuvconv capture_yuvconv;
+    struct readback readback;
+#if defined(TARGET_LINUX)
+    struct capture_shm capture_shm;
+#endif
 #if defined(TARGET_IPHONE)
     CVPixelBufferRef capture_cvbuffer;
     CVOpenGLESTextureRef capture_cvtexture;
@@ -191,11 +212,16 @@ struct geometry_priv {
     struct ngl_node *indices_buffer;
 
     int topology;
+    int optimize;
 
     int64_t max_indices;
+
+    int has_bounds;
+    struct bounds bounds;   // bounding box of the vertices, in model space
 };
 
 struct ngl_node *ngli_node_geometry_generate_buffer(struct ngl_ctx *ctx, int type, int count, int size, void *data);
+void ngli_node_geometry_update_bounds(struct ngl_node *node);
 
 struct buffer_priv {
     int count;              // number of elements
@@ -225,7 +251,8 @@ struct buffer_priv {
     int data_type;          // any of NGLI_TYPE_*
     int last_index;
 
-    struct buffer buffer;
+    struct buffer *buffer;          // GPU buffer, shared between identical static buffers
+    struct buffer dynamic_buffer;   // GPU buffer owned by dynamic buffers
     int buffer_refcount;
     double buffer_last_upload_time;
 };
@@ -284,7 +311,11 @@ struct block_priv {
     struct buffer buffer;
     int buffer_refcount;
     int has_changed;
+    uint8_t *fields_changed;
     double buffer_last_upload_time;
+    int64_t upload_serial;
+    int64_t *fields_serial;
+    int64_t segments_serial[NGLI_BUFFER_NB_SEGMENTS];
 };
 
 int ngli_node_block_ref(struct ngl_node *node);
@@ -296,6 +327,11 @@ struct program_priv {
     const char *fragment;
     const char *compute;
 
+    /* Hashes of the sources, computed when the node gets attached */
+    uint64_t vertex_hash;
+    uint64_t fragment_hash;
+    uint64_t compute_hash;
+
     struct program program;
 };
 
@@ -340,9 +376,30 @@ struct timerangemode_priv {
     int updated;
 };
 
+struct render_priv {
+    struct ngl_node *geometry;
+    struct ngl_node *program;
+    struct hmap *textures;
+    struct hmap *uniforms;
+    struct hmap *blocks;
+    struct hmap *attributes;
+    struct hmap *instance_attributes;
+    int nb_instances;
+    int culling;
+    int specialize_uniforms;
+
+    struct pass pass;
+};
+
 struct transform_priv {
     struct ngl_node *child;
     NGLI_ALIGNED_MAT(matrix);
+    int animated;
+    int64_t matrix_version;
+    struct darray world_matrices;
+    struct ngl_node *folded_child;
+    NGLI_ALIGNED_MAT(folded_matrix);
+    int64_t folded_version;
 };
 
 struct identity_priv {
@@ -28,6 +28,7 @@
 
 #include "block.h"
 #include "buffer.h"
+#include "format.h"
 #include "glincludes.h"
 #include "hmap.h"
 #include "image.h"
@@ -40,6 +41,7 @@
 #include "pgcache.h"
 #include "pipeline.h"
 #include "program.h"
+#include "specialize.h"
 #include "texture.h"
 #include "topology.h"
 #include "type.h"
@@ -50,12 +52,30 @@ struct pipeline_desc {
     int modelview_matrix_index;
     int projection_matrix_index;
     int normal_matrix_index;
+    int time_index;
     struct darray texture_infos;
+    int64_t normal_matrix_version;
+    float normal_matrix[3*3];
 };
 
+struct specialized_uniform {
+    char name[MAX_ID_LEN];
+    struct ngl_node *node;
+    uint8_t data[4 * 4 * sizeof(float)];
+};
+
+static int is_specialized(const struct pass *s, const char *name)
+{
+    const struct specialized_uniform *uniforms = ngli_darray_data(&s->specialized_uniforms);
+    for (int i = 0; i < ngli_darray_count(&s->specialized_uniforms); i++)
+        if (!strcmp(uniforms[i].name, name))
+            return 1;
+    return 0;
+}
+
 static int register_uniform(struct pass *s, const char *name, struct ngl_node *uniform)
 {
-    if (!uniform)
+    if (!uniform || is_specialized(s, name))
         return 0;
 
     struct hmap *infos = s->pipeline_program->uniforms;
@@ -99,6 +119,7 @@ static int register_uniforms(struct pass *s)
         {.name = "ngl_modelview_matrix",  .type = NGLI_TYPE_MAT4, .count = 1, .data = NULL},
         {.name = "ngl_projection_matrix", .type = NGLI_TYPE_MAT4, .count = 1, .data = NULL},
         {.name = "ngl_normal_matrix",     .type = NGLI_TYPE_MAT3, .count = 1, .data = NULL},
+        {.name = "ngl_time",              .type = NGLI_TYPE_FLOAT, .count = 1, .data = NULL},
     };
 
     for (int i = 0; i < NGLI_ARRAY_NB(pipeline_uniforms); i++) {
@@ -124,6 +145,143 @@ static int register_uniforms(struct pass *s)
     return 0;
 }
 
+static int is_constant_uniform(const struct ngl_node *node)
+{
+    switch (node->class->id) {
+    case NGL_NODE_UNIFORMFLOAT:
+    case NGL_NODE_UNIFORMVEC2:
+    case NGL_NODE_UNIFORMVEC3:
+    case NGL_NODE_UNIFORMVEC4:
+    case NGL_NODE_UNIFORMQUAT:
+    case NGL_NODE_UNIFORMINT:
+    case NGL_NODE_UNIFORMIVEC2:
+    case NGL_NODE_UNIFORMIVEC3:
+    case NGL_NODE_UNIFORMIVEC4:
+    case NGL_NODE_UNIFORMUINT:
+    case NGL_NODE_UNIFORMUIVEC2:
+    case NGL_NODE_UNIFORMUIVEC3:
+    case NGL_NODE_UNIFORMUIVEC4:
+    case NGL_NODE_UNIFORMMAT4: {
+        const struct variable_priv *variable = node->priv_data;
+        return !variable->dynamic;
+    }
+    default:
+        return 0;
+    }
+}
+
+static int specialize_shader(char **dstp, const char *src, const struct darray *constants)
+{
+    *dstp = NULL;
+    if (!src)
+        return 0;
+    return ngli_specialize_uniforms(dstp, src, ngli_darray_data(constants), ngli_darray_count(constants));
+}
+
+/*
+ * Build a variant of the program where the values of the constant uniforms
+ * are compiled in, so they are neither uploaded anymore nor opaque to the
+ * shader compiler
+ */
+static int specialize_program(struct pass *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct pass_params *params = &s->params;
+    if (!params->uniforms)
+        return 0;
+
+    struct darray constants;
+    ngli_darray_init(&constants, sizeof(struct specialize_constant), 0);
+
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(params->uniforms, entry))) {
+        const struct ngl_node *uniform = entry->data;
+        if (!is_constant_uniform(uniform))
+            continue;
+        const struct variable_priv *variable = uniform->priv_data;
+        const struct specialize_constant constant = {
+            .name = entry->key,
+            .type = variable->data_type,
+            .data = variable->data,
+        };
+        if (!ngli_darray_push(&constants, &constant)) {
+            ngli_darray_reset(&constants);
+            return NGL_ERROR_MEMORY;
+        }
+    }
+
+    const struct program_priv *program_priv = params->program->priv_data;
+    char *vertex = NULL, *fragment = NULL, *compute = NULL;
+    int ret;
+    if ((ret = specialize_shader(&vertex, program_priv->vertex, &constants)) < 0 ||
+        (ret = specialize_shader(&fragment, program_priv->fragment, &constants)) < 0 ||
+        (ret = specialize_shader(&compute, program_priv->compute, &constants)) < 0)
+        goto end;
+
+    if (!vertex && !fragment && !compute)
+        goto end;
+
+    struct program *program = &s->specialized_program;
+    if (compute) {
+        ret = ngli_pgcache_get_compute_program(&ctx->pgcache, program, compute);
+    } else {
+        /* The hash of an unspecialized shader is the one of the program node */
+        const uint64_t vertex_hash   = vertex   ? ngli_pgcache_hash_shader(vertex)   : program_priv->vertex_hash;
+        const uint64_t fragment_hash = fragment ? ngli_pgcache_hash_shader(fragment) : program_priv->fragment_hash;
+        ret = ngli_pgcache_get_hashed_graphics_program(&ctx->pgcache, program,
+                                                       vertex ? vertex : program_priv->vertex, vertex_hash,
+                                                       fragment ? fragment : program_priv->fragment, fragment_hash);
+    }
+    if (ret < 0) {
+        LOG(WARNING, "unable to specialize the uniforms of pipeline %s, "
+            "falling back on the generic program", params->label);
+        ret = 0;
+        goto end;
+    }
+
+    /* Uniforms still exposed by the program could not be specialized */
+    const struct specialize_constant *constant = ngli_darray_data(&constants);
+    for (int i = 0; i < ngli_darray_count(&constants); i++) {
+        if (!ngli_hmap_get(program_priv->program.uniforms, constant[i].name) ||
+            ngli_hmap_get(program->uniforms, constant[i].name))
+            continue;
+        struct specialized_uniform specialized_uniform = {
+            .node = ngli_hmap_get(params->uniforms, constant[i].name),
+        };
+        snprintf(specialized_uniform.name, sizeof(specialized_uniform.name), "%s", constant[i].name);
+        const struct variable_priv *variable = specialized_uniform.node->priv_data;
+        memcpy(specialized_uniform.data, variable->data, variable->data_size);
+        if (!ngli_darray_push(&s->specialized_uniforms, &specialized_uniform)) {
+            ret = NGL_ERROR_MEMORY;
+            goto end;
+        }
+    }
+
+    s->pipeline_program = program;
+
+end:
+    ngli_free(compute);
+    ngli_free(fragment);
+    ngli_free(vertex);
+    ngli_darray_reset(&constants);
+    return ret;
+}
+
+static int check_specialized_uniforms(const struct pass *s)
+{
+    const struct specialized_uniform *uniforms = ngli_darray_data(&s->specialized_uniforms);
+    for (int i = 0; i < ngli_darray_count(&s->specialized_uniforms); i++) {
+        const struct specialized_uniform *uniform = &uniforms[i];
+        const struct variable_priv *variable = uniform->node->priv_data;
+        if (memcmp(variable->data, uniform->data, variable->data_size)) {
+            LOG(ERROR, "uniform %s has been specialized in pipeline %s and can not be changed",
+                uniform->name, s->params.label);
+            return NGL_ERROR_INVALID_USAGE;
+        }
+    }
+    return 0;
+}
+
 struct texture_info_field {
     int active;
     int index;
@@ -397,6 +555,23 @@ static int check_attributes(struct pass *s, struct hmap *attributes, int per_ins
     return 0;
 }
 
+static int is_integer_type(int type)
+{
+    switch (type) {
+    case NGLI_TYPE_INT:
+    case NGLI_TYPE_IVEC2:
+    case NGLI_TYPE_IVEC3:
+    case NGLI_TYPE_IVEC4:
+    case NGLI_TYPE_UINT:
+    case NGLI_TYPE_UIVEC2:
+    case NGLI_TYPE_UIVEC3:
+    case NGLI_TYPE_UIVEC4:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
 static int register_attribute(struct pass *s, const char *name, struct ngl_node *attribute, int rate, int warn)
 {
     if (!attribute)
@@ -412,16 +587,30 @@ static int register_attribute(struct pass *s, const char *name, struct ngl_node
         return 0;
     }
 
-    int ret = ngli_node_buffer_ref(attribute);
+    struct buffer_priv *attribute_priv = attribute->priv_data;
+    const int format = attribute_priv->data_format;
+
+    /* Integer formats are fed through glVertexAttribIPointer() which requires integer inputs */
+    struct glcontext *gl = s->ctx->glcontext;
+    int integer;
+    int ret = ngli_format_get_gl_vertex_attrib_format(gl, format, NULL, NULL, &integer);
+    if (ret < 0)
+        return ret;
+    if (integer != is_integer_type(info->type)) {
+        LOG(ERROR, "attribute '%s' buffer is %s while the shader input is %s", name,
+            integer ? "integer" : "floating point",
+            is_integer_type(info->type) ? "integer" : "floating point");
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    ret = ngli_node_buffer_ref(attribute);
     if (ret < 0)
         return ret;
 
-    struct buffer_priv *attribute_priv = attribute->priv_data;
-    const int format = attribute_priv->data_format;
     int stride = attribute_priv->data_stride;
     int offset = 0;
     int class_id = attribute->class->id;
-    struct buffer *buffer = &attribute_priv->buffer;
+    struct buffer *buffer = attribute_priv->buffer;
 
     if (attribute_priv->block) {
         struct block_priv *block_priv = attribute_priv->block->priv_data;
@@ -463,19 +652,181 @@ static int register_attribute(struct pass *s, const char *name, struct ngl_node
     return 0;
 }
 
+#define VERTEX_CACHE_SIZE 16
+#define NB_GEOMETRY_ATTRIBUTES 3
+
+NGLI_STATIC_ASSERT(geometry_attributes, NB_GEOMETRY_ATTRIBUTES <= NGLI_GEOMOPT_MAX_ATTRIBUTES);
+
+static int can_optimize_geometry(const struct geometry_priv *geometry)
+{
+    if (geometry->topology != NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST) {
+        LOG(WARNING, "only triangle list geometries can be optimized");
+        return 0;
+    }
+
+    const struct ngl_node *buffers[] = {
+        geometry->vertices_buffer,
+        geometry->uvcoords_buffer,
+        geometry->normals_buffer,
+        geometry->indices_buffer,
+    };
+    for (int i = 0; i < NGLI_ARRAY_NB(buffers); i++) {
+        if (!buffers[i])
+            continue;
+        const struct buffer_priv *buffer_priv = buffers[i]->priv_data;
+        if (buffer_priv->dynamic || buffer_priv->block) {
+            LOG(WARNING, "geometries with animated or block buffers can not be optimized");
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static uint32_t *get_indices_u32(const struct buffer_priv *indices)
+{
+    uint32_t *dst = ngli_malloc(indices->count * sizeof(*dst));
+    if (!dst)
+        return NULL;
+    if (indices->data_format == NGLI_FORMAT_R16_UNORM) {
+        const uint16_t *src = (const uint16_t *)indices->data;
+        for (int i = 0; i < indices->count; i++)
+            dst[i] = src[i];
+    } else {
+        memcpy(dst, indices->data, indices->count * sizeof(*dst));
+    }
+    return dst;
+}
+
+/*
+ * Render the geometry attributes used by the program from a single
+ * interleaved vertex buffer, with deduplicated vertices and triangles
+ * reordered for the post-transform vertex cache. The result is shared
+ * through the geometry cache between all the passes using the same data.
+ */
+static int init_optimized_geometry(struct pass *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    const struct pass_params *params = &s->params;
+    const struct geometry_priv *geometry_priv = params->geometry->priv_data;
+
+    if (!can_optimize_geometry(geometry_priv))
+        return 0;
+
+    static const char * const names[NB_GEOMETRY_ATTRIBUTES] = {"ngl_position", "ngl_uvcoord", "ngl_normal"};
+    const struct ngl_node *nodes[NB_GEOMETRY_ATTRIBUTES] = {
+        geometry_priv->vertices_buffer,
+        geometry_priv->uvcoords_buffer,
+        geometry_priv->normals_buffer,
+    };
+
+    const struct hmap *infos = s->pipeline_program->attributes;
+    const struct program_variable_info *attribute_infos[NGLI_GEOMOPT_MAX_ATTRIBUTES];
+    const struct buffer_priv *attribute_privs[NGLI_GEOMOPT_MAX_ATTRIBUTES];
+    struct geomopt_attribute attributes[NGLI_GEOMOPT_MAX_ATTRIBUTES];
+    int nb_attributes = 0;
+    for (int i = 0; i < NGLI_ARRAY_NB(nodes); i++) {
+        const struct program_variable_info *info = ngli_hmap_get(infos, names[i]);
+        if (!nodes[i] || !info)
+            continue;
+        const struct buffer_priv *buffer_priv = nodes[i]->priv_data;
+        attribute_infos[nb_attributes] = info;
+        attribute_privs[nb_attributes] = buffer_priv;
+        attributes[nb_attributes] = (struct geomopt_attribute){
+            .data   = buffer_priv->data,
+            .stride = buffer_priv->data_stride,
+            .size   = buffer_priv->data_stride,
+        };
+        nb_attributes++;
+    }
+    if (!nb_attributes)
+        return 0;
+
+    uint32_t *indices = NULL;
+    int nb_indices = 0;
+    if (geometry_priv->indices_buffer) {
+        const struct buffer_priv *indices_priv = geometry_priv->indices_buffer->priv_data;
+        indices = get_indices_u32(indices_priv);
+        if (!indices)
+            return NGL_ERROR_MEMORY;
+        nb_indices = indices_priv->count;
+    }
+
+    const struct buffer_priv *vertices_priv = geometry_priv->vertices_buffer->priv_data;
+    const struct geomopt_params geomopt_params = {
+        .attributes    = attributes,
+        .nb_attributes = nb_attributes,
+        .nb_vertices   = vertices_priv->count,
+        .indices       = indices,
+        .nb_indices    = nb_indices,
+        /* Merging vertices would break the indexing of the extra attributes */
+        .dedup         = !params->attributes || !ngli_hmap_count(params->attributes),
+        .cache_size    = VERTEX_CACHE_SIZE,
+    };
+    int ret = ngli_geomcache_get_geometry(&ctx->geomcache, &s->optimized_geometry, &geomopt_params);
+    ngli_free(indices);
+    if (ret < 0)
+        return ret;
+
+    struct optimized_geometry *geometry = s->optimized_geometry;
+    for (int i = 0; i < nb_attributes; i++) {
+        const struct program_variable_info *info = attribute_infos[i];
+        struct pipeline_attribute pipeline_attribute = {
+            .location = info->location,
+            .format   = attribute_privs[i]->data_format,
+            .stride   = geometry->stride,
+            .offset   = geometry->offsets[i],
+            .buffer   = &geometry->vertices,
+        };
+        snprintf(pipeline_attribute.name, sizeof(pipeline_attribute.name), "%s", names[i]);
+
+        if (!ngli_darray_push(&s->pipeline_attributes, &pipeline_attribute))
+            return NGL_ERROR_MEMORY;
+    }
+
+    return 0;
+}
+
+static int register_batch_attributes(struct pass *s)
+{
+    const struct pass_params *params = &s->params;
+    for (int i = 0; i < params->nb_batch_attributes; i++) {
+        if (!ngli_darray_push(&s->pipeline_attributes, &params->batch_attributes[i]))
+            return NGL_ERROR_MEMORY;
+    }
+    return 0;
+}
+
 static int pass_graphics_init(struct pass *s)
 {
     const struct pass_params *params = &s->params;
 
     s->pipeline_type = NGLI_PIPELINE_TYPE_GRAPHICS;
 
+    /* Merged geometries of batched Render nodes, with all their vertex attributes */
+    if (params->batch_graphics) {
+        s->pipeline_graphics = *params->batch_graphics;
+        return register_batch_attributes(s);
+    }
+
     struct geometry_priv *geometry_priv = params->geometry->priv_data;
     struct pipeline_graphics *graphics = &s->pipeline_graphics;
 
     graphics->topology = geometry_priv->topology;
     graphics->nb_instances = s->params.nb_instances;
 
-    if (geometry_priv->indices_buffer) {
+    if (geometry_priv->optimize) {
+        int ret = init_optimized_geometry(s);
+        if (ret < 0)
+            return ret;
+    }
+
+    if (s->optimized_geometry) {
+        struct optimized_geometry *geometry = s->optimized_geometry;
+        graphics->nb_indices = geometry->nb_indices;
+        graphics->indices_format = geometry->indices_format;
+        graphics->indices = &geometry->indices;
+    } else if (geometry_priv->indices_buffer) {
         struct ngl_node *indices = geometry_priv->indices_buffer;
         int ret = ngli_node_buffer_ref(indices);
         if (ret < 0)
@@ -488,11 +839,11 @@ static int pass_graphics_init(struct pass *s)
         }
 
         s->indices = indices;
-        s->indices_buffer = &indices_priv->buffer;
+        s->indices_buffer = indices_priv->buffer;
 
         graphics->nb_indices = indices_priv->count;
         graphics->indices_format = indices_priv->data_format;
-        graphics->indices = &indices_priv->buffer;
+        graphics->indices = indices_priv->buffer;
     } else {
         struct ngl_node *vertices = geometry_priv->vertices_buffer;
         struct buffer_priv *buffer_priv = vertices->priv_data;
@@ -504,9 +855,10 @@ static int pass_graphics_init(struct pass *s)
         (ret = check_attributes(s, params->instance_attributes, 1)) < 0)
         return ret;
 
-    if ((ret = register_attribute(s, "ngl_position", geometry_priv->vertices_buffer, 0, 0)) < 0 ||
-        (ret = register_attribute(s, "ngl_uvcoord",  geometry_priv->uvcoords_buffer, 0, 0)) < 0 ||
-        (ret = register_attribute(s, "ngl_normal",   geometry_priv->normals_buffer,  0, 0)) < 0)
+    if (!s->optimized_geometry &&
+        ((ret = register_attribute(s, "ngl_position", geometry_priv->vertices_buffer, 0, 0)) < 0 ||
+         (ret = register_attribute(s, "ngl_uvcoord",  geometry_priv->uvcoords_buffer, 0, 0)) < 0 ||
+         (ret = register_attribute(s, "ngl_normal",   geometry_priv->normals_buffer,  0, 0)) < 0))
         return ret;
 
     if (params->attributes) {
@@ -527,7 +879,7 @@ static int pass_graphics_init(struct pass *s)
         }
     }
 
-    return 0;
+    return register_batch_attributes(s);
 }
 
 static int pass_compute_init(struct pass *s)
@@ -578,6 +930,8 @@ int ngli_pass_prepare(struct pass *s)
     desc->modelview_matrix_index = ngli_pipeline_get_uniform_index(pipeline, "ngl_modelview_matrix");
     desc->projection_matrix_index = ngli_pipeline_get_uniform_index(pipeline, "ngl_projection_matrix");
     desc->normal_matrix_index = ngli_pipeline_get_uniform_index(pipeline, "ngl_normal_matrix");
+    desc->time_index = ngli_pipeline_get_uniform_index(pipeline, "ngl_time");
+    desc->normal_matrix_version = -1;
 
     ngli_darray_init(&desc->texture_infos, sizeof(struct texture_info), 0);
 
@@ -628,11 +982,26 @@ int ngli_pass_init(struct pass *s, struct ngl_ctx *ctx, const struct pass_params
 
     ngli_darray_init(&s->pipeline_descs, sizeof(struct pipeline_desc), 0);
 
+    ngli_darray_init(&s->specialized_uniforms, sizeof(struct specialized_uniform), 0);
+
+    /* The bounding box of the geometry does not tell where the instances are drawn */
+    if (params->culling && (params->nb_instances > 1 || params->instance_attributes)) {
+        LOG(ERROR, "culling can not be combined with instancing in pipeline %s", params->label);
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
     struct program_priv *program_priv = params->program->priv_data;
-    s->pipeline_program = &program_priv->program;
+    s->pipeline_program = params->batch_program ? params->batch_program : &program_priv->program;
 
-    int ret = params->geometry ? pass_graphics_init(s)
-                               : pass_compute_init(s);
+    int ret;
+    if (params->specialize_uniforms && !params->batch_program) {
+        ret = specialize_program(s);
+        if (ret < 0)
+            return ret;
+    }
+
+    ret = params->geometry ? pass_graphics_init(s)
+                           : pass_compute_init(s);
     if (ret < 0)
         return ret;
 
@@ -685,6 +1054,7 @@ void ngli_pass_uninit(struct pass *s)
 
     if (s->indices)
         ngli_node_buffer_unref(s->indices);
+    ngli_geomcache_release_geometry(&s->ctx->geomcache, &s->optimized_geometry);
 
     ngli_darray_reset(&s->uniform_nodes);
     ngli_darray_reset(&s->texture_nodes);
@@ -699,6 +1069,8 @@ void ngli_pass_uninit(struct pass *s)
     ngli_darray_reset(&s->pipeline_buffers);
 
     ngli_pgcache_release_program(&s->default_program);
+    ngli_pgcache_release_program(&s->specialized_program);
+    ngli_darray_reset(&s->specialized_uniforms);
 
     memset(s, 0, sizeof(*s));
 }
@@ -736,16 +1108,39 @@ DECLARE_UPDATE_NODES_FUNC(buffer, NODE_TYPE_BUFFER)
 
 int ngli_pass_update(struct pass *s, double t)
 {
+    s->cull_count = 0;
+
     int ret;
-    if ((ret = update_common_nodes(&s->uniform_nodes, t)) < 0 ||
+    if ((ret = check_specialized_uniforms(s)) < 0 ||
+        (ret = update_common_nodes(&s->uniform_nodes, t)) < 0 ||
         (ret = update_common_nodes(&s->texture_nodes, t)) < 0 ||
         (ret = update_block_nodes(&s->block_nodes, t)) < 0 ||
         (ret = update_buffer_nodes(&s->attribute_nodes, t)))
         return ret;
 
+    if (s->params.culling) {
+        struct ngl_node *geometry = s->params.geometry;
+        const struct geometry_priv *geometry_priv = geometry->priv_data;
+        const struct buffer_priv *vertices = geometry_priv->vertices_buffer->priv_data;
+        if (vertices->dynamic)
+            ngli_node_geometry_update_bounds(geometry);
+    }
+
     return 0;
 }
 
+/* Whether the geometry bounding box intersects the view frustum */
+static int is_visible(const struct pass *s, const float *modelview_matrix, const float *projection_matrix)
+{
+    const struct geometry_priv *geometry_priv = s->params.geometry->priv_data;
+    if (!geometry_priv->has_bounds)
+        return 1;
+
+    NGLI_ALIGNED_MAT(mvp);
+    ngli_mat4_mul(mvp, projection_matrix, modelview_matrix);
+    return ngli_bounds_is_visible(&geometry_priv->bounds, mvp);
+}
+
 int ngli_pass_exec(struct pass *s)
 {
     struct ngl_ctx *ctx = s->ctx;
@@ -756,15 +1151,32 @@ int ngli_pass_exec(struct pass *s)
     const float *modelview_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
     const float *projection_matrix = ngli_darray_tail(&ctx->projection_matrix_stack);
 
+    struct ngl_stats *stats = &ctx->stats;
+    if (s->params.culling && !is_visible(s, modelview_matrix, projection_matrix)) {
+        stats->draws_culled++;
+        s->cull_count++;
+        return 0;
+    }
+
     ngli_pipeline_update_uniform(pipeline, desc->modelview_matrix_index, modelview_matrix);
     ngli_pipeline_update_uniform(pipeline, desc->projection_matrix_index, projection_matrix);
 
     if (desc->normal_matrix_index >= 0) {
-        float normal_matrix[3*3];
-        ngli_mat3_from_mat4(normal_matrix, modelview_matrix);
-        ngli_mat3_inverse(normal_matrix, normal_matrix);
-        ngli_mat3_transpose(normal_matrix, normal_matrix);
-        ngli_pipeline_update_uniform(pipeline, desc->normal_matrix_index, normal_matrix);
+        /* Only derive the normal matrix again if the modelview changed */
+        const int64_t *modelview_version = ngli_darray_tail(&ctx->modelview_version_stack);
+        if (desc->normal_matrix_version != *modelview_version) {
+            float *normal_matrix = desc->normal_matrix;
+            ngli_mat3_from_mat4(normal_matrix, modelview_matrix);
+            ngli_mat3_inverse(normal_matrix, normal_matrix);
+            ngli_mat3_transpose(normal_matrix, normal_matrix);
+            desc->normal_matrix_version = *modelview_version;
+        }
+        ngli_pipeline_update_uniform(pipeline, desc->normal_matrix_index, desc->normal_matrix);
+    }
+
+    if (desc->time_index >= 0) {
+        const float frame_time = ctx->frame_time;
+        ngli_pipeline_update_uniform(pipeline, desc->time_index, &frame_time);
     }
 
     struct texture_info *texture_infos = ngli_darray_data(&desc->texture_infos);
@@ -804,7 +1216,12 @@ int ngli_pass_exec(struct pass *s)
         ngli_pipeline_update_uniform(pipeline, info->sampling_mode.index, &layout);
     }
 
-    ngli_pipeline_exec(pipeline);
+    int ret = ngli_pipeline_exec(pipeline);
+    if (ret < 0)
+        return ret;
+
+    if (s->pipeline_type == NGLI_PIPELINE_TYPE_GRAPHICS)
+        stats->draws_issued++;
 
     return 0;
 }
@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include "darray.h"
+#include "geomcache.h"
 #include "pipeline.h"
 #include "program.h"
 
@@ -35,12 +36,20 @@ struct pass_params {
     struct hmap *textures;
     struct hmap *uniforms;
     struct hmap *blocks;
+    int specialize_uniforms;
 
     /* graphics */
     struct ngl_node *geometry;
     int nb_instances;
     struct hmap *attributes;
     struct hmap *instance_attributes;
+    int culling;
+
+    /* graphics, instanced draw of batched Render nodes (see batch.c) */
+    struct program *batch_program;
+    const struct pipeline_attribute *batch_attributes;
+    int nb_batch_attributes;
+    const struct pipeline_graphics *batch_graphics;
 
     /* compute */
     int nb_group_x;
@@ -58,6 +67,8 @@ struct pass {
     struct pass_params params;
 
     struct program default_program;
+    struct program specialized_program;
+    struct darray specialized_uniforms;
 
     struct darray attribute_nodes;
     struct darray texture_nodes;
@@ -68,6 +79,7 @@ struct pass {
 
     struct ngl_node *indices;
     struct buffer *indices_buffer;
+    struct optimized_geometry *optimized_geometry;
 
     int pipeline_type;
     struct program *pipeline_program;
@@ -78,6 +90,9 @@ struct pass {
     struct darray pipeline_textures;
     struct darray pipeline_buffers;
     struct darray pipeline_descs;
+
+    /* Draws skipped by the culling, reset along with the node draw count */
+    int cull_count;
 };
 
 int ngli_pass_init(struct pass *s, struct ngl_ctx *ctx, const struct pass_params *params);
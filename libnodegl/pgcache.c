@@ -19,112 +19,593 @@
  * under the License.
  */
 
+#define _POSIX_C_SOURCE 200809L // mkstemp()
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
 
+#include "log.h"
 #include "memory.h"
 #include "nodes.h"
 #include "pgcache.h"
 #include "utils.h"
 
-static void reset_cached_program(void *user_arg, void *data)
+static void free_entry(struct pgcache_entry *entry)
 {
-    struct program *p = data;
-    ngli_program_reset(p);
-    ngli_free(p);
+    ngli_program_reset(&entry->program);
+    ngli_free(entry->vert);
+    ngli_free(entry->frag);
+    ngli_free(entry->comp);
+    ngli_free(entry);
 }
 
-static void reset_cached_frag_map(void *user_arg, void *data)
+static void reset_cached_program(void *user_arg, void *data)
 {
-    struct hmap *p = data;
-    ngli_hmap_freep(&p);
+    free_entry(data);
 }
 
 int ngli_pgcache_init(struct pgcache *s, struct ngl_ctx *ctx)
 {
     s->ctx = ctx;
-    s->graphics_cache = ngli_hmap_create();
-    s->compute_cache = ngli_hmap_create();
-    if (!s->graphics_cache || !s->compute_cache)
+    s->programs = ngli_hmap_create();
+    if (!s->programs)
         return NGL_ERROR_MEMORY;
-    ngli_hmap_set_free(s->graphics_cache, reset_cached_frag_map, s);
-    ngli_hmap_set_free(s->compute_cache, reset_cached_program, s);
+    ngli_hmap_set_free(s->programs, reset_cached_program, s);
+
+    const char *cache_dir = ctx->config.program_cache_dir;
+    if (!cache_dir)
+        return 0;
+
+    struct glcontext *gl = ctx->glcontext;
+    if (!gl->program_binary) {
+        LOG(WARNING, "program binaries are not supported by the context, "
+            "the program cache directory will be ignored");
+        return 0;
+    }
+
+    /* Anything that can affect the compiled programs is part of the cache key */
+    s->cache_dir = ngli_strdup(cache_dir);
+    s->driver_id = ngli_asprintf("%s\n%s\n%s\nbackend=%d version=%d features=0x%x",
+                                 (const char *)ngli_glGetString(gl, GL_VENDOR),
+                                 (const char *)ngli_glGetString(gl, GL_RENDERER),
+                                 (const char *)ngli_glGetString(gl, GL_VERSION),
+                                 gl->backend, gl->version, gl->features);
+    if (!s->cache_dir || !s->driver_id)
+        return NGL_ERROR_MEMORY;
+
     return 0;
 }
 
-static int query_cache(struct pgcache *s, struct program *dst,
-                       struct hmap *cache, const char *cache_key,
-                       const char *vert, const char *frag, const char *comp)
+#define DISK_CACHE_MAGIC "ngl-pg01"
+
+enum {
+    KEY_DRIVER,
+    KEY_VERT,
+    KEY_FRAG,
+    KEY_COMP,
+    KEY_NB
+};
+
+static void get_key(const struct pgcache *s, const char **key,
+                    const char *vert, const char *frag, const char *comp)
+{
+    key[KEY_DRIVER] = s->driver_id;
+    key[KEY_VERT]   = vert ? vert : "";
+    key[KEY_FRAG]   = frag ? frag : "";
+    key[KEY_COMP]   = comp ? comp : "";
+}
+
+static char *get_cache_path(const struct pgcache *s, const char **key)
+{
+    uint64_t hash = NGLI_FNV1A64_INIT;
+    for (int i = 0; i < KEY_NB; i++)
+        hash = ngli_fnv1a64(hash, key[i], strlen(key[i]) + 1);
+    return ngli_asprintf("%s/%016" PRIx64 ".bin", s->cache_dir, hash);
+}
+
+/*
+ * The complete key is stored at the beginning of each cache entry so hash
+ * collisions can be detected when loading it back
+ */
+static uint8_t *get_header(const char **key, int *sizep)
+{
+    int size = sizeof(DISK_CACHE_MAGIC) - 1;
+    for (int i = 0; i < KEY_NB; i++)
+        size += strlen(key[i]) + 1;
+
+    uint8_t *header = ngli_malloc(size);
+    if (!header)
+        return NULL;
+
+    uint8_t *dst = header;
+    memcpy(dst, DISK_CACHE_MAGIC, sizeof(DISK_CACHE_MAGIC) - 1);
+    dst += sizeof(DISK_CACHE_MAGIC) - 1;
+    for (int i = 0; i < KEY_NB; i++) {
+        const int len = strlen(key[i]) + 1;
+        memcpy(dst, key[i], len);
+        dst += len;
+    }
+
+    *sizep = size;
+    return header;
+}
+
+static int read_file(const char *path, uint8_t **datap, int *sizep)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NGL_ERROR_NOT_FOUND;
+
+    int ret = 0;
+    uint8_t *data = NULL;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size > INT32_MAX) {
+        ret = NGL_ERROR_IO;
+        goto end;
+    }
+
+    const int size = st.st_size;
+    data = ngli_malloc(size);
+    if (!data) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    int pos = 0;
+    while (pos < size) {
+        const ssize_t n = read(fd, data + pos, size - pos);
+        if (n <= 0) {
+            ret = NGL_ERROR_IO;
+            goto end;
+        }
+        pos += n;
+    }
+
+    *datap = data;
+    *sizep = size;
+    data = NULL;
+
+end:
+    ngli_free(data);
+    close(fd);
+    return ret;
+}
+
+static int write_all(int fd, const uint8_t *data, int size)
+{
+    while (size > 0) {
+        const ssize_t n = write(fd, data, size);
+        if (n <= 0)
+            return NGL_ERROR_IO;
+        data += n;
+        size -= n;
+    }
+    return 0;
+}
+
+static int load_program(struct pgcache *s, struct program *dst, const char **key)
+{
+    char *path = get_cache_path(s, key);
+    if (!path)
+        return NGL_ERROR_MEMORY;
+
+    int header_size;
+    uint8_t *header = get_header(key, &header_size);
+    if (!header) {
+        ngli_free(path);
+        return NGL_ERROR_MEMORY;
+    }
+
+    uint8_t *data = NULL;
+    int size = 0;
+    int ret = read_file(path, &data, &size);
+    if (ret < 0)
+        goto end;
+
+    if (size < header_size || memcmp(data, header, header_size)) {
+        ret = NGL_ERROR_INVALID_DATA;
+    } else {
+        ret = ngli_program_init_serialized(dst, s->ctx, data + header_size, size - header_size);
+    }
+
+    /* Entries which can not be loaded anymore (driver update, corrupted
+     * file, ...) are removed so they get written again */
+    if (ret == NGL_ERROR_INVALID_DATA) {
+        LOG(DEBUG, "removing stale program cache entry %s", path);
+        unlink(path);
+    } else if (ret == 0) {
+        LOG(DEBUG, "program loaded from cache entry %s", path);
+    }
+
+end:
+    ngli_free(data);
+    ngli_free(header);
+    ngli_free(path);
+    return ret;
+}
+
+static int store_program(struct pgcache *s, const struct program *program, const char **key)
+{
+    char *path = get_cache_path(s, key);
+    char *tmp_path = path ? ngli_asprintf("%s.XXXXXX", path) : NULL;
+    int header_size;
+    uint8_t *header = get_header(key, &header_size);
+    uint8_t *data = NULL;
+    int size;
+    int fd = -1;
+    int ret = 0;
+
+    if (!path || !tmp_path || !header) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    ret = ngli_program_serialize(program, &data, &size);
+    if (ret < 0)
+        goto end;
+
+    /* The entry is written to a unique temporary file and then atomically
+     * renamed so concurrent readers and writers never see a partial entry */
+    fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        /* Do not unlink whatever file the template ended up naming */
+        ngli_free(tmp_path);
+        tmp_path = NULL;
+        ret = NGL_ERROR_IO;
+        goto end;
+    }
+
+#if !defined(TARGET_MINGW_W64)
+    /* mkstemp() creates the file with 0600 permissions */
+    if (fchmod(fd, 0644) < 0) {
+        ret = NGL_ERROR_IO;
+        goto end;
+    }
+#endif
+
+    if ((ret = write_all(fd, header, header_size)) < 0 ||
+        (ret = write_all(fd, data, size)) < 0)
+        goto end;
+
+    if (close(fd) < 0) {
+        fd = -1;
+        ret = NGL_ERROR_IO;
+        goto end;
+    }
+    fd = -1;
+
+#if defined(TARGET_MINGW_W64)
+    /* rename() does not replace an existing file on Windows */
+    if (rename(tmp_path, path) < 0 && (unlink(path) < 0 || rename(tmp_path, path) < 0))
+        ret = NGL_ERROR_IO;
+#else
+    if (rename(tmp_path, path) < 0)
+        ret = NGL_ERROR_IO;
+#endif
+
+end:
+    if (fd >= 0)
+        close(fd);
+    if (ret < 0 && tmp_path)
+        unlink(tmp_path);
+    ngli_free(data);
+    ngli_free(header);
+    ngli_free(tmp_path);
+    ngli_free(path);
+    return ret;
+}
+
+/* Maximum number of programs kept alive by the cache, including unused ones */
+#define MAX_PROGRAMS 64
+
+static void lru_remove(struct pgcache *s, struct pgcache_entry *entry)
+{
+    if (entry->prev)
+        entry->prev->next = entry->next;
+    else
+        s->lru_first = entry->next;
+    if (entry->next)
+        entry->next->prev = entry->prev;
+    else
+        s->lru_last = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+static void lru_push(struct pgcache *s, struct pgcache_entry *entry)
+{
+    entry->prev = NULL;
+    entry->next = s->lru_first;
+    if (s->lru_first)
+        s->lru_first->prev = entry;
+    else
+        s->lru_last = entry;
+    s->lru_first = entry;
+}
+
+/*
+ * Destroy the least recently used programs which are not referenced anymore
+ * until at most max_programs remain in the cache. Programs still pending have
+ * been prefetched and are about to be requested so they are kept.
+ */
+static void evict_programs(struct pgcache *s, int max_programs)
+{
+    struct pgcache_entry *entry = s->lru_last;
+    while (entry && ngli_hmap_count(s->programs) > max_programs) {
+        struct pgcache_entry *prev = entry->prev;
+        if (!entry->program.pending) {
+            lru_remove(s, entry);
+            ngli_hmap_set(s->programs, entry->key, NULL);
+            s->ctx->stats.program_cache_evictions++;
+        }
+        entry = prev;
+    }
+}
+
+static int same_source(const char *a, const char *b)
 {
-    struct program *cached_program = ngli_hmap_get(cache, cache_key);
-    if (cached_program) {
-        /* make sure the cached program has not been reset by the user */
-        ngli_assert(cached_program->ctx);
+    return a == b || (a && b && !strcmp(a, b));
+}
+
+static struct pgcache_entry *create_entry(struct pgcache *s, const char *cache_key,
+                                          const char *vert, const char *frag, const char *comp)
+{
+    struct pgcache_entry *entry = ngli_calloc(1, sizeof(*entry));
+    if (!entry)
+        return NULL;
+    entry->cache = s;
+    snprintf(entry->key, sizeof(entry->key), "%s", cache_key);
+    entry->vert = vert ? ngli_strdup(vert) : NULL;
+    entry->frag = frag ? ngli_strdup(frag) : NULL;
+    entry->comp = comp ? ngli_strdup(comp) : NULL;
+    if ((vert && !entry->vert) || (frag && !entry->frag) || (comp && !entry->comp)) {
+        free_entry(entry);
+        return NULL;
+    }
+    return entry;
+}
 
-        memcpy(dst, cached_program, sizeof(*dst));
+/*
+ * Look up the program in the cache, or create it. A newly created program is
+ * either loaded from the disk cache or only submitted to the driver, its link
+ * result being checked by query_cache().
+ *
+ * In the unlikely event of a hash collision, the program is not shared: it
+ * gets a private entry (with an empty key) destroyed with its last reference.
+ * Such entries are never created for prefetching since nobody would own them.
+ */
+static int get_cached_program(struct pgcache *s, struct pgcache_entry **entryp, const char *cache_key,
+                              const char *vert, const char *frag, const char *comp, int prefetch)
+{
+    struct pgcache_entry *entry = ngli_hmap_get(s->programs, cache_key);
+    if (entry && same_source(entry->vert, vert) &&
+                 same_source(entry->frag, frag) &&
+                 same_source(entry->comp, comp)) {
+        if (!entry->refcount) {
+            lru_remove(s, entry);
+            lru_push(s, entry);
+        }
+        *entryp = entry;
         return 0;
     }
 
+    const int collision = entry != NULL;
+    if (collision) {
+        LOG(DEBUG, "program hash collision on %s", cache_key);
+        if (prefetch) {
+            *entryp = NULL;
+            return 0;
+        }
+    }
+
+    s->ctx->stats.program_cache_misses++;
+
     /* this is free'd by the reset_cached_program() when destroying the cache */
-    struct program *new_program = ngli_calloc(1, sizeof(*new_program));
-    if (!new_program)
+    entry = create_entry(s, cache_key, vert, frag, comp);
+    if (!entry)
         return NGL_ERROR_MEMORY;
 
-    int ret = ngli_program_init(new_program, s->ctx, vert, frag, comp);
-    if (ret < 0) {
-        ngli_free(new_program);
-        return ret;
+    struct program *program = &entry->program;
+    int ret = NGL_ERROR_NOT_FOUND;
+    if (s->cache_dir) {
+        const char *key[KEY_NB];
+        get_key(s, key, vert, frag, comp);
+        ret = load_program(s, program, key);
+        if (ret < 0 && ret != NGL_ERROR_NOT_FOUND && ret != NGL_ERROR_INVALID_DATA)
+            goto fail;
     }
 
-    ret = ngli_hmap_set(cache, cache_key, new_program);
     if (ret < 0) {
-        ngli_program_reset(new_program);
-        ngli_free(new_program);
-        return ret;
+        ret = ngli_program_submit(program, s->ctx, vert, frag, comp);
+        if (ret < 0)
+            goto fail;
+    }
+
+    if (collision) {
+        entry->key[0] = 0;
+        *entryp = entry;
+        return 0;
     }
 
-    memcpy(dst, new_program, sizeof(*dst));
+    /* Make room for the new program */
+    evict_programs(s, MAX_PROGRAMS - 1);
+
+    ret = ngli_hmap_set(s->programs, cache_key, entry);
+    if (ret < 0)
+        goto fail;
+    lru_push(s, entry);
+
+    *entryp = entry;
     return 0;
+
+fail:
+    free_entry(entry);
+    return ret;
 }
 
-int ngli_pgcache_get_graphics_program(struct pgcache *s, struct program *dst, const char *vert, const char *frag)
+static int query_cache(struct pgcache *s, struct program *dst, const char *cache_key,
+                       const char *vert, const char *frag, const char *comp)
 {
-    /*
-     * The first dimension of the graphics_cache hmap is another hmap: what we
-     * do is basically graphics_cache[vert][frag] to obtain the program. If the
-     * 2nd hmap is not yet allocated, we do create a new one here.
-     */
-    struct hmap *frag_map = ngli_hmap_get(s->graphics_cache, vert);
-    if (!frag_map) {
-        frag_map = ngli_hmap_create();
-        if (!frag_map)
-            return NGL_ERROR_MEMORY;
-        ngli_hmap_set_free(frag_map, reset_cached_program, s);
-
-        int ret = ngli_hmap_set(s->graphics_cache, vert, frag_map);
+    struct pgcache_entry *entry;
+    int ret = get_cached_program(s, &entry, cache_key, vert, frag, comp, 0);
+    if (ret < 0)
+        return ret;
+
+    const int shared = entry->key[0];
+    struct program *program = &entry->program;
+    if (program->pending) {
+        ret = ngli_program_wait(program);
         if (ret < 0) {
-            ngli_hmap_freep(&frag_map);
-            return NGL_ERROR_MEMORY;
+            if (shared) {
+                lru_remove(s, entry);
+                ngli_hmap_set(s->programs, cache_key, NULL);
+            } else {
+                free_entry(entry);
+            }
+            return ret;
+        }
+
+        if (s->cache_dir) {
+            const char *key[KEY_NB];
+            get_key(s, key, vert, frag, comp);
+            ret = store_program(s, program, key);
+            if (ret < 0)
+                LOG(WARNING, "unable to store program in the cache directory %s: %s",
+                    s->cache_dir, NGLI_RET_STR(ret));
         }
     }
 
-    return query_cache(s, dst, frag_map, frag, vert, frag, NULL);
+    /* make sure the cached program has not been reset by the user */
+    ngli_assert(program->ctx);
+
+    /* The first request of a program is accounted as a miss when creating it */
+    if (entry->requested)
+        s->ctx->stats.program_cache_hits++;
+    entry->requested = 1;
+
+    /* Unused programs are the only ones tracked for eviction */
+    if (!entry->refcount++ && shared)
+        lru_remove(s, entry);
+
+    memcpy(dst, program, sizeof(*dst));
+    dst->cache_entry = entry;
+    return 0;
+}
+
+/*
+ * Programs are identified by the 64-bit hashes of their shaders, the sources
+ * being compared only on a hit. Callers requesting the same sources many times
+ * (such as the Program nodes) compute these hashes once and use the hashed
+ * variants of the functions below.
+ */
+uint64_t ngli_pgcache_hash_shader(const char *src)
+{
+    return ngli_fnv1a64(NGLI_FNV1A64_INIT, src, strlen(src));
+}
+
+static void get_graphics_key(char *dst, size_t size, uint64_t vert_hash, uint64_t frag_hash)
+{
+    snprintf(dst, size, "%016" PRIx64 ":%016" PRIx64, vert_hash, frag_hash);
+}
+
+static void get_compute_key(char *dst, size_t size, uint64_t comp_hash)
+{
+    snprintf(dst, size, "%016" PRIx64, comp_hash);
+}
+
+int ngli_pgcache_get_hashed_graphics_program(struct pgcache *s, struct program *dst,
+                                             const char *vert, uint64_t vert_hash,
+                                             const char *frag, uint64_t frag_hash)
+{
+    char cache_key[PGCACHE_KEY_SIZE];
+    get_graphics_key(cache_key, sizeof(cache_key), vert_hash, frag_hash);
+    return query_cache(s, dst, cache_key, vert, frag, NULL);
+}
+
+int ngli_pgcache_get_graphics_program(struct pgcache *s, struct program *dst, const char *vert, const char *frag)
+{
+    return ngli_pgcache_get_hashed_graphics_program(s, dst, vert, ngli_pgcache_hash_shader(vert),
+                                                    frag, ngli_pgcache_hash_shader(frag));
+}
+
+int ngli_pgcache_prefetch_hashed_graphics_program(struct pgcache *s,
+                                                  const char *vert, uint64_t vert_hash,
+                                                  const char *frag, uint64_t frag_hash)
+{
+    char cache_key[PGCACHE_KEY_SIZE];
+    get_graphics_key(cache_key, sizeof(cache_key), vert_hash, frag_hash);
+
+    struct pgcache_entry *entry;
+    return get_cached_program(s, &entry, cache_key, vert, frag, NULL, 1);
+}
+
+int ngli_pgcache_prefetch_graphics_program(struct pgcache *s, const char *vert, const char *frag)
+{
+    return ngli_pgcache_prefetch_hashed_graphics_program(s, vert, ngli_pgcache_hash_shader(vert),
+                                                         frag, ngli_pgcache_hash_shader(frag));
+}
+
+int ngli_pgcache_get_hashed_compute_program(struct pgcache *s, struct program *dst,
+                                            const char *comp, uint64_t comp_hash)
+{
+    char cache_key[PGCACHE_KEY_SIZE];
+    get_compute_key(cache_key, sizeof(cache_key), comp_hash);
+    return query_cache(s, dst, cache_key, NULL, NULL, comp);
 }
 
 int ngli_pgcache_get_compute_program(struct pgcache *s, struct program *dst, const char *comp)
 {
-    return query_cache(s, dst, s->compute_cache, comp, NULL, NULL, comp);
+    return ngli_pgcache_get_hashed_compute_program(s, dst, comp, ngli_pgcache_hash_shader(comp));
+}
+
+int ngli_pgcache_prefetch_hashed_compute_program(struct pgcache *s, const char *comp, uint64_t comp_hash)
+{
+    /* Unsupported compute programs are reported when they are requested */
+    const struct glcontext *gl = s->ctx->glcontext;
+    if ((gl->features & NGLI_FEATURE_COMPUTE_SHADER_ALL) != NGLI_FEATURE_COMPUTE_SHADER_ALL)
+        return 0;
+
+    char cache_key[PGCACHE_KEY_SIZE];
+    get_compute_key(cache_key, sizeof(cache_key), comp_hash);
+
+    struct pgcache_entry *entry;
+    return get_cached_program(s, &entry, cache_key, NULL, NULL, comp, 1);
 }
 
 void ngli_pgcache_reset(struct pgcache *s)
 {
     if (!s->ctx)
         return;
-    ngli_hmap_freep(&s->compute_cache);
-    ngli_hmap_freep(&s->graphics_cache);
+    ngli_hmap_freep(&s->programs);
+    ngli_free(s->cache_dir);
+    ngli_free(s->driver_id);
     memset(s, 0, sizeof(*s));
 }
 
 void ngli_pgcache_release_program(struct program *p)
 {
+    struct pgcache_entry *entry = p->cache_entry;
     memset(p, 0, sizeof(*p));
+    if (!entry)
+        return;
+
+    ngli_assert(entry->refcount > 0);
+    if (--entry->refcount)
+        return;
+
+    /* Programs which could not be shared are not kept around */
+    if (!entry->key[0]) {
+        free_entry(entry);
+        return;
+    }
+
+    /* Unused programs are kept around until they get evicted */
+
+    struct pgcache *s = entry->cache;
+    lru_push(s, entry);
+    evict_programs(s, MAX_PROGRAMS);
 }
@@ -25,15 +25,49 @@
 #include "hmap.h"
 #include "program.h"
 
+/* Hexadecimal representation of up to two 64-bit hashes */
+#define PGCACHE_KEY_SIZE 40
+
+struct pgcache;
+
+struct pgcache_entry {
+    struct program program;
+    struct pgcache *cache;
+    char key[PGCACHE_KEY_SIZE];
+    /* Copies of the sources, to rule out hash collisions */
+    char *vert;
+    char *frag;
+    char *comp;
+    int refcount;
+    int requested;
+    /* Neighbours in the least recently used list of unreferenced entries */
+    struct pgcache_entry *prev;
+    struct pgcache_entry *next;
+};
+
 struct pgcache {
     struct ngl_ctx *ctx;
-    struct hmap *graphics_cache;
-    struct hmap *compute_cache;
+    struct hmap *programs;
+    struct pgcache_entry *lru_first;
+    struct pgcache_entry *lru_last;
+    char *cache_dir;
+    char *driver_id;
 };
 
 int ngli_pgcache_init(struct pgcache *s, struct ngl_ctx *ctx);
+uint64_t ngli_pgcache_hash_shader(const char *src);
 int ngli_pgcache_get_graphics_program(struct pgcache *s, struct program *dst, const char *vert, const char *frag);
 int ngli_pgcache_get_compute_program(struct pgcache *s, struct program *dst, const char *comp);
+int ngli_pgcache_prefetch_graphics_program(struct pgcache *s, const char *vert, const char *frag);
+int ngli_pgcache_get_hashed_graphics_program(struct pgcache *s, struct program *dst,
+                                             const char *vert, uint64_t vert_hash,
+                                             const char *frag, uint64_t frag_hash);
+int ngli_pgcache_get_hashed_compute_program(struct pgcache *s, struct program *dst,
+                                            const char *comp, uint64_t comp_hash);
+int ngli_pgcache_prefetch_hashed_graphics_program(struct pgcache *s,
+                                                  const char *vert, uint64_t vert_hash,
+                                                  const char *frag, uint64_t frag_hash);
+int ngli_pgcache_prefetch_hashed_compute_program(struct pgcache *s, const char *comp, uint64_t comp_hash);
 void ngli_pgcache_reset(struct pgcache *s);
 void ngli_pgcache_release_program(struct program *s);
 
@@ -24,10 +24,12 @@
 #include "format.h"
 #include "glcontext.h"
 #include "log.h"
+#include "memory.h"
 #include "nodes.h"
 #include "pipeline.h"
 #include "topology.h"
 #include "type.h"
+#include "ubopool.h"
 
 typedef void (*set_uniform_func)(struct glcontext *gl, GLint location, int count, const void *data);
 
@@ -35,10 +37,32 @@ struct uniform_desc {
     GLuint location;
     struct pipeline_uniform uniform;
     set_uniform_func set;
+    struct program_variable_info *info;
+    int shadow_size;
+    int block_index;
+    int offset;
+    int array_stride;
+    int matrix_stride;
 };
 
+/*
+ * Uniform block declared in the shader but not backed by a Block node: the
+ * uniforms it contains are packed into a CPU copy of the block which is
+ * uploaded into the per-frame uniform buffer pool before each draw.
+ */
+struct uniform_block_desc {
+    int binding;
+    int size;
+    int shared;
+    uint8_t *data;
+};
+
+#define FRAME_GLOBALS_BLOCK_NAME "ngl_frame_globals"
+
 struct texture_desc {
     struct pipeline_texture texture;
+    int unit;
+    struct program_variable_info *info;
 };
 
 struct buffer_desc {
@@ -48,6 +72,10 @@ struct buffer_desc {
 
 struct attribute_desc {
     struct pipeline_attribute attribute;
+    GLenum type;
+    GLboolean normalized;
+    int integer;
+    int buffer_offset;
 };
 
 static void set_uniform_1iv(struct glcontext *gl, GLint location, int count, const void *data)
@@ -138,6 +166,91 @@ static const set_uniform_func set_uniform_func_map[NGLI_TYPE_NB] = {
     [NGLI_TYPE_MAT4]   = set_uniform_mat4fv,
 };
 
+static const struct {
+    int size;
+    int nb_columns;
+} uniform_layout_map[NGLI_TYPE_NB] = {
+    [NGLI_TYPE_BOOL]   = {sizeof(GLint),       1},
+    [NGLI_TYPE_INT]    = {sizeof(GLint),       1},
+    [NGLI_TYPE_IVEC2]  = {sizeof(GLint) * 2,   1},
+    [NGLI_TYPE_IVEC3]  = {sizeof(GLint) * 3,   1},
+    [NGLI_TYPE_IVEC4]  = {sizeof(GLint) * 4,   1},
+    [NGLI_TYPE_UINT]   = {sizeof(GLuint),      1},
+    [NGLI_TYPE_UIVEC2] = {sizeof(GLuint) * 2,  1},
+    [NGLI_TYPE_UIVEC3] = {sizeof(GLuint) * 3,  1},
+    [NGLI_TYPE_UIVEC4] = {sizeof(GLuint) * 4,  1},
+    [NGLI_TYPE_FLOAT]  = {sizeof(GLfloat),     1},
+    [NGLI_TYPE_VEC2]   = {sizeof(GLfloat) * 2, 1},
+    [NGLI_TYPE_VEC3]   = {sizeof(GLfloat) * 3, 1},
+    [NGLI_TYPE_VEC4]   = {sizeof(GLfloat) * 4, 1},
+    [NGLI_TYPE_MAT3]   = {sizeof(GLfloat) * 3, 3},
+    [NGLI_TYPE_MAT4]   = {sizeof(GLfloat) * 4, 4},
+};
+
+static void pack_uniform(struct pipeline *s, const struct uniform_desc *desc, const void *data)
+{
+    const struct uniform_block_desc *block_descs = ngli_darray_data(&s->uniform_block_descs);
+    const struct uniform_block_desc *block_desc = &block_descs[desc->block_index];
+    const struct pipeline_uniform *uniform = &desc->uniform;
+    const int column_size = uniform_layout_map[uniform->type].size;
+    const int nb_columns = uniform_layout_map[uniform->type].nb_columns;
+
+    const uint8_t *src = data;
+    uint8_t *dst = block_desc->data + desc->offset;
+    for (int i = 0; i < uniform->count; i++) {
+        uint8_t *column_dst = dst;
+        for (int j = 0; j < nb_columns; j++) {
+            memcpy(column_dst, src, column_size);
+            column_dst += desc->matrix_stride;
+            src += column_size;
+        }
+        dst += desc->array_stride;
+    }
+}
+
+static const struct pipeline_buffer *get_pipeline_buffer(const struct pipeline_params *params, int type, int binding)
+{
+    for (int i = 0; i < params->nb_buffers; i++) {
+        const struct pipeline_buffer *pipeline_buffer = &params->buffers[i];
+        if (pipeline_buffer->type == type && pipeline_buffer->binding == binding)
+            return pipeline_buffer;
+    }
+    return NULL;
+}
+
+static int get_uniform_block_index(struct pipeline *s, const struct pipeline_params *params, int binding)
+{
+    const struct uniform_block_desc *descs = ngli_darray_data(&s->uniform_block_descs);
+    for (int i = 0; i < ngli_darray_count(&s->uniform_block_descs); i++)
+        if (descs[i].binding == binding)
+            return i;
+
+    const struct program *program = params->program;
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(program->buffer_blocks, entry))) {
+        const struct program_variable_info *info = entry->data;
+        if (info->type != NGLI_TYPE_UNIFORM_BUFFER || info->binding != binding)
+            continue;
+
+        struct uniform_block_desc desc = {
+            .binding = binding,
+            .size    = info->size,
+            .shared  = !strcmp(entry->key, FRAME_GLOBALS_BLOCK_NAME),
+            .data    = ngli_calloc(1, info->size),
+        };
+        if (!desc.data)
+            return NGL_ERROR_MEMORY;
+        if (!ngli_darray_push(&s->uniform_block_descs, &desc)) {
+            ngli_free(desc.data);
+            return NGL_ERROR_MEMORY;
+        }
+        return ngli_darray_count(&s->uniform_block_descs) - 1;
+    }
+
+    LOG(ERROR, "could not find uniform block with binding %d", binding);
+    return NGL_ERROR_BUG;
+}
+
 static int build_uniform_descs(struct pipeline *s, const struct pipeline_params *params)
 {
     const struct program *program = params->program;
@@ -150,7 +263,7 @@ static int build_uniform_descs(struct pipeline *s, const struct pipeline_params
 
     for (int i = 0; i < params->nb_uniforms; i++) {
         const struct pipeline_uniform *uniform = &params->uniforms[i];
-        const struct program_variable_info *info = ngli_hmap_get(program->uniforms, uniform->name);
+        struct program_variable_info *info = ngli_hmap_get(program->uniforms, uniform->name);
         if (!info)
             continue;
 
@@ -175,7 +288,25 @@ static int build_uniform_descs(struct pipeline *s, const struct pipeline_params
             .location = info->location,
             .uniform = *uniform,
             .set = set_func,
+            .info = info,
+            .shadow_size = NGLI_MIN(uniform->count, info->size) * ngli_type_get_size(info->type),
+            .block_index = -1,
+            .offset = info->offset,
+            .array_stride = info->array_stride,
+            .matrix_stride = info->matrix_stride,
         };
+
+        if (info->offset >= 0) {
+            /* The uniform lives in a block already backed by a Block node */
+            if (get_pipeline_buffer(params, NGLI_TYPE_UNIFORM_BUFFER, info->binding))
+                continue;
+
+            desc.block_index = get_uniform_block_index(s, params, info->binding);
+            if (desc.block_index < 0)
+                return desc.block_index;
+            desc.uniform.count = NGLI_MIN(uniform->count, info->size);
+        }
+
         if (!ngli_darray_push(&s->uniform_descs, &desc))
             return NGL_ERROR_MEMORY;
     }
@@ -183,19 +314,84 @@ static int build_uniform_descs(struct pipeline *s, const struct pipeline_params
     return 0;
 }
 
+/*
+ * The shadow copy is shared by all the pipelines using the same program since
+ * the uniform values are part of the program state. The values are only
+ * compared once they have been set at least once.
+ */
+static int shadow_has_changed(struct pipeline *s, struct program_variable_info *info, int size, const void *data)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct ngl_stats *stats = &ctx->stats;
+
+    if (info && info->shadow) {
+        if (size <= info->shadow_size && !memcmp(info->shadow, data, size)) {
+            stats->uniform_updates_skipped++;
+            return 0;
+        }
+        memcpy(info->shadow, data, size);
+        info->shadow_size = NGLI_MAX(info->shadow_size, size);
+    }
+    stats->uniform_updates_issued++;
+    return 1;
+}
+
+static int uniform_has_changed(struct pipeline *s, const struct uniform_desc *desc, const void *data)
+{
+    return shadow_has_changed(s, desc->info, desc->shadow_size, data);
+}
+
 static void set_uniforms(struct pipeline *s, struct glcontext *gl)
 {
     const struct uniform_desc *descs = ngli_darray_data(&s->uniform_descs);
     for (int i = 0; i < ngli_darray_count(&s->uniform_descs); i++) {
         const struct uniform_desc *desc = &descs[i];
         const struct pipeline_uniform *uniform = &desc->uniform;
-        if (uniform->data)
+        if (!uniform->data)
+            continue;
+        if (desc->block_index >= 0)
+            pack_uniform(s, desc, uniform->data);
+        else if (uniform_has_changed(s, desc, uniform->data))
             desc->set(gl, desc->location, uniform->count, uniform->data);
     }
 }
 
+static int set_uniform_blocks(struct pipeline *s, struct glcontext *gl)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct ubopool *ubopool = &ctx->ubopool;
+
+    const struct uniform_block_desc *descs = ngli_darray_data(&s->uniform_block_descs);
+    for (int i = 0; i < ngli_darray_count(&s->uniform_block_descs); i++) {
+        const struct uniform_block_desc *desc = &descs[i];
+        GLuint buffer_id;
+        int offset;
+        int ret = desc->shared ? ngli_ubopool_upload_shared(ubopool, desc->data, desc->size, &buffer_id, &offset)
+                               : ngli_ubopool_upload(ubopool, desc->data, desc->size, &buffer_id, &offset);
+        if (ret < 0)
+            return ret;
+        ngli_glstate_bind_buffer_range(gl, &ctx->glstate, GL_UNIFORM_BUFFER, desc->binding, buffer_id, offset, desc->size);
+    }
+
+    return 0;
+}
+
+static int acquire_next_available_texture_unit(uint64_t *texture_units)
+{
+    for (int i = 0; i < sizeof(*texture_units) * 8; i++) {
+        if (!(*texture_units & (1ULL << i))) {
+            *texture_units |= (1ULL << i);
+            return i;
+        }
+    }
+    LOG(ERROR, "no texture unit available");
+    return NGL_ERROR_LIMIT_EXCEEDED;
+}
+
 static int build_texture_descs(struct pipeline *s, const struct pipeline_params *params)
 {
+    const struct program *program = params->program;
+
     for (int i = 0; i < params->nb_textures; i++) {
         const struct pipeline_texture *texture = &params->textures[i];
 
@@ -217,29 +413,57 @@ static int build_texture_descs(struct pipeline *s, const struct pipeline_params
 
         struct texture_desc desc = {
             .texture  = *texture,
+            .unit     = -1,
         };
         if (!ngli_darray_push(&s->texture_descs, &desc))
             return NGL_ERROR_MEMORY;
     }
 
+    /*
+     * Samplers are assigned to the units left by the images once for all so
+     * the sampler uniforms only need to be set once
+     */
+    uint64_t texture_units = s->used_texture_units;
+    struct texture_desc *descs = ngli_darray_data(&s->texture_descs);
+    for (int i = 0; i < ngli_darray_count(&s->texture_descs); i++) {
+        struct texture_desc *desc = &descs[i];
+        const struct pipeline_texture *pipeline_texture = &desc->texture;
+        if (pipeline_texture->type == NGLI_TYPE_IMAGE_2D)
+            continue;
+
+        desc->unit = acquire_next_available_texture_unit(&texture_units);
+        if (desc->unit < 0)
+            return desc->unit;
+
+        desc->info = ngli_hmap_get(program->uniforms, pipeline_texture->name);
+    }
+
     return 0;
 }
 
-static int acquire_next_available_texture_unit(uint64_t *texture_units)
+/*
+ * The sampler uniforms are part of the program state which can be shared with
+ * other pipelines using a different unit assignment: the shadow copy makes
+ * this check a no-op unless another pipeline changed them.
+ */
+static void set_sampler_uniforms(struct pipeline *s, struct glcontext *gl)
 {
-    for (int i = 0; i < sizeof(*texture_units) * 8; i++) {
-        if (!(*texture_units & (1ULL << i))) {
-            *texture_units |= (1ULL << i);
-            return i;
-        }
+    const struct texture_desc *descs = ngli_darray_data(&s->texture_descs);
+    for (int i = 0; i < ngli_darray_count(&s->texture_descs); i++) {
+        const struct texture_desc *desc = &descs[i];
+        const struct pipeline_texture *pipeline_texture = &desc->texture;
+        if (desc->unit < 0)
+            continue;
+        if (shadow_has_changed(s, desc->info, sizeof(desc->unit), &desc->unit))
+            ngli_glUniform1i(gl, pipeline_texture->location, desc->unit);
     }
-    LOG(ERROR, "no texture unit available");
-    return NGL_ERROR_LIMIT_EXCEEDED;
 }
 
 static void set_textures(struct pipeline *s, struct glcontext *gl)
 {
-    uint64_t texture_units = s->used_texture_units;
+    struct ngl_ctx *ctx = s->ctx;
+    struct glstate *glstate = &ctx->glstate;
+
     const struct texture_desc *descs = ngli_darray_data(&s->texture_descs);
     for (int i = 0; i < ngli_darray_count(&s->texture_descs); i++) {
         const struct texture_desc *desc = &descs[i];
@@ -258,19 +482,15 @@ static void set_textures(struct pipeline *s, struct glcontext *gl)
             }
             ngli_glBindImageTexture(gl, pipeline_texture->binding, texture_id, 0, GL_FALSE, 0, access, internal_format);
         } else {
-            const int texture_index = acquire_next_available_texture_unit(&texture_units);
-            if (texture_index < 0)
-                return;
-            ngli_glUniform1i(gl, pipeline_texture->location, texture_index);
-            ngli_glActiveTexture(gl, GL_TEXTURE0 + texture_index);
+            ngli_glstate_active_texture(gl, glstate, desc->unit);
             if (texture) {
-                ngli_glBindTexture(gl, texture->target, texture->id);
+                ngli_glstate_bind_texture(gl, glstate, texture->target, texture->id);
             } else {
-                ngli_glBindTexture(gl, GL_TEXTURE_2D, 0);
+                ngli_glstate_bind_texture(gl, glstate, GL_TEXTURE_2D, 0);
                 if (gl->features & NGLI_FEATURE_TEXTURE_3D)
-                    ngli_glBindTexture(gl, GL_TEXTURE_3D, 0);
+                    ngli_glstate_bind_texture(gl, glstate, GL_TEXTURE_3D, 0);
                 if (gl->features & NGLI_FEATURE_OES_EGL_EXTERNAL_IMAGE)
-                    ngli_glBindTexture(gl, GL_TEXTURE_EXTERNAL_OES, 0);
+                    ngli_glstate_bind_texture(gl, glstate, GL_TEXTURE_EXTERNAL_OES, 0);
             }
         }
     }
@@ -278,12 +498,18 @@ static void set_textures(struct pipeline *s, struct glcontext *gl)
 
 static void set_buffers(struct pipeline *s, struct glcontext *gl)
 {
+    struct ngl_ctx *ctx = s->ctx;
+    struct glstate *glstate = &ctx->glstate;
+
     const struct buffer_desc *descs = ngli_darray_data(&s->buffer_descs);
     for (int i = 0; i < ngli_darray_count(&s->buffer_descs); i++) {
         const struct buffer_desc *desc = &descs[i];
         const struct pipeline_buffer *pipeline_buffer = &desc->buffer;
         const struct buffer *buffer = pipeline_buffer->buffer;
-        ngli_glBindBufferBase(gl, desc->type, pipeline_buffer->binding, buffer->id);
+        if (buffer->mapped_data)
+            ngli_glstate_bind_buffer_range(gl, glstate, desc->type, pipeline_buffer->binding, buffer->id, buffer->offset, buffer->size);
+        else
+            ngli_glstate_bind_buffer_base(gl, glstate, desc->type, pipeline_buffer->binding, buffer->id);
     }
 }
 
@@ -313,22 +539,45 @@ static int build_buffer_descs(struct pipeline *s, const struct pipeline_params *
     return 0;
 }
 
+static void set_vertex_attrib(const struct pipeline *s, struct glcontext *gl, struct attribute_desc *desc)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    const struct pipeline_attribute *attribute = &desc->attribute;
+    const struct buffer *buffer = attribute->buffer;
+    const GLuint location = attribute->location;
+    const GLuint size = ngli_format_get_nb_comp(attribute->format);
+    const GLint stride = attribute->stride;
+    const int offset = buffer->offset + attribute->offset;
+
+    ngli_glEnableVertexAttribArray(gl, location);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_ARRAY_BUFFER, buffer->id);
+    if (desc->integer)
+        ngli_glVertexAttribIPointer(gl, location, size, desc->type, stride, (void*)(uintptr_t)offset);
+    else
+        ngli_glVertexAttribPointer(gl, location, size, desc->type, desc->normalized, stride, (void*)(uintptr_t)offset);
+    if ((gl->features & NGLI_FEATURE_INSTANCED_ARRAY) && attribute->rate > 0)
+        ngli_glVertexAttribDivisor(gl, location, attribute->rate);
+    desc->buffer_offset = buffer->offset;
+}
+
 static void set_vertex_attribs(const struct pipeline *s, struct glcontext *gl)
 {
-    const struct attribute_desc *descs = ngli_darray_data(&s->attribute_descs);
+    struct attribute_desc *descs = ngli_darray_data(&s->attribute_descs);
+    for (int i = 0; i < ngli_darray_count(&s->attribute_descs); i++)
+        set_vertex_attrib(s, gl, &descs[i]);
+}
+
+/*
+ * The attributes recorded in the VAO need to be updated whenever a dynamic
+ * buffer moves to another segment of its ring.
+ */
+static void update_vertex_attribs(const struct pipeline *s, struct glcontext *gl)
+{
+    struct attribute_desc *descs = ngli_darray_data(&s->attribute_descs);
     for (int i = 0; i < ngli_darray_count(&s->attribute_descs); i++) {
-        const struct attribute_desc *desc = &descs[i];
-        const struct pipeline_attribute *attribute = &desc->attribute;
-        const struct buffer *buffer = attribute->buffer;
-        const GLuint location = attribute->location;
-        const GLuint size = ngli_format_get_nb_comp(attribute->format);
-        const GLint stride = attribute->stride;
-
-        ngli_glEnableVertexAttribArray(gl, location);
-        ngli_glBindBuffer(gl, GL_ARRAY_BUFFER, buffer->id);
-        ngli_glVertexAttribPointer(gl, location, size, GL_FLOAT, GL_FALSE, stride, (void*)(uintptr_t)(attribute->offset));
-        if ((gl->features & NGLI_FEATURE_INSTANCED_ARRAY) && attribute->rate > 0)
-            ngli_glVertexAttribDivisor(gl, location, attribute->rate);
+        struct attribute_desc *desc = &descs[i];
+        if (desc->buffer_offset != desc->attribute.buffer->offset)
+            set_vertex_attrib(s, gl, desc);
     }
 }
 
@@ -361,6 +610,13 @@ static int build_attribute_descs(struct pipeline *s, const struct pipeline_param
         struct attribute_desc desc = {
             .attribute = *attribute,
         };
+        int ret = ngli_format_get_gl_vertex_attrib_format(gl, attribute->format,
+                                                          &desc.type,
+                                                          &desc.normalized,
+                                                          &desc.integer);
+        if (ret < 0)
+            return ret;
+
         if (!ngli_darray_push(&s->attribute_descs, &desc))
             return NGL_ERROR_MEMORY;
     }
@@ -390,10 +646,13 @@ static GLenum get_gl_indices_type(int indices_format)
 
 static void bind_vertex_attribs(const struct pipeline *s, struct glcontext *gl)
 {
-    if (gl->features & NGLI_FEATURE_VERTEX_ARRAY_OBJECT)
-        ngli_glBindVertexArray(gl, s->vao_id);
-    else
+    if (gl->features & NGLI_FEATURE_VERTEX_ARRAY_OBJECT) {
+        struct ngl_ctx *ctx = s->ctx;
+        ngli_glstate_bind_vertex_array(gl, &ctx->glstate, s->vao_id);
+        update_vertex_attribs(s, gl);
+    } else {
         set_vertex_attribs(s, gl);
+    }
 }
 
 static void unbind_vertex_attribs(const struct pipeline *s, struct glcontext *gl)
@@ -406,12 +665,13 @@ static void draw_elements(const struct pipeline *s, struct glcontext *gl)
 {
     bind_vertex_attribs(s, gl);
 
+    struct ngl_ctx *ctx = s->ctx;
     const struct pipeline_graphics *graphics = &s->graphics;
     const struct buffer *indices = graphics->indices;
     const GLenum gl_topology = ngli_topology_get_gl_topology(graphics->topology);
     const GLenum gl_indices_type = get_gl_indices_type(graphics->indices_format);
-    ngli_glBindBuffer(gl, GL_ELEMENT_ARRAY_BUFFER, indices->id);
-    ngli_glDrawElements(gl, gl_topology, graphics->nb_indices, gl_indices_type, 0);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_ELEMENT_ARRAY_BUFFER, indices->id);
+    ngli_glDrawElements(gl, gl_topology, graphics->nb_indices, gl_indices_type, (void *)(uintptr_t)indices->offset);
 
     unbind_vertex_attribs(s, gl);
 }
@@ -420,12 +680,13 @@ static void draw_elements_instanced(const struct pipeline *s, struct glcontext *
 {
     bind_vertex_attribs(s, gl);
 
+    struct ngl_ctx *ctx = s->ctx;
     const struct pipeline_graphics *graphics = &s->graphics;
     const struct buffer *indices = graphics->indices;
     const GLenum gl_topology = ngli_topology_get_gl_topology(graphics->topology);
     const GLenum gl_indices_type = get_gl_indices_type(graphics->indices_format);
-    ngli_glBindBuffer(gl, GL_ELEMENT_ARRAY_BUFFER, indices->id);
-    ngli_glDrawElementsInstanced(gl, gl_topology, graphics->nb_indices, gl_indices_type, 0, graphics->nb_instances);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_ELEMENT_ARRAY_BUFFER, indices->id);
+    ngli_glDrawElementsInstanced(gl, gl_topology, graphics->nb_indices, gl_indices_type, (void *)(uintptr_t)indices->offset, graphics->nb_instances);
 
     unbind_vertex_attribs(s, gl);
 }
@@ -452,6 +713,37 @@ static void draw_arrays_instanced(const struct pipeline *s, struct glcontext *gl
     unbind_vertex_attribs(s, gl);
 }
 
+static void multi_draw_elements_indirect(const struct pipeline *s, struct glcontext *gl)
+{
+    bind_vertex_attribs(s, gl);
+
+    struct ngl_ctx *ctx = s->ctx;
+    const struct pipeline_graphics *graphics = &s->graphics;
+    const struct buffer *indices = graphics->indices;
+    const struct buffer *commands = graphics->draw_commands;
+    const GLenum gl_topology = ngli_topology_get_gl_topology(graphics->topology);
+    const GLenum gl_indices_type = get_gl_indices_type(graphics->indices_format);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_ELEMENT_ARRAY_BUFFER, indices->id);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_DRAW_INDIRECT_BUFFER, commands->id);
+    ngli_glMultiDrawElementsIndirect(gl, gl_topology, gl_indices_type, (void *)(uintptr_t)commands->offset, graphics->nb_draw_commands, 0);
+
+    unbind_vertex_attribs(s, gl);
+}
+
+static void multi_draw_arrays_indirect(const struct pipeline *s, struct glcontext *gl)
+{
+    bind_vertex_attribs(s, gl);
+
+    struct ngl_ctx *ctx = s->ctx;
+    const struct pipeline_graphics *graphics = &s->graphics;
+    const struct buffer *commands = graphics->draw_commands;
+    const GLenum gl_topology = ngli_topology_get_gl_topology(graphics->topology);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_DRAW_INDIRECT_BUFFER, commands->id);
+    ngli_glMultiDrawArraysIndirect(gl, gl_topology, (void *)(uintptr_t)commands->offset, graphics->nb_draw_commands, 0);
+
+    unbind_vertex_attribs(s, gl);
+}
+
 static void dispatch_compute(const struct pipeline *s, struct glcontext *gl)
 {
     const struct pipeline_compute *compute = &s->compute;
@@ -471,17 +763,29 @@ static int pipeline_graphics_init(struct pipeline *s, const struct pipeline_para
         return NGL_ERROR_UNSUPPORTED;
     }
 
+    if (graphics->draw_commands && !gl->multi_draw_indirect) {
+        LOG(ERROR, "context does not support indirect multi-draws");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
     int ret = build_attribute_descs(s, params);
     if (ret < 0)
         return ret;
 
+    ret = ngli_glstate_register_render_state(&ctx->glstate, &graphics->state);
+    if (ret < 0)
+        return ret;
+    s->render_state_id = ret;
+
     if (gl->features & NGLI_FEATURE_VERTEX_ARRAY_OBJECT) {
         ngli_glGenVertexArrays(gl, 1, &s->vao_id);
-        ngli_glBindVertexArray(gl, s->vao_id);
+        ngli_glstate_bind_vertex_array(gl, &ctx->glstate, s->vao_id);
         set_vertex_attribs(s, gl);
     }
 
-    if (graphics->indices)
+    if (graphics->draw_commands)
+        s->exec = graphics->indices ? multi_draw_elements_indirect : multi_draw_arrays_indirect;
+    else if (graphics->indices)
         s->exec = graphics->nb_instances > 0 ? draw_elements_instanced : draw_elements;
     else
         s->exec = graphics->nb_instances > 0 ? draw_arrays_instanced : draw_arrays;
@@ -527,6 +831,7 @@ int ngli_pipeline_init(struct pipeline *s, struct ngl_ctx *ctx, const struct pip
     s->program  = params->program;
 
     ngli_darray_init(&s->uniform_descs, sizeof(struct uniform_desc), 0);
+    ngli_darray_init(&s->uniform_block_descs, sizeof(struct uniform_block_desc), 0);
     ngli_darray_init(&s->texture_descs, sizeof(struct texture_desc), 0);
     ngli_darray_init(&s->buffer_descs, sizeof(struct buffer_desc), 0);
     ngli_darray_init(&s->attribute_descs, sizeof(struct attribute_desc), 0);
@@ -549,6 +854,10 @@ int ngli_pipeline_init(struct pipeline *s, struct ngl_ctx *ctx, const struct pip
         ngli_assert(0);
     }
 
+    struct glcontext *gl = ctx->glcontext;
+    use_program(s, gl);
+    set_sampler_uniforms(s, gl);
+
     return 0;
 }
 
@@ -585,7 +894,9 @@ int ngli_pipeline_update_uniform(struct pipeline *s, int index, const void *data
     struct uniform_desc *descs = ngli_darray_data(&s->uniform_descs);
     struct uniform_desc *desc = &descs[index];
     struct pipeline_uniform *pipeline_uniform = &desc->uniform;
-    if (data) {
+    if (data && desc->block_index >= 0) {
+        pack_uniform(s, desc, data);
+    } else if (data && uniform_has_changed(s, desc, data)) {
         struct ngl_ctx *ctx = s->ctx;
         struct glcontext *gl = ctx->glcontext;
         use_program(s, gl);
@@ -609,21 +920,27 @@ int ngli_pipeline_update_texture(struct pipeline *s, int index, struct texture *
     return 0;
 }
 
-void ngli_pipeline_exec(struct pipeline *s)
+int ngli_pipeline_exec(struct pipeline *s)
 {
     struct ngl_ctx *ctx = s->ctx;
     struct glcontext *gl = ctx->glcontext;
 
-    if (s->type == NGLI_PIPELINE_TYPE_GRAPHICS) {
-        struct pipeline_graphics *graphics = &s->graphics;
-        ngli_glstate_update(ctx, &graphics->state);
-    }
+    if (s->type == NGLI_PIPELINE_TYPE_GRAPHICS)
+        ngli_glstate_use_render_state(gl, &ctx->glstate, s->render_state_id);
 
     use_program(s, gl);
     set_uniforms(s, gl);
+    int ret = set_uniform_blocks(s, gl);
+    if (ret < 0) {
+        LOG(ERROR, "could not upload the packed uniform blocks, skipping the draw");
+        return ret;
+    }
     set_buffers(s, gl);
+    set_sampler_uniforms(s, gl);
     set_textures(s, gl);
     s->exec(s, gl);
+
+    return 0;
 }
 
 void ngli_pipeline_reset(struct pipeline *s)
@@ -632,6 +949,10 @@ void ngli_pipeline_reset(struct pipeline *s)
         return;
 
     ngli_darray_reset(&s->uniform_descs);
+    struct uniform_block_desc *block_descs = ngli_darray_data(&s->uniform_block_descs);
+    for (int i = 0; i < ngli_darray_count(&s->uniform_block_descs); i++)
+        ngli_free(block_descs[i].data);
+    ngli_darray_reset(&s->uniform_block_descs);
     ngli_darray_reset(&s->texture_descs);
     ngli_darray_reset(&s->buffer_descs);
     ngli_darray_reset(&s->attribute_descs);
@@ -639,6 +960,7 @@ void ngli_pipeline_reset(struct pipeline *s)
     struct ngl_ctx *ctx = s->ctx;
     struct glcontext *gl = ctx->glcontext;
     ngli_glDeleteVertexArrays(gl, 1, &s->vao_id);
+    ngli_glstate_invalidate_vertex_array(&ctx->glstate, s->vao_id);
 
     memset(s, 0, sizeof(*s));
 }
@@ -73,6 +73,9 @@ struct pipeline_graphics {
     int indices_format;
     int nb_instances;
     struct buffer *indices;
+    /* Optional indirect draw commands submitted with a single multi-draw */
+    struct buffer *draw_commands;
+    int nb_draw_commands;
     struct graphicstate state;
     struct rendertarget_desc rt_desc;
 };
@@ -113,6 +116,7 @@ struct pipeline {
     const struct program *program;
 
     struct darray uniform_descs;
+    struct darray uniform_block_descs;
     struct darray texture_descs;
     struct darray buffer_descs;
     struct darray attribute_descs;
@@ -121,6 +125,7 @@ struct pipeline {
 
     uint64_t used_texture_units;
     GLuint vao_id;
+    int render_state_id;
 };
 
 int ngli_pipeline_init(struct pipeline *s, struct ngl_ctx *ctx, const struct pipeline_params *params);
@@ -128,7 +133,7 @@ int ngli_pipeline_get_uniform_index(const struct pipeline *s, const char *name);
 int ngli_pipeline_get_texture_index(const struct pipeline *s, const char *name);
 int ngli_pipeline_update_uniform(struct pipeline *s, int index, const void *value);
 int ngli_pipeline_update_texture(struct pipeline *s, int index, struct texture *texture);
-void ngli_pipeline_exec(struct pipeline *s);
+int ngli_pipeline_exec(struct pipeline *s);
 void ngli_pipeline_reset(struct pipeline *s);
 
 #endif
@@ -73,7 +73,9 @@ static int program_check_status(const struct glcontext *gl, GLuint id, GLenum st
 
 static void free_pinfo(void *user_arg, void *data)
 {
-    ngli_free(data);
+    struct program_variable_info *info = data;
+    ngli_free(info->shadow);
+    ngli_free(info);
 }
 
 static const struct {
@@ -120,6 +122,7 @@ static struct program_variable_info *program_variable_info_create()
     info->size     = -1;
     info->binding  = -1;
     info->location = -1;
+    info->offset   = -1;
     return info;
 }
 
@@ -161,8 +164,30 @@ static struct hmap *program_probe_uniforms(struct glcontext *gl, GLuint pid)
             info->binding = -1;
         }
 
-        LOG(DEBUG, "uniform[%d/%d]: %s location:%d size=%d type=0x%x binding=%d",
-            i + 1, nb_active_uniforms, name, info->location, info->size, info->type, info->binding);
+        if (gl->features & NGLI_FEATURE_UNIFORM_BUFFER_OBJECT) {
+            const GLuint index = i;
+            GLint block_index;
+            ngli_glGetActiveUniformsiv(gl, pid, 1, &index, GL_UNIFORM_BLOCK_INDEX, &block_index);
+            if (block_index >= 0) {
+                ngli_glGetActiveUniformBlockiv(gl, pid, block_index, GL_UNIFORM_BLOCK_BINDING, &info->binding);
+                ngli_glGetActiveUniformsiv(gl, pid, 1, &index, GL_UNIFORM_OFFSET, &info->offset);
+                ngli_glGetActiveUniformsiv(gl, pid, 1, &index, GL_UNIFORM_ARRAY_STRIDE, &info->array_stride);
+                ngli_glGetActiveUniformsiv(gl, pid, 1, &index, GL_UNIFORM_MATRIX_STRIDE, &info->matrix_stride);
+            }
+        }
+
+        const int type_size = ngli_type_get_size(info->type);
+        if (info->offset < 0 && type_size) {
+            info->shadow = ngli_calloc(info->size, type_size);
+            if (!info->shadow) {
+                ngli_free(info);
+                ngli_hmap_freep(&umap);
+                return NULL;
+            }
+        }
+
+        LOG(DEBUG, "uniform[%d/%d]: %s location:%d size=%d type=0x%x binding=%d offset=%d",
+            i + 1, nb_active_uniforms, name, info->location, info->size, info->type, info->binding, info->offset);
 
         int ret = ngli_hmap_set(umap, name, info);
         if (ret < 0) {
@@ -243,9 +268,10 @@ static struct hmap *program_probe_buffer_blocks(struct glcontext *gl, GLuint pid
         GLuint block_index = ngli_glGetUniformBlockIndex(gl, pid, name);
         info->binding = binding++;
         ngli_glUniformBlockBinding(gl, pid, block_index, info->binding);
+        ngli_glGetActiveUniformBlockiv(gl, pid, block_index, GL_UNIFORM_BLOCK_DATA_SIZE, &info->size);
 
-        LOG(DEBUG, "ubo[%d/%d]: %s binding:%d",
-            i + 1, nb_active_uniform_buffers, name, info->binding);
+        LOG(DEBUG, "ubo[%d/%d]: %s binding:%d size:%d",
+            i + 1, nb_active_uniform_buffers, name, info->binding, info->size);
 
         int ret = ngli_hmap_set(bmap, name, info);
         if (ret < 0) {
@@ -290,17 +316,20 @@ static struct hmap *program_probe_buffer_blocks(struct glcontext *gl, GLuint pid
     return bmap;
 }
 
-int ngli_program_init(struct program *s, struct ngl_ctx *ctx, const char *vertex, const char *fragment, const char *compute)
+/*
+ * The compilation and the link are only submitted here: their status is not
+ * queried until ngli_program_wait() so the driver can process several
+ * programs concurrently in the meantime.
+ */
+int ngli_program_submit(struct program *s, struct ngl_ctx *ctx, const char *vertex, const char *fragment, const char *compute)
 {
-    int ret = 0;
-    struct {
+    const struct {
         GLenum type;
         const char *src;
-        GLuint id;
     } shaders[] = {
-        [NGLI_PROGRAM_SHADER_VERT] = {GL_VERTEX_SHADER,   vertex,   0},
-        [NGLI_PROGRAM_SHADER_FRAG] = {GL_FRAGMENT_SHADER, fragment, 0},
-        [NGLI_PROGRAM_SHADER_COMP] = {GL_COMPUTE_SHADER,  compute,  0},
+        [NGLI_PROGRAM_SHADER_VERT] = {GL_VERTEX_SHADER,   vertex},
+        [NGLI_PROGRAM_SHADER_FRAG] = {GL_FRAGMENT_SHADER, fragment},
+        [NGLI_PROGRAM_SHADER_COMP] = {GL_COMPUTE_SHADER,  compute},
     };
 
     struct glcontext *gl = ctx->glcontext;
@@ -317,38 +346,274 @@ int ngli_program_init(struct program *s, struct ngl_ctx *ctx, const char *vertex
         if (!shaders[i].src)
             continue;
         GLuint shader = ngli_glCreateShader(gl, shaders[i].type);
-        shaders[i].id = shader;
+        s->shaders[i] = shader;
         ngli_glShaderSource(gl, shader, 1, &shaders[i].src, NULL);
         ngli_glCompileShader(gl, shader);
-        ret = program_check_status(gl, shader, GL_COMPILE_STATUS);
-        if (ret < 0)
-            goto fail;
         ngli_glAttachShader(gl, s->id, shader);
     }
 
+    if (gl->program_binary && ctx->config.program_cache_dir)
+        ngli_glProgramParameteri(gl, s->id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     ngli_glLinkProgram(gl, s->id);
+    s->pending = 1;
+
+    return 0;
+}
+
+int ngli_program_wait(struct program *s)
+{
+    int ret = 0;
+
+    if (!s->pending)
+        return 0;
+    s->pending = 0;
+
+    struct glcontext *gl = s->ctx->glcontext;
+
+    for (int i = 0; i < NGLI_ARRAY_NB(s->shaders); i++) {
+        if (!s->shaders[i])
+            continue;
+        ret = program_check_status(gl, s->shaders[i], GL_COMPILE_STATUS);
+        if (ret < 0)
+            goto end;
+    }
+
     ret = program_check_status(gl, s->id, GL_LINK_STATUS);
     if (ret < 0)
-        goto fail;
-
-    for (int i = 0; i < NGLI_ARRAY_NB(shaders); i++)
-        ngli_glDeleteShader(gl, shaders[i].id);
+        goto end;
 
+    /* Buffer blocks are probed first so the uniforms living in uniform
+     * blocks can be associated with the block bindings */
+    s->buffer_blocks = program_probe_buffer_blocks(gl, s->id);
     s->uniforms = program_probe_uniforms(gl, s->id);
     s->attributes = program_probe_attributes(gl, s->id);
-    s->buffer_blocks = program_probe_buffer_blocks(gl, s->id);
-    if (!s->uniforms || !s->attributes || !s->buffer_blocks) {
+    if (!s->uniforms || !s->attributes || !s->buffer_blocks)
         ret = NGL_ERROR_MEMORY;
-        goto fail;
+
+end:
+    for (int i = 0; i < NGLI_ARRAY_NB(s->shaders); i++) {
+        ngli_glDeleteShader(gl, s->shaders[i]);
+        s->shaders[i] = 0;
+    }
+
+    return ret;
+}
+
+int ngli_program_init(struct program *s, struct ngl_ctx *ctx, const char *vertex, const char *fragment, const char *compute)
+{
+    int ret = ngli_program_submit(s, ctx, vertex, fragment, compute);
+    if (ret < 0)
+        return ret;
+    return ngli_program_wait(s);
+}
+
+/*
+ * Serialized programs are made of the driver binary followed by the
+ * reflection data (buffer blocks, uniforms and attributes) so that loading
+ * them back does not require any introspection.
+ */
+#define NB_VARIABLE_FIELDS 7
+
+static int get_variables_size(const struct hmap *variables)
+{
+    int size = sizeof(int32_t);
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(variables, entry)))
+        size += sizeof(int32_t) + strlen(entry->key) + NB_VARIABLE_FIELDS * sizeof(int32_t);
+    return size;
+}
+
+static uint8_t *write_i32(uint8_t *dst, int32_t v)
+{
+    memcpy(dst, &v, sizeof(v));
+    return dst + sizeof(v);
+}
+
+static uint8_t *write_variables(uint8_t *dst, const struct hmap *variables)
+{
+    int32_t count = 0;
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(variables, entry)))
+        count++;
+    dst = write_i32(dst, count);
+
+    entry = NULL;
+    while ((entry = ngli_hmap_next(variables, entry))) {
+        const struct program_variable_info *info = entry->data;
+        const int32_t len = strlen(entry->key);
+        dst = write_i32(dst, len);
+        memcpy(dst, entry->key, len);
+        dst += len;
+        const int32_t fields[NB_VARIABLE_FIELDS] = {
+            info->type, info->size, info->binding, info->location,
+            info->offset, info->array_stride, info->matrix_stride,
+        };
+        for (int i = 0; i < NB_VARIABLE_FIELDS; i++)
+            dst = write_i32(dst, fields[i]);
+    }
+    return dst;
+}
+
+int ngli_program_serialize(const struct program *s, uint8_t **datap, int *sizep)
+{
+    struct glcontext *gl = s->ctx->glcontext;
+
+    if (!gl->program_binary)
+        return NGL_ERROR_UNSUPPORTED;
+
+    GLint binary_size = 0;
+    ngli_glGetProgramiv(gl, s->id, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+    if (binary_size <= 0)
+        return NGL_ERROR_UNSUPPORTED;
+
+    const int size = 2 * sizeof(int32_t) + binary_size
+                   + get_variables_size(s->buffer_blocks)
+                   + get_variables_size(s->uniforms)
+                   + get_variables_size(s->attributes);
+    uint8_t *data = ngli_malloc(size);
+    if (!data)
+        return NGL_ERROR_MEMORY;
+
+    GLenum binary_format;
+    GLsizei length = 0;
+    ngli_glGetProgramBinary(gl, s->id, binary_size, &length, &binary_format, data + 2 * sizeof(int32_t));
+    if (length != binary_size) {
+        ngli_free(data);
+        return NGL_ERROR_EXTERNAL;
     }
 
+    uint8_t *dst = write_i32(data, binary_format);
+    dst = write_i32(dst, binary_size);
+    dst += binary_size;
+    dst = write_variables(dst, s->buffer_blocks);
+    dst = write_variables(dst, s->uniforms);
+    dst = write_variables(dst, s->attributes);
+    ngli_assert(dst == data + size);
+
+    *datap = data;
+    *sizep = size;
     return 0;
+}
+
+struct reader {
+    const uint8_t *data;
+    const uint8_t *end;
+};
+
+static int read_i32(struct reader *r, int32_t *v)
+{
+    if (r->end - r->data < sizeof(*v))
+        return NGL_ERROR_INVALID_DATA;
+    memcpy(v, r->data, sizeof(*v));
+    r->data += sizeof(*v);
+    return 0;
+}
+
+static struct hmap *read_variables(struct reader *r)
+{
+    struct hmap *variables = ngli_hmap_create();
+    if (!variables)
+        return NULL;
+    ngli_hmap_set_free(variables, free_pinfo, NULL);
+
+    int32_t count;
+    if (read_i32(r, &count) < 0)
+        goto fail;
+
+    for (int i = 0; i < count; i++) {
+        int32_t len;
+        if (read_i32(r, &len) < 0 || len <= 0 || len >= MAX_ID_LEN || r->end - r->data < len)
+            goto fail;
+        char name[MAX_ID_LEN];
+        memcpy(name, r->data, len);
+        name[len] = 0;
+        r->data += len;
+
+        int32_t fields[NB_VARIABLE_FIELDS];
+        for (int j = 0; j < NB_VARIABLE_FIELDS; j++)
+            if (read_i32(r, &fields[j]) < 0)
+                goto fail;
+
+        struct program_variable_info *info = program_variable_info_create();
+        if (!info)
+            goto fail;
+        info->type          = fields[0];
+        info->size          = fields[1];
+        info->binding       = fields[2];
+        info->location      = fields[3];
+        info->offset        = fields[4];
+        info->array_stride  = fields[5];
+        info->matrix_stride = fields[6];
+
+        const int type_size = ngli_type_get_size(info->type);
+        if (info->offset < 0 && type_size && info->size > 0) {
+            info->shadow = ngli_calloc(info->size, type_size);
+            if (!info->shadow) {
+                ngli_free(info);
+                goto fail;
+            }
+        }
+
+        if (ngli_hmap_set(variables, name, info) < 0) {
+            free_pinfo(NULL, info);
+            goto fail;
+        }
+    }
+
+    return variables;
 
 fail:
-    for (int i = 0; i < NGLI_ARRAY_NB(shaders); i++)
-        ngli_glDeleteShader(gl, shaders[i].id);
+    ngli_hmap_freep(&variables);
+    return NULL;
+}
 
-    return ret;
+int ngli_program_init_serialized(struct program *s, struct ngl_ctx *ctx, const uint8_t *data, int size)
+{
+    struct glcontext *gl = ctx->glcontext;
+
+    if (!gl->program_binary)
+        return NGL_ERROR_UNSUPPORTED;
+
+    struct reader r = {.data = data, .end = data + size};
+    int32_t binary_format, binary_size;
+    if (read_i32(&r, &binary_format) < 0 ||
+        read_i32(&r, &binary_size) < 0 ||
+        binary_size <= 0 || r.end - r.data < binary_size)
+        return NGL_ERROR_INVALID_DATA;
+    const uint8_t *binary = r.data;
+    r.data += binary_size;
+
+    s->ctx = ctx;
+    s->buffer_blocks = read_variables(&r);
+    s->uniforms = read_variables(&r);
+    s->attributes = read_variables(&r);
+    if (!s->buffer_blocks || !s->uniforms || !s->attributes || r.data != r.end) {
+        ngli_program_reset(s);
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    /* The binary is rejected if the driver or the hardware changed */
+    s->id = ngli_glCreateProgram(gl);
+    ngli_glProgramBinary(gl, s->id, binary_format, binary, binary_size);
+    GLint status = GL_FALSE;
+    ngli_glGetProgramiv(gl, s->id, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        ngli_program_reset(s);
+        return NGL_ERROR_INVALID_DATA;
+    }
+
+    /* Uniform block bindings are not part of the program binary */
+    const struct hmap_entry *entry = NULL;
+    while ((entry = ngli_hmap_next(s->buffer_blocks, entry))) {
+        const struct program_variable_info *info = entry->data;
+        if (info->type != NGLI_TYPE_UNIFORM_BUFFER)
+            continue;
+        GLuint block_index = ngli_glGetUniformBlockIndex(gl, s->id, entry->key);
+        ngli_glUniformBlockBinding(gl, s->id, block_index, info->binding);
+    }
+
+    return 0;
 }
 
 void ngli_program_reset(struct program *s)
@@ -359,6 +624,8 @@ void ngli_program_reset(struct program *s)
     ngli_hmap_freep(&s->attributes);
     ngli_hmap_freep(&s->buffer_blocks);
     struct glcontext *gl = s->ctx->glcontext;
+    for (int i = 0; i < NGLI_ARRAY_NB(s->shaders); i++)
+        ngli_glDeleteShader(gl, s->shaders[i]);
     ngli_glDeleteProgram(gl, s->id);
     memset(s, 0, sizeof(*s));
 }
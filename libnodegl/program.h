@@ -22,6 +22,8 @@
 #ifndef PROGRAM_H
 #define PROGRAM_H
 
+#include <stdint.h>
+
 #include "glincludes.h"
 #include "hmap.h"
 
@@ -32,6 +34,17 @@ struct program_variable_info {
     int size;
     int binding;
     int location;
+    /* Layout of uniforms living in a uniform block, offset is -1 otherwise */
+    int offset;
+    int array_stride;
+    int matrix_stride;
+    /*
+     * Last value set on the uniform through glUniform*(), of which only the
+     * first shadow_size bytes are known: the initial values (such as the unit
+     * of a sampler declared with a binding layout qualifier) are not tracked
+     */
+    uint8_t *shadow;
+    int shadow_size;
 };
 
 enum {
@@ -41,6 +54,8 @@ enum {
     NGLI_PROGRAM_SHADER_NB
 };
 
+struct pgcache_entry;
+
 struct program {
     struct ngl_ctx *ctx;
     struct hmap *uniforms;
@@ -48,9 +63,20 @@ struct program {
     struct hmap *buffer_blocks;
 
     GLuint id;
+
+    /* Set until the result of the link has been checked */
+    int pending;
+    GLuint shaders[NGLI_PROGRAM_SHADER_NB];
+
+    /* Program cache entry this program has been obtained from, if any */
+    struct pgcache_entry *cache_entry;
 };
 
 int ngli_program_init(struct program *s, struct ngl_ctx *ctx, const char *vertex, const char *fragment, const char *compute);
+int ngli_program_submit(struct program *s, struct ngl_ctx *ctx, const char *vertex, const char *fragment, const char *compute);
+int ngli_program_wait(struct program *s);
+int ngli_program_init_serialized(struct program *s, struct ngl_ctx *ctx, const uint8_t *data, int size);
+int ngli_program_serialize(const struct program *s, uint8_t **datap, int *sizep);
 void ngli_program_reset(struct program *s);
 
 #endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "glcontext.h"
+#include "log.h"
+#include "nodes.h"
+#include "readback.h"
+#include "rendertarget.h"
+
+static void negotiate_format(struct readback *s, struct rendertarget *rt)
+{
+    GLenum format, type;
+    ngli_rendertarget_get_read_format(rt, &format, &type);
+
+    /*
+     * GL_RGBA/GL_UNSIGNED_BYTE is always supported but some implementations
+     * need an extra conversion pass to honor it: use their preferred format
+     * instead if it is one we can expose.
+     */
+    if (format == GL_BGRA && type == GL_UNSIGNED_BYTE) {
+        s->format = GL_BGRA;
+        s->capture_format = NGL_CAPTURE_FORMAT_BGRA;
+    } else {
+        s->format = GL_RGBA;
+        s->capture_format = NGL_CAPTURE_FORMAT_RGBA;
+    }
+    s->type = GL_UNSIGNED_BYTE;
+}
+
+int ngli_readback_init(struct readback *s, struct ngl_ctx *ctx, struct rendertarget *rt,
+                       int capture_format, int nb_slots,
+                       ngl_capture_callback callback, void *user_data)
+{
+    struct glcontext *gl = ctx->glcontext;
+
+    if (gl->version < 300 || !(gl->features & NGLI_FEATURE_SYNC)) {
+        LOG(ERROR, "context does not support pixel pack buffers and fences, "
+            "asynchronous capture is not supported");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    if (nb_slots <= 0 || nb_slots > NGLI_READBACK_MAX_SLOTS) {
+        LOG(ERROR, "capture latency must be in [1,%d]", NGLI_READBACK_MAX_SLOTS);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    s->ctx = ctx;
+    s->size = rt->width * rt->height * 4;
+    s->callback = callback;
+    s->user_data = user_data;
+    s->nb_slots = nb_slots;
+
+    if (capture_format == NGL_CAPTURE_FORMAT_RGBA) {
+        s->width = rt->width;
+        s->height = rt->height;
+        s->linesize = s->width * 4;
+        negotiate_format(s, rt);
+    } else {
+        /* The planar data must be read back byte per byte as is */
+        s->width = rt->width * 4;
+        s->height = rt->height * 2 / 3;
+        s->linesize = s->width;
+        s->format = GL_RGBA;
+        s->type = GL_UNSIGNED_BYTE;
+        s->capture_format = capture_format;
+    }
+
+    for (int i = 0; i < s->nb_slots; i++) {
+        struct readback_slot *slot = &s->slots[i];
+        ngli_glGenBuffers(gl, 1, &slot->buffer);
+        ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, slot->buffer);
+        ngli_glBufferData(gl, GL_PIXEL_PACK_BUFFER, s->size, NULL, GL_STREAM_READ);
+    }
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+
+    static const char * const format_names[] = {
+        [NGL_CAPTURE_FORMAT_RGBA] = "RGBA",
+        [NGL_CAPTURE_FORMAT_BGRA] = "BGRA",
+        [NGL_CAPTURE_FORMAT_NV12] = "NV12",
+        [NGL_CAPTURE_FORMAT_I420] = "I420",
+    };
+    LOG(DEBUG, "asynchronous capture of %dx%d %s frames with a latency of %d frame(s)",
+        s->width, s->height, format_names[s->capture_format], s->nb_slots);
+
+    return 0;
+}
+
+static int deliver_frame(struct readback *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+    struct readback_slot *slot = &s->slots[s->first];
+
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    for (;;) {
+        const GLenum ret = ngli_glClientWaitSync(gl, slot->fence, flags, 1000000000);
+        if (ret != GL_TIMEOUT_EXPIRED)
+            break;
+        flags = 0;
+    }
+    ngli_glDeleteSync(gl, slot->fence);
+    slot->fence = NULL;
+
+    s->first = (s->first + 1) % s->nb_slots;
+    s->count--;
+
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, slot->buffer);
+    const uint8_t *data = ngli_glMapBufferRange(gl, GL_PIXEL_PACK_BUFFER, 0, s->size, GL_MAP_READ_BIT);
+    if (!data) {
+        LOG(ERROR, "could not map the capture buffer of frame t=%g", slot->t);
+        ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+        return NGL_ERROR_EXTERNAL;
+    }
+
+    const struct ngl_capture_frame frame = {
+        .data     = data,
+        .width    = s->width,
+        .height   = s->height,
+        .linesize = s->linesize,
+        .format   = s->capture_format,
+        .t        = slot->t,
+    };
+    s->callback(s->user_data, &frame);
+
+    ngli_glUnmapBuffer(gl, GL_PIXEL_PACK_BUFFER);
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+    return 0;
+}
+
+int ngli_readback_read(struct readback *s, struct rendertarget *rt, double t)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    /* The ring is full: the oldest frame must be delivered to free its slot */
+    if (s->count == s->nb_slots) {
+        int ret = deliver_frame(s);
+        if (ret < 0)
+            return ret;
+    }
+
+    const int index = (s->first + s->count) % s->nb_slots;
+    struct readback_slot *slot = &s->slots[index];
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, slot->buffer);
+    ngli_rendertarget_read_pixels_as(rt, s->format, s->type, NULL);
+    ngli_glBindBuffer(gl, GL_PIXEL_PACK_BUFFER, 0);
+    slot->fence = ngli_glFenceSync(gl, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot->t = t;
+    s->count++;
+
+    return 0;
+}
+
+int ngli_readback_flush(struct readback *s)
+{
+    while (s->count) {
+        int ret = deliver_frame(s);
+        if (ret < 0)
+            return ret;
+    }
+    return 0;
+}
+
+void ngli_readback_reset(struct readback *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    if (!ctx)
+        return;
+
+    struct glcontext *gl = ctx->glcontext;
+    for (int i = 0; i < s->nb_slots; i++) {
+        struct readback_slot *slot = &s->slots[i];
+        if (slot->fence)
+            ngli_glDeleteSync(gl, slot->fence);
+        ngli_glDeleteBuffers(gl, 1, &slot->buffer);
+    }
+    memset(s, 0, sizeof(*s));
+}
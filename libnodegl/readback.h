@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef READBACK_H
+#define READBACK_H
+
+#include "glincludes.h"
+#include "nodegl.h"
+
+struct ngl_ctx;
+struct rendertarget;
+
+/*
+ * Asynchronous readback of a render target: the pixels of each frame are
+ * read into a pixel pack buffer guarded by a fence, and only mapped once
+ * nb_slots more frames have been submitted, so the CPU never waits for the
+ * GPU to complete the rendering of the frame it just submitted.
+ */
+#define NGLI_READBACK_MAX_SLOTS 8
+
+struct readback_slot {
+    GLuint buffer;
+    GLsync fence;
+    double t;
+};
+
+struct readback {
+    struct ngl_ctx *ctx;
+    int width;
+    int height;
+    int linesize;
+    int size;
+    GLenum format;
+    GLenum type;
+    int capture_format;
+    ngl_capture_callback callback;
+    void *user_data;
+    struct readback_slot slots[NGLI_READBACK_MAX_SLOTS];
+    int nb_slots;
+    int first;
+    int count;
+};
+
+/*
+ * With the planar capture formats, the render target is expected to hold the
+ * frame packed 4 bytes per RGBA texel (see yuvconv.h).
+ */
+int ngli_readback_init(struct readback *s, struct ngl_ctx *ctx, struct rendertarget *rt,
+                       int capture_format, int nb_slots,
+                       ngl_capture_callback callback, void *user_data);
+int ngli_readback_read(struct readback *s, struct rendertarget *rt, double t);
+int ngli_readback_flush(struct readback *s);
+void ngli_readback_reset(struct readback *s);
+
+#endif
@@ -127,7 +127,7 @@ static int create_fbo(struct rendertarget *s, int resolve)
     int nb_color_attachments = 0;
 
     ngli_glGenFramebuffers(gl, 1, &id);
-    ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, id);
+    ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_FRAMEBUFFER, id);
 
     for (int i = 0; i < params->nb_colors; i++) {
         const struct attachment *attachment = &params->colors[i];
@@ -202,6 +202,7 @@ static int create_fbo(struct rendertarget *s, int resolve)
 
 fail:
     ngli_glDeleteFramebuffers(gl, 1, &id);
+    ngli_glstate_invalidate_framebuffer(&ctx->glstate, id);
     return ret;
 }
 
@@ -264,7 +265,7 @@ int ngli_rendertarget_init(struct rendertarget *s, struct ngl_ctx *ctx, const st
 done:;
     struct rendertarget *rt = ctx->rendertarget;
     const GLuint fbo_id = rt ? rt->id : ngli_glcontext_get_default_framebuffer(gl);
-    ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, fbo_id);
+    ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_FRAMEBUFFER, fbo_id);
 
     return ret;
 }
@@ -277,13 +278,13 @@ void ngli_rendertarget_blit(struct rendertarget *s, struct rendertarget *dst, in
     if (!(gl->features & NGLI_FEATURE_FRAMEBUFFER_OBJECT))
         return;
 
-    ngli_glBindFramebuffer(gl, GL_READ_FRAMEBUFFER, s->id);
-    ngli_glBindFramebuffer(gl, GL_DRAW_FRAMEBUFFER, dst->id);
+    ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_READ_FRAMEBUFFER, s->id);
+    ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_DRAW_FRAMEBUFFER, dst->id);
     s->blit(s, dst->nb_color_attachments, dst->width, dst->height, vflip);
 
     struct rendertarget *rt = ctx->rendertarget;
     const GLuint fbo_id = rt ? rt->id : ngli_glcontext_get_default_framebuffer(gl);
-    ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, fbo_id);
+    ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_FRAMEBUFFER, fbo_id);
 }
 
 void ngli_rendertarget_resolve(struct rendertarget *s)
@@ -297,16 +298,16 @@ void ngli_rendertarget_resolve(struct rendertarget *s)
     if (!s->resolve_id)
         return;
 
-    ngli_glBindFramebuffer(gl, GL_READ_FRAMEBUFFER, s->id);
-    ngli_glBindFramebuffer(gl, GL_DRAW_FRAMEBUFFER, s->resolve_id);
+    ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_READ_FRAMEBUFFER, s->id);
+    ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_DRAW_FRAMEBUFFER, s->resolve_id);
     s->resolve(s);
 
     struct rendertarget *rt = ctx->rendertarget;
     const GLuint fbo_id = rt ? rt->id : ngli_glcontext_get_default_framebuffer(gl);
-    ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, fbo_id);
+    ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_FRAMEBUFFER, fbo_id);
 }
 
-void ngli_rendertarget_read_pixels(struct rendertarget *s, uint8_t *data)
+static GLuint bind_read_framebuffer(struct rendertarget *s)
 {
     struct ngl_ctx *ctx = s->ctx;
     struct glcontext *gl = ctx->glcontext;
@@ -315,12 +316,49 @@ void ngli_rendertarget_read_pixels(struct rendertarget *s, uint8_t *data)
     const GLuint fbo_id = rt ? rt->id : ngli_glcontext_get_default_framebuffer(gl);
     const GLuint id = s->resolve_id ? s->resolve_id : s->id;
     if (id != fbo_id)
-        ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, id);
+        ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_FRAMEBUFFER, id);
+    return fbo_id;
+}
 
-    ngli_glReadPixels(gl, 0, 0, s->width, s->height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+static void restore_framebuffer(struct rendertarget *s, GLuint fbo_id)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
 
+    const GLuint id = s->resolve_id ? s->resolve_id : s->id;
     if (id != fbo_id)
-        ngli_glBindFramebuffer(gl, GL_FRAMEBUFFER, fbo_id);
+        ngli_glstate_bind_framebuffer(gl, &ctx->glstate, GL_FRAMEBUFFER, fbo_id);
+}
+
+void ngli_rendertarget_read_pixels(struct rendertarget *s, uint8_t *data)
+{
+    ngli_rendertarget_read_pixels_as(s, GL_RGBA, GL_UNSIGNED_BYTE, data);
+}
+
+void ngli_rendertarget_read_pixels_as(struct rendertarget *s, GLenum format, GLenum type, uint8_t *data)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    const GLuint fbo_id = bind_read_framebuffer(s);
+    ngli_glReadPixels(gl, 0, 0, s->width, s->height, format, type, data);
+    restore_framebuffer(s, fbo_id);
+}
+
+void ngli_rendertarget_get_read_format(struct rendertarget *s, GLenum *format, GLenum *type)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    GLint read_format = 0;
+    GLint read_type = 0;
+    const GLuint fbo_id = bind_read_framebuffer(s);
+    ngli_glGetIntegerv(gl, GL_IMPLEMENTATION_COLOR_READ_FORMAT, &read_format);
+    ngli_glGetIntegerv(gl, GL_IMPLEMENTATION_COLOR_READ_TYPE, &read_type);
+    restore_framebuffer(s, fbo_id);
+
+    *format = read_format;
+    *type = read_type;
 }
 
 void ngli_rendertarget_reset(struct rendertarget *s)
@@ -332,6 +370,8 @@ void ngli_rendertarget_reset(struct rendertarget *s)
     struct glcontext *gl = ctx->glcontext;
     ngli_glDeleteFramebuffers(gl, 1, &s->id);
     ngli_glDeleteFramebuffers(gl, 1, &s->resolve_id);
+    ngli_glstate_invalidate_framebuffer(&ctx->glstate, s->id);
+    ngli_glstate_invalidate_framebuffer(&ctx->glstate, s->resolve_id);
 
     memset(s, 0, sizeof(*s));
 }
@@ -76,6 +76,15 @@ int ngli_rendertarget_init(struct rendertarget *s, struct ngl_ctx *ctx, const st
 void ngli_rendertarget_blit(struct rendertarget *s, struct rendertarget *dst, int vflip);
 void ngli_rendertarget_resolve(struct rendertarget *s);
 void ngli_rendertarget_read_pixels(struct rendertarget *s, uint8_t *data);
+
+/*
+ * Read the pixels with an explicit GL format and type. If a pixel pack
+ * buffer is bound, data is an offset into this buffer.
+ */
+void ngli_rendertarget_read_pixels_as(struct rendertarget *s, GLenum format, GLenum type, uint8_t *data);
+
+/* Query the format and type preferred by the implementation to read the pixels */
+void ngli_rendertarget_get_read_format(struct rendertarget *s, GLenum *format, GLenum *type);
 void ngli_rendertarget_reset(struct rendertarget *s);
 
 #endif
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#include "bstr.h"
+#include "nodegl.h"
+#include "specialize.h"
+#include "type.h"
+#include "utils.h"
+
+static const struct {
+    const char *name;
+    int count;
+    char base;
+} type_map[NGLI_TYPE_NB] = {
+    [NGLI_TYPE_INT]    = {"int",   1, 'i'},
+    [NGLI_TYPE_IVEC2]  = {"ivec2", 2, 'i'},
+    [NGLI_TYPE_IVEC3]  = {"ivec3", 3, 'i'},
+    [NGLI_TYPE_IVEC4]  = {"ivec4", 4, 'i'},
+    [NGLI_TYPE_UINT]   = {"uint",  1, 'u'},
+    [NGLI_TYPE_UIVEC2] = {"uvec2", 2, 'u'},
+    [NGLI_TYPE_UIVEC3] = {"uvec3", 3, 'u'},
+    [NGLI_TYPE_UIVEC4] = {"uvec4", 4, 'u'},
+    [NGLI_TYPE_FLOAT]  = {"float", 1, 'f'},
+    [NGLI_TYPE_VEC2]   = {"vec2",  2, 'f'},
+    [NGLI_TYPE_VEC3]   = {"vec3",  3, 'f'},
+    [NGLI_TYPE_VEC4]   = {"vec4",  4, 'f'},
+    [NGLI_TYPE_MAT4]   = {"mat4", 16, 'f'},
+};
+
+static int is_ident_char(char c)
+{
+    return c == '_' || isalnum((unsigned char)c);
+}
+
+static const char *skip_comment(const char *p)
+{
+    if (p[0] == '/' && p[1] == '/') {
+        while (*p && *p != '\n')
+            p++;
+    } else if (p[0] == '/' && p[1] == '*') {
+        const char *end = strstr(p + 2, "*/");
+        p = end ? end + 2 : p + strlen(p);
+    }
+    return p;
+}
+
+static const char *skip_spaces(const char *p)
+{
+    for (;;) {
+        const char *next = skip_comment(p);
+        while (isspace((unsigned char)*next))
+            next++;
+        if (next == p)
+            return p;
+        p = next;
+    }
+}
+
+static int read_token(const char **pp, const char **tokenp)
+{
+    const char *p = skip_spaces(*pp);
+    const char *start = p;
+    while (is_ident_char(*p))
+        p++;
+    *pp = p;
+    *tokenp = start;
+    return p - start;
+}
+
+static int token_eq(const char *token, int len, const char *str)
+{
+    return len == strlen(str) && !memcmp(token, str, len);
+}
+
+/*
+ * Format the constant as a GLSL constructor. Values which can not be expressed
+ * as a literal are not specialized.
+ */
+static int print_constant(struct bstr *b, const struct specialize_constant *constant)
+{
+    const int count = type_map[constant->type].count;
+    const char base = type_map[constant->type].base;
+
+    ngli_bstr_printf(b, "%s(", type_map[constant->type].name);
+    for (int i = 0; i < count; i++) {
+        const char *sep = i ? ", " : "";
+        if (base == 'f') {
+            const float v = ((const float *)constant->data)[i];
+            if (!isfinite(v))
+                return NGL_ERROR_UNSUPPORTED;
+            ngli_bstr_printf(b, "%s%.9g", sep, v);
+        } else if (base == 'i') {
+            const int v = ((const int *)constant->data)[i];
+            if (v == INT_MIN)
+                return NGL_ERROR_UNSUPPORTED;
+            ngli_bstr_printf(b, "%s%d", sep, v);
+        } else {
+            ngli_bstr_printf(b, "%s%uu", sep, ((const unsigned *)constant->data)[i]);
+        }
+    }
+    ngli_bstr_print(b, ")");
+    return 0;
+}
+
+static const struct specialize_constant *find_constant(const struct specialize_constant *constants, int nb_constants,
+                                                       const char *name, int len)
+{
+    for (int i = 0; i < nb_constants; i++)
+        if (token_eq(name, len, constants[i].name))
+            return &constants[i];
+    return NULL;
+}
+
+/*
+ * Parse a "uniform [precision] type name;" declaration starting at p and
+ * write its constant counterpart in b. Returns the end of the declaration on
+ * success, NULL if the declaration can not be specialized.
+ */
+static const char *specialize_declaration(struct bstr *b, const char *p,
+                                          const struct specialize_constant *constants, int nb_constants)
+{
+    const char *tokens[3];
+    int lens[3];
+    int nb_tokens = 0;
+
+    for (;;) {
+        lens[nb_tokens] = read_token(&p, &tokens[nb_tokens]);
+        if (!lens[nb_tokens])
+            return NULL;
+        nb_tokens++;
+        p = skip_spaces(p);
+        if (*p == ';')
+            break;
+        if (nb_tokens == NGLI_ARRAY_NB(tokens))
+            return NULL;
+    }
+
+    if (nb_tokens < 2)
+        return NULL;
+    if (nb_tokens == 3 && !token_eq(tokens[0], lens[0], "lowp") &&
+                          !token_eq(tokens[0], lens[0], "mediump") &&
+                          !token_eq(tokens[0], lens[0], "highp"))
+        return NULL;
+
+    const int type_idx = nb_tokens - 2;
+    const int name_idx = nb_tokens - 1;
+    const struct specialize_constant *constant = find_constant(constants, nb_constants,
+                                                               tokens[name_idx], lens[name_idx]);
+    if (!constant || !type_map[constant->type].name ||
+        !token_eq(tokens[type_idx], lens[type_idx], type_map[constant->type].name))
+        return NULL;
+
+    struct bstr *decl = ngli_bstr_create();
+    if (!decl)
+        return NULL;
+    ngli_bstr_print(decl, "const ");
+    for (int i = 0; i < nb_tokens; i++)
+        ngli_bstr_printf(decl, "%.*s ", lens[i], tokens[i]);
+    ngli_bstr_print(decl, "= ");
+    int ret = print_constant(decl, constant);
+    if (ret < 0 || ngli_bstr_check(decl) < 0) {
+        ngli_bstr_freep(&decl);
+        return NULL;
+    }
+    ngli_bstr_printf(b, "%s;", ngli_bstr_strptr(decl));
+    ngli_bstr_freep(&decl);
+
+    return p;
+}
+
+/*
+ * Replace the declarations of the specified uniforms with constants holding
+ * their values, so the shader compiler can fold them. Only the simple
+ * declarations of a single non-array uniform are specialized.
+ *
+ * Returns the number of specialized declarations. The specialized source is
+ * returned in dstp when this number is not 0.
+ */
+int ngli_specialize_uniforms(char **dstp, const char *src,
+                             const struct specialize_constant *constants, int nb_constants)
+{
+    struct bstr *b = ngli_bstr_create();
+    if (!b)
+        return NGL_ERROR_MEMORY;
+
+    int count = 0;
+    char prev = 0;
+    const char *copied = src;
+    const char *p = src;
+    while (*p) {
+        const char *next = skip_comment(p);
+        if (next != p) {
+            p = next;
+            continue;
+        }
+
+        if (!is_ident_char(*p)) {
+            if (!isspace((unsigned char)*p))
+                prev = *p;
+            p++;
+            continue;
+        }
+
+        const char *token;
+        const int len = read_token(&p, &token);
+
+        /* Declarations with a layout qualifier are left untouched */
+        if (!token_eq(token, len, "uniform") || prev == ')') {
+            prev = 'a';
+            continue;
+        }
+
+        ngli_bstr_printf(b, "%.*s", (int)(token - copied), copied);
+        const char *end = specialize_declaration(b, p, constants, nb_constants);
+        if (end) {
+            p = end + 1;
+            copied = p;
+            prev = ';';
+            count++;
+        } else {
+            copied = token;
+            prev = 'a';
+        }
+    }
+    ngli_bstr_print(b, copied);
+
+    int ret = ngli_bstr_check(b);
+    if (ret < 0)
+        goto end;
+
+    if (count) {
+        *dstp = ngli_bstr_strdup(b);
+        if (!*dstp) {
+            ret = NGL_ERROR_MEMORY;
+            goto end;
+        }
+    }
+    ret = count;
+
+end:
+    ngli_bstr_freep(&b);
+    return ret;
+}
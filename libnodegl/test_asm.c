@@ -20,11 +20,47 @@
  */
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include <math.h>
+#include <inttypes.h>
 
 #include "utils.h"
 #include "math_utils.h"
 
+typedef void (*mat4_mul_func)(float *dst, const float *m1, const float *m2);
+typedef void (*mat4_mul_vec4_func)(float *dst, const float *m, const float *v);
+typedef void (*mat3_inverse_func)(float *dst, const float *m);
+typedef void (*quat_slerp_func)(float *dst, const float *q1, const float *q2, float t);
+
+static const NGLI_ALIGNED_MAT(m1) = {
+    0.73016,  0.51184, 0.20930, -7.42311,
+   -9.42693,  1.47287, 0.34995,  0.42049,
+    0.42603, -1.50442, 1.34210,  3.04868,
+    0.53013,  0.68963, 0.25207,  1.96254,
+};
+
+static const NGLI_ALIGNED_MAT(m2) = {
+    0.08222, 0.62387, 0.79754,  0.64541,
+    1.70126, 2.24977, 0.05395, -3.00599,
+    0.30858, 0.90973, 0.84432, -4.01016,
+    6.19681, 5.45165, 0.77647,  0.59262,
+};
+
+static const float m3[3*3] = {
+    0.73016,  0.51184, 0.20930,
+   -9.42693,  1.47287, 0.34995,
+    0.42603, -1.50442, 1.34210,
+};
+
+static const float quats[][4] = {
+    { 0.00000, 0.00000,  0.00000, 1.00000},
+    { 0.18257, 0.36515,  0.54772, 0.73030},
+    {-0.50000, 0.50000, -0.50000, 0.50000},
+    { 0.18300, 0.36500,  0.54800, 0.73000},
+    { 0.00000, 0.70711,  0.00000, -0.70711},
+};
+
 static void flt_diff(float *dst, const float *a, const float *b, int size)
 {
     for (int i = 0; i < size; i++)
@@ -42,62 +78,176 @@ static void flt_check(const float *f, int size)
     printf("=> OK\n");
 }
 
-int main(void)
+static void test_mat4_mul(const char *name, mat4_mul_func func)
 {
-    static const NGLI_ALIGNED_MAT(m1) = {
-        0.73016,  0.51184, 0.20930, -7.42311,
-       -9.42693,  1.47287, 0.34995,  0.42049,
-        0.42603, -1.50442, 1.34210,  3.04868,
-        0.53013,  0.68963, 0.25207,  1.96254,
-    };
-
-    static const NGLI_ALIGNED_MAT(m2) = {
-        0.08222, 0.62387, 0.79754,  0.64541,
-        1.70126, 2.24977, 0.05395, -3.00599,
-        0.30858, 0.90973, 0.84432, -4.01016,
-        6.19681, 5.45165, 0.77647,  0.59262,
-    };
+    printf(":: Testing mat4 mul (%s)\n", name);
+
+    NGLI_ALIGNED_MAT(m_ref);
+    NGLI_ALIGNED_MAT(m_out) = {0};
+    NGLI_ALIGNED_MAT(m_diff);
+
+    ngli_mat4_mul_c(m_ref, m1, m2);
+    func(m_out, m1, m2);
+    flt_diff(m_diff, m_ref, m_out, 4*4);
+
+    printf("ref:\n"  NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m_ref));
+    printf("out:\n"  NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m_out));
+    printf("diff:\n" NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m_diff));
+    flt_check(m_diff, 4*4);
+
+    /* In-place multiplication, as done by the transform nodes */
+    memcpy(m_out, m1, sizeof(m_out));
+    func(m_out, m_out, m2);
+    flt_diff(m_diff, m_ref, m_out, 4*4);
+    flt_check(m_diff, 4*4);
+}
 
-    printf("m1:\n" NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m1));
-    printf("m2:\n" NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m2));
+static void test_mat4_mul_vec4(const char *name, mat4_mul_vec4_func func)
+{
+    for (int i = 0; i < 4; i++) {
+        printf(":: Testing mat4 mul vec4 %d/4 (%s)\n", i + 1, name);
 
-    if (ngli_mat4_mul_c != ngli_mat4_mul) {
-        printf(":: Testing mat4 mul\n");
+        const float *v = &m2[i * 4];
 
-        NGLI_ALIGNED_MAT(m_ref);
-        NGLI_ALIGNED_MAT(m_out) = {0};
-        NGLI_ALIGNED_MAT(m_diff);
+        NGLI_ALIGNED_VEC(v_ref);
+        NGLI_ALIGNED_VEC(v_out) = {0};
+        NGLI_ALIGNED_VEC(v_diff);
 
-        ngli_mat4_mul_c(m_ref, m1, m2);
-        ngli_mat4_mul(m_out, m1, m2);
-        flt_diff(m_diff, m_ref, m_out, 4*4);
+        ngli_mat4_mul_vec4_c(v_ref, m1, v);
+        func(v_out, m1, v);
+        flt_diff(v_diff, v_ref, v_out, 4);
 
-        printf("ref:\n"  NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m_ref));
-        printf("out:\n"  NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m_out));
-        printf("diff:\n" NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m_diff));
-        flt_check(m_diff, 4*4);
+        printf("ref:  " NGLI_FMT_VEC4 "\n", NGLI_ARG_VEC4(v_ref));
+        printf("out:  " NGLI_FMT_VEC4 "\n", NGLI_ARG_VEC4(v_out));
+        printf("diff: " NGLI_FMT_VEC4 "\n", NGLI_ARG_VEC4(v_diff));
+        flt_check(v_diff, 4);
     }
+}
 
-    if (ngli_mat4_mul_vec4_c != ngli_mat4_mul_vec4) {
-        for (int i = 0; i < 4; i++) {
-            printf(":: Testing mat4 mul vec4 %d/4\n", i + 1);
+static void test_mat3_inverse(const char *name, mat3_inverse_func func)
+{
+    printf(":: Testing mat3 inverse (%s)\n", name);
+
+    float m_ref[3*3];
+    float m_out[3*3];
+    float m_diff[3*3];
+
+    ngli_mat3_inverse_c(m_ref, m3);
+    func(m_out, m3);
+    flt_diff(m_diff, m_ref, m_out, 3*3);
+    flt_check(m_diff, 3*3);
+
+    /* In-place inverse, as done for the normal matrix */
+    memcpy(m_out, m3, sizeof(m_out));
+    func(m_out, m_out);
+    flt_diff(m_diff, m_ref, m_out, 3*3);
+    flt_check(m_diff, 3*3);
+
+    /* Singular matrices are left untouched */
+    static const float singular[3*3] = {1, 2, 3, 2, 4, 6, 7, 8, 9};
+    func(m_out, singular);
+    flt_diff(m_diff, singular, m_out, 3*3);
+    flt_check(m_diff, 3*3);
+}
 
-            const float *v = &m2[i * 4];
+static void test_quat_slerp(const char *name, quat_slerp_func func)
+{
+    for (int i = 0; i < NGLI_ARRAY_NB(quats); i++) {
+        for (int j = 0; j < NGLI_ARRAY_NB(quats); j++) {
+            printf(":: Testing quat slerp %d-%d (%s)\n", i, j, name);
+            for (int k = 0; k <= 4; k++) {
+                const float t = k / 4.f;
+
+                NGLI_ALIGNED_VEC(q_ref);
+                NGLI_ALIGNED_VEC(q_out);
+                NGLI_ALIGNED_VEC(q_diff);
+
+                ngli_quat_slerp_c(q_ref, quats[i], quats[j], t);
+                func(q_out, quats[i], quats[j], t);
+                flt_diff(q_diff, q_ref, q_out, 4);
+                flt_check(q_diff, 4);
+            }
+        }
+    }
+}
 
-            NGLI_ALIGNED_VEC(v_ref);
-            NGLI_ALIGNED_VEC(v_out) = {0};
-            NGLI_ALIGNED_VEC(v_diff);
+#define BENCH_ITERATIONS 10000000
 
-            ngli_mat4_mul_vec4_c(v_ref, m1, v);
-            ngli_mat4_mul_vec4(v_out, m1, v);
-            flt_diff(v_diff, v_ref, v_out, 4);
+#define BENCH(name, code) do {                                          \
+    const int64_t start = ngli_gettime_relative();                      \
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {                        \
+        code;                                                           \
+    }                                                                   \
+    const int64_t elapsed = ngli_gettime_relative() - start;            \
+    printf("%-24s %6.2fns\n", name, elapsed * 1000. / BENCH_ITERATIONS); \
+} while (0)
 
-            printf("ref:  " NGLI_FMT_VEC4 "\n", NGLI_ARG_VEC4(v_ref));
-            printf("out:  " NGLI_FMT_VEC4 "\n", NGLI_ARG_VEC4(v_out));
-            printf("diff: " NGLI_FMT_VEC4 "\n", NGLI_ARG_VEC4(v_diff));
-            flt_check(v_diff, 4);
-        }
+/*
+ * Microbenchmark of the reference and the optimized versions; every result is
+ * fed back as an input to prevent the compiler from dropping the calls.
+ */
+static void bench(void)
+{
+    NGLI_ALIGNED_MAT(m);
+    NGLI_ALIGNED_VEC(v);
+    float m3_out[3*3];
+    float q[4];
+
+    memcpy(m, m1, sizeof(m));
+    BENCH("mat4_mul_c", ngli_mat4_mul_c(m, m, m2));
+    memcpy(m, m1, sizeof(m));
+    BENCH("mat4_mul", ngli_mat4_mul(m, m, m2));
+#ifdef ARCH_X86_64
+    memcpy(m, m1, sizeof(m));
+    BENCH("mat4_mul_sse", ngli_mat4_mul_sse(m, m, m2));
+    if (ngli_cpu_has_avx()) {
+        memcpy(m, m1, sizeof(m));
+        BENCH("mat4_mul_avx", ngli_mat4_mul_avx(m, m, m2));
+    }
+#endif
+
+    memcpy(v, m2, sizeof(v));
+    BENCH("mat4_mul_vec4_c", ngli_mat4_mul_vec4_c(v, m1, v));
+    memcpy(v, m2, sizeof(v));
+    BENCH("mat4_mul_vec4", ngli_mat4_mul_vec4(v, m1, v));
+
+    memcpy(m3_out, m3, sizeof(m3_out));
+    BENCH("mat3_inverse_c", ngli_mat3_inverse_c(m3_out, m3_out));
+    memcpy(m3_out, m3, sizeof(m3_out));
+    BENCH("mat3_inverse", ngli_mat3_inverse(m3_out, m3_out));
+
+    memcpy(q, quats[1], sizeof(q));
+    BENCH("quat_slerp_c", ngli_quat_slerp_c(q, q, quats[2], 0.3f));
+    memcpy(q, quats[1], sizeof(q));
+    BENCH("quat_slerp", ngli_quat_slerp(q, q, quats[2], 0.3f));
+}
+
+int main(int argc, char **argv)
+{
+    ngli_math_utils_init();
+
+    if (argc > 1 && !strcmp(argv[1], "bench")) {
+        bench();
+        return 0;
     }
 
+    printf("m1:\n" NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m1));
+    printf("m2:\n" NGLI_FMT_MAT4 "\n", NGLI_ARG_MAT4(m2));
+
+    if (ngli_mat4_mul_c != ngli_mat4_mul)
+        test_mat4_mul("default", ngli_mat4_mul);
+    if (ngli_mat4_mul_vec4_c != ngli_mat4_mul_vec4)
+        test_mat4_mul_vec4("default", ngli_mat4_mul_vec4);
+    if (ngli_mat3_inverse_c != ngli_mat3_inverse)
+        test_mat3_inverse("default", ngli_mat3_inverse);
+    if (ngli_quat_slerp_c != ngli_quat_slerp)
+        test_quat_slerp("default", ngli_quat_slerp);
+
+#ifdef ARCH_X86_64
+    test_mat4_mul("sse", ngli_mat4_mul_sse);
+    if (ngli_cpu_has_avx())
+        test_mat4_mul("avx", ngli_mat4_mul_avx);
+#endif
+
     return 0;
 }
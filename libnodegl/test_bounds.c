@@ -0,0 +1,71 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "bounds.h"
+#include "math_utils.h"
+#include "utils.h"
+
+static int is_visible_at(const struct bounds *b, const float *projection, float x, float y, float z)
+{
+    NGLI_ALIGNED_MAT(modelview);
+    NGLI_ALIGNED_MAT(mvp);
+    ngli_mat4_translate(modelview, x, y, z);
+    ngli_mat4_mul(mvp, projection, modelview);
+    return ngli_bounds_is_visible(b, mvp);
+}
+
+int main(void)
+{
+    /* Unit quad centered on the origin, with an interleaved uvcoord */
+    static const float vertices[] = {
+        -0.5f, -0.5f, 0.0f,   0.0f, 0.0f,
+         0.5f, -0.5f, 0.0f,   1.0f, 0.0f,
+         0.5f,  0.5f, 0.0f,   1.0f, 1.0f,
+        -0.5f,  0.5f, 0.0f,   0.0f, 1.0f,
+    };
+    struct bounds b;
+    ngli_bounds_from_points(&b, vertices, 4, 5 * sizeof(*vertices));
+    ngli_assert(b.min[0] == -0.5f && b.min[1] == -0.5f && b.min[2] == 0.0f);
+    ngli_assert(b.max[0] ==  0.5f && b.max[1] ==  0.5f && b.max[2] == 0.0f);
+
+    /* Identity projection: the clip space is the [-1,1] cube */
+    NGLI_ALIGNED_MAT(identity) = NGLI_MAT4_IDENTITY;
+    ngli_assert(is_visible_at(&b, identity, 0.0f, 0.0f, 0.0f));
+    ngli_assert(is_visible_at(&b, identity, 1.4f, 0.0f, 0.0f));
+    ngli_assert(!is_visible_at(&b, identity, 1.6f, 0.0f, 0.0f));
+    ngli_assert(!is_visible_at(&b, identity, 0.0f, -1.6f, 0.0f));
+    ngli_assert(!is_visible_at(&b, identity, 0.0f, 0.0f, 1.1f));
+
+    /* Perspective projection looking down -z */
+    NGLI_ALIGNED_MAT(projection);
+    ngli_mat4_perspective(projection, 60.0f, 1.0f, 1.0f, 10.0f);
+    ngli_assert(is_visible_at(&b, projection, 0.0f, 0.0f, -5.0f));
+    ngli_assert(!is_visible_at(&b, projection, 0.0f, 0.0f, 5.0f));
+    ngli_assert(!is_visible_at(&b, projection, 0.0f, 0.0f, -20.0f));
+    ngli_assert(!is_visible_at(&b, projection, 10.0f, 0.0f, -5.0f));
+    ngli_assert(is_visible_at(&b, projection, 3.0f, 0.0f, -5.0f));
+
+    /* Empty bounds are never visible */
+    ngli_bounds_from_points(&b, NULL, 0, 0);
+    ngli_assert(!is_visible_at(&b, identity, 0.0f, 0.0f, 0.0f));
+
+    return 0;
+}
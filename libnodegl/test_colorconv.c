@@ -97,6 +97,27 @@ static int compare_matrices(const float *a, const float *b)
     return fail ? -fail : 0;
 }
 
+/* Check that the RGB to YCbCr matrix is the inverse of the YCbCr to RGB one */
+static int check_inverse(const float *rgb2yuv, const float *yuv2rgb)
+{
+    float identity[4 * 4];
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            float v = 0;
+            for (int i = 0; i < 4; i++)
+                v += yuv2rgb[i * 4 + row] * rgb2yuv[col * 4 + i];
+            identity[col * 4 + row] = v;
+        }
+    }
+
+    int fail = 0;
+    for (int i = 0; i < NGLI_ARRAY_NB(identity); i++)
+        fail += fabs(identity[i] - (i % 5 == 0)) > 1e-5;
+    if (fail)
+        printf("inverse:\n" NGLI_FMT_MAT4 "\n\n", NGLI_ARG_MAT4(identity));
+    return fail ? -fail : 0;
+}
+
 int main(void)
 {
     int fail = 0;
@@ -114,6 +135,13 @@ int main(void)
                 printf(">>>> DIFF IS TOO HIGH <<<<\n\n");
                 fail++;
             }
+            float inv[4 * 4];
+            if (ngli_colorconv_get_rgb_to_ycbcr_color_matrix(inv, &cinfo) < 0)
+                return 1;
+            if (check_inverse(inv, mat) < 0) {
+                printf(">>>> RGB TO YCBCR IS NOT THE INVERSE <<<<\n\n");
+                fail++;
+            }
         }
     }
     return fail;
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "geomopt.h"
+#include "memory.h"
+#include "utils.h"
+
+#define GRID_SIZE 32
+#define NB_TRIANGLES (GRID_SIZE * GRID_SIZE * 2)
+#define CACHE_SIZE 16
+
+struct vertex {
+    float position[3];
+    float uvcoord[2];
+};
+
+static uint32_t lcg_next(uint32_t *state)
+{
+    *state = *state * 1664525 + 1013904223;
+    return *state >> 8;
+}
+
+/* Non-indexed grid of quads, with its triangles shuffled */
+static void build_grid(struct vertex *vertices)
+{
+    int n = 0;
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            static const int corners[6][2] = {{0, 0}, {1, 0}, {0, 1}, {0, 1}, {1, 0}, {1, 1}};
+            for (int i = 0; i < 6; i++) {
+                const float px = x + corners[i][0];
+                const float py = y + corners[i][1];
+                const struct vertex v = {{px, py, 0.f}, {px / GRID_SIZE, py / GRID_SIZE}};
+                vertices[n++] = v;
+            }
+        }
+    }
+
+    uint32_t state = 0x1234;
+    for (int i = NB_TRIANGLES - 1; i > 0; i--) {
+        const int j = lcg_next(&state) % (i + 1);
+        struct vertex tmp[3];
+        memcpy(tmp, &vertices[i * 3], sizeof(tmp));
+        memcpy(&vertices[i * 3], &vertices[j * 3], sizeof(tmp));
+        memcpy(&vertices[j * 3], tmp, sizeof(tmp));
+    }
+}
+
+static const struct vertex *get_vertex(const struct geomopt *s, int index, struct vertex *dst)
+{
+    const uint8_t *data = s->vertices + index * s->stride;
+    memcpy(dst->position, data + s->offsets[0], sizeof(dst->position));
+    memcpy(dst->uvcoord, data + s->offsets[1], sizeof(dst->uvcoord));
+    return dst;
+}
+
+static void check_triangles(const struct geomopt *s, const struct vertex *vertices)
+{
+    uint8_t *found = ngli_calloc(NB_TRIANGLES, 1);
+    ngli_assert(found);
+
+    for (int i = 0; i < s->nb_indices; i += 3) {
+        struct vertex triangle[3];
+        for (int k = 0; k < 3; k++)
+            get_vertex(s, s->indices[i + k], &triangle[k]);
+
+        int t;
+        for (t = 0; t < NB_TRIANGLES; t++)
+            if (!found[t] && !memcmp(triangle, &vertices[t * 3], sizeof(triangle)))
+                break;
+        ngli_assert(t < NB_TRIANGLES);
+        found[t] = 1;
+    }
+
+    ngli_free(found);
+}
+
+int main(void)
+{
+    const int nb_vertices = NB_TRIANGLES * 3;
+    struct vertex *vertices = ngli_calloc(nb_vertices, sizeof(*vertices));
+    ngli_assert(vertices);
+    build_grid(vertices);
+
+    const struct geomopt_attribute attributes[] = {
+        {(const uint8_t *)vertices->position, sizeof(*vertices), sizeof(vertices->position)},
+        {(const uint8_t *)vertices->uvcoord,  sizeof(*vertices), sizeof(vertices->uvcoord)},
+    };
+    struct geomopt_params params = {
+        .attributes    = attributes,
+        .nb_attributes = NGLI_ARRAY_NB(attributes),
+        .nb_vertices   = nb_vertices,
+        .dedup         = 1,
+        .cache_size    = CACHE_SIZE,
+    };
+
+    /* Deduplication, reordering and interleaving */
+    struct geomopt geomopt = {0};
+    ngli_assert(ngli_geomopt_optimize(&geomopt, &params) == 0);
+    ngli_assert(geomopt.nb_vertices == (GRID_SIZE + 1) * (GRID_SIZE + 1));
+    ngli_assert(geomopt.nb_indices == nb_vertices);
+    ngli_assert(geomopt.stride == sizeof(struct vertex));
+    check_triangles(&geomopt, vertices);
+
+    const int nb_misses = ngli_geomopt_get_cache_misses(geomopt.indices, geomopt.nb_indices,
+                                                        geomopt.nb_vertices, CACHE_SIZE);
+    printf("ACMR: %f\n", nb_misses / (double)NB_TRIANGLES);
+    ngli_assert(nb_misses > 0 && nb_misses * 4 < NB_TRIANGLES * 3);
+
+    /* Indexed input: optimizing an optimized geometry preserves its vertices */
+    const struct geomopt_attribute indexed_attributes[] = {
+        {geomopt.vertices + geomopt.offsets[0], geomopt.stride, sizeof(vertices->position)},
+        {geomopt.vertices + geomopt.offsets[1], geomopt.stride, sizeof(vertices->uvcoord)},
+    };
+    const struct geomopt_params indexed_params = {
+        .attributes    = indexed_attributes,
+        .nb_attributes = NGLI_ARRAY_NB(indexed_attributes),
+        .nb_vertices   = geomopt.nb_vertices,
+        .indices       = geomopt.indices,
+        .nb_indices    = geomopt.nb_indices,
+        .dedup         = 1,
+        .cache_size    = CACHE_SIZE,
+    };
+    struct geomopt geomopt_indexed = {0};
+    ngli_assert(ngli_geomopt_optimize(&geomopt_indexed, &indexed_params) == 0);
+    ngli_assert(geomopt_indexed.nb_vertices == geomopt.nb_vertices);
+    ngli_assert(geomopt_indexed.nb_indices == geomopt.nb_indices);
+    check_triangles(&geomopt_indexed, vertices);
+    ngli_geomopt_reset(&geomopt_indexed);
+    ngli_geomopt_reset(&geomopt);
+
+    /* Without deduplication, vertex indices are preserved */
+    params.indices = NULL;
+    params.dedup = 0;
+    ngli_assert(ngli_geomopt_optimize(&geomopt, &params) == 0);
+    ngli_assert(geomopt.nb_vertices == nb_vertices);
+    for (int i = 0; i < nb_vertices; i++) {
+        struct vertex v;
+        ngli_assert(!memcmp(get_vertex(&geomopt, i, &v), &vertices[i], sizeof(v)));
+    }
+    check_triangles(&geomopt, vertices);
+    ngli_geomopt_reset(&geomopt);
+
+    /* Invalid inputs */
+    const uint32_t bad_indices[] = {0, 1, nb_vertices};
+    params.indices    = bad_indices;
+    params.nb_indices = NGLI_ARRAY_NB(bad_indices);
+    ngli_assert(ngli_geomopt_optimize(&geomopt, &params) < 0);
+    params.nb_indices = 2;
+    ngli_assert(ngli_geomopt_optimize(&geomopt, &params) < 0);
+
+    ngli_free(vertices);
+    return 0;
+}
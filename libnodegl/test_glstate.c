@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "glcontext.h"
+#include "glstate.h"
+#include "nodegl.h"
+
+static int get_platform(void)
+{
+#if defined(TARGET_LINUX)
+    return NGL_PLATFORM_XLIB;
+#elif defined(TARGET_DARWIN)
+    return NGL_PLATFORM_MACOS;
+#elif defined(TARGET_MINGW_W64)
+    return NGL_PLATFORM_WINDOWS;
+#else
+    return -1;
+#endif
+}
+
+static int check_binding(const struct glcontext *gl, int unit, GLuint texture)
+{
+    GLint active_texture, binding;
+    ngli_glGetIntegerv(gl, GL_ACTIVE_TEXTURE, &active_texture);
+    ngli_glGetIntegerv(gl, GL_TEXTURE_BINDING_2D, &binding);
+    if (active_texture != GL_TEXTURE0 + unit || binding != texture) {
+        fprintf(stderr, "expected texture %u active on unit %d, got texture %d on unit %d\n",
+                texture, unit, binding, active_texture - GL_TEXTURE0);
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Bind texture A on unit 0, texture B on unit 1, then bind A on unit 0
+ * again (which is already in place) to upload data into it: the upload
+ * must reach A and not B which is bound on the previously active unit.
+ */
+int main(void)
+{
+    const struct ngl_config config = {
+        .platform      = get_platform(),
+        .backend       = NGL_BACKEND_OPENGL,
+        .offscreen     = 1,
+        .width         = 16,
+        .height        = 16,
+        .swap_interval = -1,
+    };
+
+    struct glcontext *gl = ngli_glcontext_new(&config);
+    if (!gl) {
+        fprintf(stderr, "could not create GL context\n");
+        return EXIT_FAILURE;
+    }
+
+    struct glstate glstate = {0};
+    ngli_glstate_probe(gl, &glstate);
+
+    GLuint textures[2];
+    ngli_glGenTextures(gl, 2, textures);
+
+    static const uint8_t pixel[4] = {0xff, 0x80, 0x40, 0xff};
+    for (int i = 0; i < 2; i++) {
+        ngli_glstate_active_texture(gl, &glstate, i);
+        ngli_glstate_bind_texture(gl, &glstate, GL_TEXTURE_2D, textures[i]);
+        ngli_glTexImage2D(gl, GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+    }
+
+    ngli_glstate_active_texture(gl, &glstate, 0);
+    ngli_glstate_bind_texture(gl, &glstate, GL_TEXTURE_2D, textures[0]);
+    const int ret = check_binding(gl, 0, textures[0]);
+    if (ret == 0)
+        ngli_glTexImage2D(gl, GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+    ngli_glDeleteTextures(gl, 2, textures);
+    ngli_glstate_reset(&glstate);
+    ngli_glcontext_freep(&gl);
+
+    return ret < 0 ? EXIT_FAILURE : 0;
+}
@@ -87,6 +87,14 @@ int main(void)
             PRINT_HMAP("drop %s (%d remaining):\n", kvs[i].key, ngli_hmap_count(hm));
         }
 
+        /* Test addition in buckets emptied by the deletions */
+        for (int i = 0; i < NGLI_ARRAY_NB(kvs) - 1; i++) {
+            void *data = custom_alloc ? ngli_strdup(kvs[i].val) : (void*)kvs[i].val;
+            ngli_assert(ngli_hmap_set(hm, kvs[i].key, data) >= 0);
+            ngli_assert(!strcmp(ngli_hmap_get(hm, kvs[i].key), kvs[i].val));
+        }
+        ngli_assert(ngli_hmap_count(hm) == NGLI_ARRAY_NB(kvs));
+
         ngli_hmap_freep(&hm);
     }
 
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "memory.h"
+#include "specialize.h"
+#include "type.h"
+#include "utils.h"
+
+static const char *src =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "uniform vec4 color;\n"
+    "uniform highp float scale ;\n"
+    "uniform mat4 transform;\n"
+    "uniform mat4 ngl_modelview_matrix;\n"
+    "uniform vec4 colors[2];\n"
+    "layout(location = 3) uniform vec4 placed;\n"
+    "/* uniform vec4 color; */\n"
+    "uniform int\n"
+    "    count; // uniform int count;\n"
+    "uniform ivec2 size;\n"
+    "uniform float inf;\n"
+    "uniform uvec3 mask;\n"
+    "uniform Block { vec4 color; } block;\n"
+    "uniform vec4 mycolor;\n";
+
+static const char *ref =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "const vec4 color = vec4(1, 0.5, -0.25, 1e+10);\n"
+    "const highp float scale = float(0.100000001);\n"
+    "const mat4 transform = mat4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 2, 3, 4, 1);\n"
+    "uniform mat4 ngl_modelview_matrix;\n"
+    "uniform vec4 colors[2];\n"
+    "layout(location = 3) uniform vec4 placed;\n"
+    "/* uniform vec4 color; */\n"
+    "const int count = int(-3); // uniform int count;\n"
+    "uniform ivec2 size;\n"
+    "uniform float inf;\n"
+    "const uvec3 mask = uvec3(1u, 2u, 4294967295u);\n"
+    "uniform Block { vec4 color; } block;\n"
+    "uniform vec4 mycolor;\n";
+
+int main(void)
+{
+    static const float color[4] = {1.f, .5f, -.25f, 1e10f};
+    static const float scale = .1f;
+    static const float transform[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 2, 3, 4, 1};
+    static const float placed[4] = {0};
+    static const float colors[4] = {0};
+    static const int count = -3;
+    static const float size[2] = {0};
+    static const unsigned mask[3] = {1, 2, 0xffffffff};
+    const float inf = 1.f / 0.f;
+
+    const struct specialize_constant constants[] = {
+        {"color",     NGLI_TYPE_VEC4,   color},
+        {"scale",     NGLI_TYPE_FLOAT,  &scale},
+        {"transform", NGLI_TYPE_MAT4,   transform},
+        {"placed",    NGLI_TYPE_VEC4,   placed},
+        {"colors",    NGLI_TYPE_VEC4,   colors},
+        {"count",     NGLI_TYPE_INT,    &count},
+        {"size",      NGLI_TYPE_VEC2,   size},
+        {"inf",       NGLI_TYPE_FLOAT,  &inf},
+        {"mask",      NGLI_TYPE_UIVEC3, mask},
+    };
+
+    char *dst = NULL;
+    int ret = ngli_specialize_uniforms(&dst, src, constants, NGLI_ARRAY_NB(constants));
+    printf("%d declarations specialized:\n%s\n", ret, dst ? dst : "");
+    ngli_assert(ret == 5);
+    ngli_assert(!strcmp(dst, ref));
+    ngli_free(dst);
+
+    /* Sources without any matching declaration are left untouched */
+    dst = NULL;
+    ret = ngli_specialize_uniforms(&dst, src, constants + 6, 1);
+    ngli_assert(ret == 0 && !dst);
+
+    return 0;
+}
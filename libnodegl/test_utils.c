@@ -31,5 +31,11 @@ int main(void)
         buf[i] = 0xff - i;
     ngli_assert(ngli_crc32(buf) == 0x5473AA4D);
 
+    ngli_assert(ngli_fnv1a64(NGLI_FNV1A64_INIT, "", 0) == 0xcbf29ce484222325ULL);
+    ngli_assert(ngli_fnv1a64(NGLI_FNV1A64_INIT, "a", 1) == 0xaf63dc4c8601ec8cULL);
+    ngli_assert(ngli_fnv1a64(NGLI_FNV1A64_INIT, "foobar", 6) == 0x85944171f73967e8ULL);
+    const uint64_t foo = ngli_fnv1a64(NGLI_FNV1A64_INIT, "foo", 3);
+    ngli_assert(ngli_fnv1a64(foo, "bar", 3) == 0x85944171f73967e8ULL);
+
     return 0;
 }
@@ -325,7 +325,7 @@ int ngli_texture_init(struct texture *s,
         renderbuffer_set_storage(s);
     } else {
         ngli_glGenTextures(gl, 1, &s->id);
-        ngli_glBindTexture(gl, s->target, s->id);
+        ngli_glstate_bind_texture(gl, &ctx->glstate, s->target, s->id);
         if (s->params.mipmap_filter &&
             !(gl->features & NGLI_FEATURE_TEXTURE_NPOT) &&
             (!is_pow2(params->width) || !is_pow2(params->height))) {
@@ -388,6 +388,10 @@ void ngli_texture_set_id(struct texture *s, GLuint id)
     /* only wrapped textures can update their id with this function */
     ngli_assert(s->wrapped);
 
+    /* the previous texture might have been destroyed by its owner */
+    struct ngl_ctx *ctx = s->ctx;
+    ngli_glstate_invalidate_texture(&ctx->glstate, s->id);
+
     s->id = id;
 }
 
@@ -424,13 +428,13 @@ int ngli_texture_upload(struct texture *s, const uint8_t *data, int linesize)
      * buffers) cannot update their content with this function */
     ngli_assert(!s->external_storage && !(params->usage & NGLI_TEXTURE_USAGE_ATTACHMENT_ONLY));
 
-    ngli_glBindTexture(gl, s->target, s->id);
+    ngli_glstate_bind_texture(gl, &ctx->glstate, s->target, s->id);
     if (data) {
         texture_set_sub_image(s, data, linesize);
         if (ngli_texture_has_mipmap(s))
             ngli_glGenerateMipmap(gl, s->target);
     }
-    ngli_glBindTexture(gl, s->target, 0);
+    ngli_glstate_bind_texture(gl, &ctx->glstate, s->target, 0);
 
     return 0;
 }
@@ -443,7 +447,7 @@ int ngli_texture_generate_mipmap(struct texture *s)
 
     ngli_assert(!(params->usage & NGLI_TEXTURE_USAGE_ATTACHMENT_ONLY));
 
-    ngli_glBindTexture(gl, s->target, s->id);
+    ngli_glstate_bind_texture(gl, &ctx->glstate, s->target, s->id);
     ngli_glGenerateMipmap(gl, s->target);
     return 0;
 }
@@ -463,5 +467,8 @@ void ngli_texture_reset(struct texture *s)
             ngli_glDeleteTextures(gl, 1, &s->id);
     }
 
+    if (s->target != GL_RENDERBUFFER)
+        ngli_glstate_invalidate_texture(&ctx->glstate, s->id);
+
     memset(s, 0, sizeof(*s));
 }
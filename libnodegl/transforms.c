@@ -53,22 +53,158 @@ const float *ngli_get_last_transformation_matrix(const struct ngl_node *node)
     return NULL;
 }
 
+/*
+ * Every matrix pushed on the modelview stack comes with a version which
+ * identifies its content: 0 is reserved for the identity, other versions are
+ * allocated from the context counter whenever a new matrix is computed.
+ */
+int ngli_transform_push_modelview(struct ngl_ctx *ctx, const float *matrix, int64_t version)
+{
+    if (!ngli_darray_push(&ctx->modelview_matrix_stack, matrix))
+        return NGL_ERROR_MEMORY;
+    if (!ngli_darray_push(&ctx->modelview_version_stack, &version)) {
+        ngli_darray_pop(&ctx->modelview_matrix_stack);
+        return NGL_ERROR_MEMORY;
+    }
+    return 0;
+}
+
+void ngli_transform_pop_modelview(struct ngl_ctx *ctx)
+{
+    ngli_darray_pop(&ctx->modelview_matrix_stack);
+    ngli_darray_pop(&ctx->modelview_version_stack);
+}
+
+struct world_matrix {
+    NGLI_ALIGNED_MAT(matrix);
+    const struct rnode *rnode;
+    int64_t version;
+    int64_t parent_version;
+    int64_t local_version;
+};
+
+int ngli_transform_init(struct ngl_node *node)
+{
+    struct transform_priv *s = node->priv_data;
+    ngli_darray_init(&s->world_matrices, sizeof(struct world_matrix), 1);
+    return 0;
+}
+
+static int is_static_transform(const struct ngl_node *node)
+{
+    switch (node->class->id) {
+        case NGL_NODE_ROTATE:
+        case NGL_NODE_ROTATEQUAT:
+        case NGL_NODE_SCALE:
+        case NGL_NODE_TRANSFORM:
+        case NGL_NODE_TRANSLATE: {
+            const struct transform_priv *trf = node->priv_data;
+            return !trf->animated;
+        }
+        default:
+            return 0;
+    }
+}
+
+static void fold_static_transforms(struct ngl_ctx *ctx, struct transform_priv *s)
+{
+    memcpy(s->folded_matrix, s->matrix, sizeof(s->folded_matrix));
+    const struct ngl_node *child = s->child;
+    while (child != s->folded_child) {
+        const struct transform_priv *trf = child->priv_data;
+        ngli_mat4_mul(s->folded_matrix, s->folded_matrix, trf->matrix);
+        child = trf->child;
+    }
+    s->folded_version = ctx->static_transforms_version;
+    s->matrix_version++;
+}
+
+/*
+ * A run of non-animated transforms is collapsed into a single matrix so the
+ * intermediate nodes are skipped at draw time. They are still part of the
+ * graph, so ngli_get_last_transformation_matrix() and the Identity nodes at
+ * the end of the chain keep working.
+ */
+int ngli_transform_prepare(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct transform_priv *s = node->priv_data;
+
+    int ret = ngli_node_prepare(s->child);
+    if (ret < 0)
+        return ret;
+
+    s->folded_child = NULL;
+    if (s->animated || !is_static_transform(s->child))
+        return 0;
+
+    struct ngl_node *child = s->child;
+    while (is_static_transform(child)) {
+        const struct transform_priv *trf = child->priv_data;
+        child = trf->child;
+    }
+    s->folded_child = child;
+    fold_static_transforms(ctx, s);
+    return 0;
+}
+
+static struct world_matrix *get_world_matrix(struct transform_priv *s, const struct rnode *rnode)
+{
+    struct world_matrix *world_matrices = ngli_darray_data(&s->world_matrices);
+    for (int i = 0; i < ngli_darray_count(&s->world_matrices); i++)
+        if (world_matrices[i].rnode == rnode)
+            return &world_matrices[i];
+
+    struct world_matrix *world_matrix = ngli_darray_push(&s->world_matrices, NULL);
+    if (!world_matrix)
+        return NULL;
+    memset(world_matrix, 0, sizeof(*world_matrix));
+    world_matrix->rnode = rnode;
+    return world_matrix;
+}
+
+/*
+ * The world matrix of a transform is cached per render path and only
+ * recomputed when the parent matrix or the local transform changed since the
+ * last draw, which is tracked through the modelview versions.
+ */
 void ngli_transform_draw(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
     struct transform_priv *s = node->priv_data;
     struct ngl_node *child = s->child;
+    const float *matrix = s->matrix;
 
-    float *next_matrix = ngli_darray_push(&ctx->modelview_matrix_stack, NULL);
-    if (!next_matrix)
+    if (s->folded_child) {
+        if (s->folded_version != ctx->static_transforms_version)
+            fold_static_transforms(ctx, s);
+        child = s->folded_child;
+        matrix = s->folded_matrix;
+    }
+
+    struct world_matrix *world_matrix = get_world_matrix(s, ctx->rnode_pos);
+    if (!world_matrix)
         return;
 
-    /* We cannot use ngli_darray_tail() before calling ngli_darray_push() as
-     * ngli_darray_push() can potentially perform a re-allocation on the
-     * underlying matrix stack buffer */
-    const float *prev_matrix = next_matrix - 4 * 4;
+    const int64_t *parent_version = ngli_darray_tail(&ctx->modelview_version_stack);
+    if (!world_matrix->version ||
+        world_matrix->parent_version != *parent_version ||
+        world_matrix->local_version != s->matrix_version) {
+        const float *parent_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
+        ngli_mat4_mul(world_matrix->matrix, parent_matrix, matrix);
+        world_matrix->version = ++ctx->modelview_version;
+        world_matrix->parent_version = *parent_version;
+        world_matrix->local_version = s->matrix_version;
+    }
 
-    ngli_mat4_mul(next_matrix, prev_matrix, s->matrix);
+    if (ngli_transform_push_modelview(ctx, world_matrix->matrix, world_matrix->version) < 0)
+        return;
     ngli_node_draw(child);
-    ngli_darray_pop(&ctx->modelview_matrix_stack);
+    ngli_transform_pop_modelview(ctx);
+}
+
+void ngli_transform_uninit(struct ngl_node *node)
+{
+    struct transform_priv *s = node->priv_data;
+    ngli_darray_reset(&s->world_matrices);
 }
@@ -22,9 +22,18 @@
 #ifndef TRANSFORMS_H
 #define TRANSFORMS_H
 
+#include <stdint.h>
+
 #include "nodes.h"
 
 const float *ngli_get_last_transformation_matrix(const struct ngl_node *node);
+
+int ngli_transform_push_modelview(struct ngl_ctx *ctx, const float *matrix, int64_t version);
+void ngli_transform_pop_modelview(struct ngl_ctx *ctx);
+
+int ngli_transform_init(struct ngl_node *node);
+int ngli_transform_prepare(struct ngl_node *node);
 void ngli_transform_draw(struct ngl_node *node);
+void ngli_transform_uninit(struct ngl_node *node);
 
 #endif
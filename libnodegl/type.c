@@ -48,7 +48,37 @@ static int gl_type_map[] = {
     [NGLI_TYPE_STORAGE_BUFFER]              = GL_SHADER_STORAGE_BUFFER,
 };
 
+static const int size_map[NGLI_TYPE_NB] = {
+    [NGLI_TYPE_INT]    = sizeof(GLint),
+    [NGLI_TYPE_IVEC2]  = sizeof(GLint) * 2,
+    [NGLI_TYPE_IVEC3]  = sizeof(GLint) * 3,
+    [NGLI_TYPE_IVEC4]  = sizeof(GLint) * 4,
+    [NGLI_TYPE_UINT]   = sizeof(GLuint),
+    [NGLI_TYPE_UIVEC2] = sizeof(GLuint) * 2,
+    [NGLI_TYPE_UIVEC3] = sizeof(GLuint) * 3,
+    [NGLI_TYPE_UIVEC4] = sizeof(GLuint) * 4,
+    [NGLI_TYPE_FLOAT]  = sizeof(GLfloat),
+    [NGLI_TYPE_VEC2]   = sizeof(GLfloat) * 2,
+    [NGLI_TYPE_VEC3]   = sizeof(GLfloat) * 3,
+    [NGLI_TYPE_VEC4]   = sizeof(GLfloat) * 4,
+    [NGLI_TYPE_MAT3]   = sizeof(GLfloat) * 3 * 3,
+    [NGLI_TYPE_MAT4]   = sizeof(GLfloat) * 4 * 4,
+    [NGLI_TYPE_BOOL]   = sizeof(GLint),
+    /* Sampler uniforms hold a texture unit index */
+    [NGLI_TYPE_SAMPLER_2D]                  = sizeof(GLint),
+    [NGLI_TYPE_SAMPLER_2D_RECT]             = sizeof(GLint),
+    [NGLI_TYPE_SAMPLER_3D]                  = sizeof(GLint),
+    [NGLI_TYPE_SAMPLER_CUBE]                = sizeof(GLint),
+    [NGLI_TYPE_SAMPLER_EXTERNAL_OES]        = sizeof(GLint),
+    [NGLI_TYPE_SAMPLER_EXTERNAL_2D_Y2Y_EXT] = sizeof(GLint),
+};
+
 GLenum ngli_type_get_gl_type(int type)
 {
     return gl_type_map[type];
 }
+
+int ngli_type_get_size(int type)
+{
+    return size_map[type];
+}
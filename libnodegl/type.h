@@ -54,5 +54,6 @@ enum {
 };
 
 GLenum ngli_type_get_gl_type(int type);
+int ngli_type_get_size(int type);
 
 #endif
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "glcontext.h"
+#include "log.h"
+#include "memory.h"
+#include "nodes.h"
+#include "ubopool.h"
+#include "utils.h"
+
+#define MIN_CHUNK_SIZE (256 * 1024)
+
+struct ubopool_chunk {
+    GLuint id;
+    uint8_t *mapped_data;
+    int used;
+    GLsync fence;
+};
+
+int ngli_ubopool_init(struct ubopool *s, struct ngl_ctx *ctx)
+{
+    struct glcontext *gl = ctx->glcontext;
+
+    s->ctx = ctx;
+    s->alignment = NGLI_MAX(gl->uniform_buffer_offset_alignment, 4);
+    s->chunk_size = NGLI_MAX(gl->max_uniform_block_size, MIN_CHUNK_SIZE);
+    s->current_chunk = -1;
+    ngli_darray_init(&s->chunks, sizeof(struct ubopool_chunk), 0);
+    return 0;
+}
+
+static int chunk_is_available(struct glcontext *gl, struct ubopool_chunk *chunk)
+{
+    if (!chunk->fence)
+        return 1;
+    const GLenum ret = ngli_glClientWaitSync(gl, chunk->fence, 0, 0);
+    if (ret != GL_ALREADY_SIGNALED && ret != GL_CONDITION_SATISFIED)
+        return 0;
+    ngli_glDeleteSync(gl, chunk->fence);
+    chunk->fence = NULL;
+    return 1;
+}
+
+static int create_chunk(struct ubopool *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    struct ubopool_chunk *chunk = ngli_darray_push(&s->chunks, &(struct ubopool_chunk){0});
+    if (!chunk)
+        return NGL_ERROR_MEMORY;
+
+    ngli_glGenBuffers(gl, 1, &chunk->id);
+    ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_UNIFORM_BUFFER, chunk->id);
+    if ((gl->features & NGLI_FEATURE_BUFFER_STORAGE) && (gl->features & NGLI_FEATURE_SYNC)) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        ngli_glBufferStorage(gl, GL_UNIFORM_BUFFER, s->chunk_size, NULL, flags);
+        chunk->mapped_data = ngli_glMapBufferRange(gl, GL_UNIFORM_BUFFER, 0, s->chunk_size, flags);
+        if (!chunk->mapped_data) {
+            LOG(ERROR, "could not map uniform buffer storage");
+            return NGL_ERROR_EXTERNAL;
+        }
+    } else {
+        ngli_glBufferData(gl, GL_UNIFORM_BUFFER, s->chunk_size, NULL, GL_STREAM_DRAW);
+    }
+
+    return ngli_darray_count(&s->chunks) - 1;
+}
+
+static int acquire_chunk(struct ubopool *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    /* Chunks after the current one have not been used yet in this frame */
+    struct ubopool_chunk *chunks = ngli_darray_data(&s->chunks);
+    for (int i = s->current_chunk + 1; i < ngli_darray_count(&s->chunks); i++) {
+        struct ubopool_chunk *chunk = &chunks[i];
+        if (!chunk_is_available(gl, chunk))
+            continue;
+        if (i != s->current_chunk + 1)
+            NGLI_SWAP(struct ubopool_chunk, chunks[i], chunks[s->current_chunk + 1]);
+        chunk = &chunks[s->current_chunk + 1];
+        if (!chunk->mapped_data) {
+            /* Orphan the previous storage, which might still be in use */
+            ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_UNIFORM_BUFFER, chunk->id);
+            ngli_glBufferData(gl, GL_UNIFORM_BUFFER, s->chunk_size, NULL, GL_STREAM_DRAW);
+        }
+        chunk->used = 0;
+        return s->current_chunk + 1;
+    }
+
+    int ret = create_chunk(s);
+    if (ret < 0)
+        return ret;
+    chunks = ngli_darray_data(&s->chunks);
+    NGLI_SWAP(struct ubopool_chunk, chunks[ret], chunks[s->current_chunk + 1]);
+    return s->current_chunk + 1;
+}
+
+int ngli_ubopool_upload(struct ubopool *s, const void *data, int size, GLuint *buffer_id, int *offset)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct glcontext *gl = ctx->glcontext;
+
+    if (size > s->chunk_size) {
+        LOG(ERROR, "uniform data size (%d) exceeds uniform pool chunk size (%d)", size, s->chunk_size);
+        return NGL_ERROR_LIMIT_EXCEEDED;
+    }
+
+    struct ubopool_chunk *chunks = ngli_darray_data(&s->chunks);
+    if (s->current_chunk < 0 || chunks[s->current_chunk].used + size > s->chunk_size) {
+        int ret = acquire_chunk(s);
+        if (ret < 0)
+            return ret;
+        s->current_chunk = ret;
+        chunks = ngli_darray_data(&s->chunks);
+    }
+
+    struct ubopool_chunk *chunk = &chunks[s->current_chunk];
+    *buffer_id = chunk->id;
+    *offset = chunk->used;
+    if (chunk->mapped_data) {
+        memcpy(chunk->mapped_data + chunk->used, data, size);
+    } else {
+        ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_UNIFORM_BUFFER, chunk->id);
+        ngli_glBufferSubData(gl, GL_UNIFORM_BUFFER, chunk->used, size, data);
+    }
+    chunk->used = NGLI_ALIGN(chunk->used + size, s->alignment);
+
+    return 0;
+}
+
+/*
+ * Uploads data meant to be shared by several draws within the frame (such as
+ * the frame globals block): the previous shared allocation is reused as long
+ * as its content is identical.
+ */
+int ngli_ubopool_upload_shared(struct ubopool *s, const void *data, int size, GLuint *buffer_id, int *offset)
+{
+    if (s->shared_size == size && !memcmp(s->shared_data, data, size)) {
+        *buffer_id = s->shared_buffer_id;
+        *offset = s->shared_offset;
+        return 0;
+    }
+
+    int ret = ngli_ubopool_upload(s, data, size, buffer_id, offset);
+    if (ret < 0)
+        return ret;
+
+    if (size > s->shared_size) {
+        uint8_t *shared_data = ngli_realloc(s->shared_data, size);
+        if (!shared_data)
+            return NGL_ERROR_MEMORY;
+        s->shared_data = shared_data;
+    }
+    memcpy(s->shared_data, data, size);
+    s->shared_size = size;
+    s->shared_buffer_id = *buffer_id;
+    s->shared_offset = *offset;
+
+    return 0;
+}
+
+void ngli_ubopool_end_frame(struct ubopool *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    if (!ctx)
+        return;
+
+    struct glcontext *gl = ctx->glcontext;
+    struct ubopool_chunk *chunks = ngli_darray_data(&s->chunks);
+    for (int i = 0; i <= s->current_chunk; i++) {
+        struct ubopool_chunk *chunk = &chunks[i];
+        if (gl->features & NGLI_FEATURE_SYNC)
+            chunk->fence = ngli_glFenceSync(gl, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    /* Move the chunks used in this frame at the end of the list */
+    const int nb_used = s->current_chunk + 1;
+    const int nb_chunks = ngli_darray_count(&s->chunks);
+    for (int i = 0; i < nb_used; i++) {
+        struct ubopool_chunk chunk = chunks[0];
+        memmove(chunks, chunks + 1, (nb_chunks - 1) * sizeof(*chunks));
+        chunks[nb_chunks - 1] = chunk;
+    }
+    s->current_chunk = -1;
+    s->shared_size = 0;
+}
+
+void ngli_ubopool_reset(struct ubopool *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    if (!ctx)
+        return;
+
+    struct glcontext *gl = ctx->glcontext;
+    struct ubopool_chunk *chunks = ngli_darray_data(&s->chunks);
+    for (int i = 0; i < ngli_darray_count(&s->chunks); i++) {
+        struct ubopool_chunk *chunk = &chunks[i];
+        if (chunk->fence)
+            ngli_glDeleteSync(gl, chunk->fence);
+        if (chunk->mapped_data) {
+            ngli_glstate_bind_buffer(gl, &ctx->glstate, GL_UNIFORM_BUFFER, chunk->id);
+            ngli_glUnmapBuffer(gl, GL_UNIFORM_BUFFER);
+        }
+        ngli_glDeleteBuffers(gl, 1, &chunk->id);
+        ngli_glstate_invalidate_buffer(&ctx->glstate, chunk->id);
+    }
+    ngli_darray_reset(&s->chunks);
+    ngli_free(s->shared_data);
+    memset(s, 0, sizeof(*s));
+}
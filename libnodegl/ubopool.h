@@ -0,0 +1,57 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef UBOPOOL_H
+#define UBOPOOL_H
+
+#include <stdint.h>
+
+#include "darray.h"
+#include "glincludes.h"
+
+struct ngl_ctx;
+
+/*
+ * Per-frame allocator of uniform buffer ranges: the allocations are
+ * suballocated from large buffers (chunks) at offsets honoring the uniform
+ * buffer offset alignment, and are only valid until the end of the frame.
+ * Chunks are recycled once the GPU is done with the frame that used them.
+ */
+struct ubopool {
+    struct ngl_ctx *ctx;
+    int alignment;
+    int chunk_size;
+    struct darray chunks;
+    int current_chunk;
+    /* Last allocation made with ngli_ubopool_upload_shared() */
+    uint8_t *shared_data;
+    int shared_size;
+    GLuint shared_buffer_id;
+    int shared_offset;
+};
+
+int ngli_ubopool_init(struct ubopool *s, struct ngl_ctx *ctx);
+int ngli_ubopool_upload(struct ubopool *s, const void *data, int size, GLuint *buffer_id, int *offset);
+int ngli_ubopool_upload_shared(struct ubopool *s, const void *data, int size, GLuint *buffer_id, int *offset);
+void ngli_ubopool_end_frame(struct ubopool *s);
+void ngli_ubopool_reset(struct ubopool *s);
+
+#endif
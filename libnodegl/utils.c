@@ -147,6 +147,17 @@ uint32_t ngli_crc32(const char *s)
     return ~crc;
 }
 
+/* 64-bit FNV-1a, chainable by passing the previous hash (or NGLI_FNV1A64_INIT) */
+uint64_t ngli_fnv1a64(uint64_t hash, const void *data, int size)
+{
+    const uint8_t *p = data;
+    for (int i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
 void ngli_thread_set_name(const char *name)
 {
 #if defined(__APPLE__)
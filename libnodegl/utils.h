@@ -98,6 +98,9 @@ int64_t ngli_gettime(void);
 int64_t ngli_gettime_relative(void);
 char *ngli_asprintf(const char *fmt, ...) ngli_printf_format(1, 2);
 uint32_t ngli_crc32(const char *s);
+
+#define NGLI_FNV1A64_INIT 0xcbf29ce484222325ULL
+uint64_t ngli_fnv1a64(uint64_t hash, const void *data, int size);
 void ngli_thread_set_name(const char *name);
 
 #endif /* UTILS_H */
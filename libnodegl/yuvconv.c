@@ -0,0 +1,239 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "colorconv.h"
+#include "gctx.h"
+#include "glcontext.h"
+#include "hmap.h"
+#include "log.h"
+#include "memory.h"
+#include "nodes.h"
+#include "pgcache.h"
+#include "topology.h"
+#include "type.h"
+#include "utils.h"
+#include "yuvconv.h"
+
+#define VERTEX_DATA                                                              \
+    "#version 100"                                                          "\n" \
+    "precision highp float;"                                                "\n" \
+    "attribute vec4 position;"                                              "\n" \
+    "void main()"                                                           "\n" \
+    "{"                                                                     "\n" \
+    "    gl_Position = vec4(position.xy, 0.0, 1.0);"                        "\n" \
+    "}"
+
+/*
+ * Each fragment outputs 4 consecutive bytes of the planar frame: the first
+ * rows hold the luma plane, the remaining ones the chroma planes where each
+ * chroma sample is the average of a 2x2 block of source pixels, obtained
+ * through bilinear filtering.
+ */
+#define RGBA_TO_YUV_FRAGMENT_DATA                                                \
+    "#version 100"                                                          "\n" \
+    "#define %s 1"                                                          "\n" \
+    "precision highp float;"                                                "\n" \
+    "uniform sampler2D tex0;"                                               "\n" \
+    "uniform mat4 color_matrix;"                                            "\n" \
+    "uniform vec2 dimensions;"                                              "\n" \
+    "float get_byte(float x, float y)"                                      "\n" \
+    "{"                                                                     "\n" \
+    "    if (y < dimensions.y) {"                                           "\n" \
+    "        vec3 rgb = texture2D(tex0, (vec2(x, y) + 0.5) / dimensions).rgb;" "\n" \
+    "        return (color_matrix * vec4(rgb, 1.0)).x;"                     "\n" \
+    "    }"                                                                 "\n" \
+    "    float row = y - dimensions.y;"                                     "\n" \
+    "#ifdef NV12"                                                            "\n" \
+    "    float cx = floor(x / 2.0);"                                        "\n" \
+    "    float cy = row;"                                                   "\n" \
+    "    float v = x - 2.0 * cx;"                                           "\n" \
+    "#else"                                                                 "\n" \
+    "    vec2 half_dimensions = dimensions / 2.0;"                          "\n" \
+    "    float right = x >= half_dimensions.x ? 1.0 : 0.0;"                 "\n" \
+    "    float chroma_row = 2.0 * row + right;"                             "\n" \
+    "    float v = chroma_row >= half_dimensions.y ? 1.0 : 0.0;"            "\n" \
+    "    float cx = x - right * half_dimensions.x;"                         "\n" \
+    "    float cy = chroma_row - v * half_dimensions.y;"                    "\n" \
+    "#endif"                                                                "\n" \
+    "    vec3 rgb = texture2D(tex0, (2.0 * vec2(cx, cy) + 1.0) / dimensions).rgb;" "\n" \
+    "    vec4 yuv = color_matrix * vec4(rgb, 1.0);"                         "\n" \
+    "    return v < 0.5 ? yuv.y : yuv.z;"                                   "\n" \
+    "}"                                                                     "\n" \
+    "void main()"                                                           "\n" \
+    "{"                                                                     "\n" \
+    "    float x = floor(gl_FragCoord.x) * 4.0;"                            "\n" \
+    "    float y = floor(gl_FragCoord.y);"                                  "\n" \
+    "    gl_FragColor = vec4(get_byte(x,       y),"                         "\n" \
+    "                        get_byte(x + 1.0, y),"                         "\n" \
+    "                        get_byte(x + 2.0, y),"                         "\n" \
+    "                        get_byte(x + 3.0, y));"                        "\n" \
+    "}"
+
+int ngli_yuvconv_init(struct yuvconv *s, struct ngl_ctx *ctx, struct texture *src,
+                      int format, const struct color_info *color_info)
+{
+    s->ctx = ctx;
+    s->format = format;
+
+    const int width = src->params.width;
+    const int height = src->params.height;
+    if (width % 4 || height % 2) {
+        LOG(ERROR, "unsupported dimensions for planar conversion: %dx%d", width, height);
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    struct texture_params texture_params = NGLI_TEXTURE_PARAM_DEFAULTS;
+    texture_params.format = NGLI_FORMAT_R8G8B8A8_UNORM;
+    texture_params.width = width / 4;
+    texture_params.height = height * 3 / 2;
+    texture_params.usage = NGLI_TEXTURE_USAGE_ATTACHMENT_ONLY;
+    int ret = ngli_texture_init(&s->texture, ctx, &texture_params);
+    if (ret < 0)
+        return ret;
+
+    const struct rendertarget_params rt_params = {
+        .width = texture_params.width,
+        .height = texture_params.height,
+        .nb_colors = 1,
+        .colors[0] = {
+            .attachment = &s->texture,
+        },
+    };
+    ret = ngli_rendertarget_init(&s->rt, ctx, &rt_params);
+    if (ret < 0)
+        return ret;
+
+    char *fragment_data = ngli_asprintf(RGBA_TO_YUV_FRAGMENT_DATA,
+                                        format == NGL_CAPTURE_FORMAT_NV12 ? "NV12" : "I420");
+    if (!fragment_data)
+        return NGL_ERROR_MEMORY;
+
+    ret = ngli_pgcache_get_graphics_program(&ctx->pgcache, &s->program, VERTEX_DATA, fragment_data);
+    ngli_free(fragment_data);
+    if (ret < 0)
+        return ret;
+
+    static const float vertices[] = {
+        -1.0f, -1.0f, 0.0f, 0.0f,
+         1.0f, -1.0f, 1.0f, 0.0f,
+         1.0f,  1.0f, 1.0f, 1.0f,
+        -1.0f,  1.0f, 0.0f, 1.0f,
+    };
+    ret = ngli_buffer_init(&s->vertices, ctx, sizeof(vertices), NGLI_BUFFER_USAGE_STATIC);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_buffer_upload(&s->vertices, vertices, sizeof(vertices), 0);
+    if (ret < 0)
+        return ret;
+
+    ngli_colorconv_get_rgb_to_ycbcr_color_matrix(s->color_matrix, color_info);
+    s->dimensions[0] = width;
+    s->dimensions[1] = height;
+
+    const struct pipeline_uniform uniforms[] = {
+        {.name = "color_matrix", .type = NGLI_TYPE_MAT4, .count = 1, .data = s->color_matrix},
+        {.name = "dimensions",   .type = NGLI_TYPE_VEC2, .count = 1, .data = s->dimensions},
+    };
+
+    struct pipeline_texture textures[] = {
+        {.name = "tex0", .texture = src},
+    };
+    const struct program_variable_info *info = ngli_hmap_get(s->program.uniforms, "tex0");
+    ngli_assert(info);
+    textures[0].type     = info->type;
+    textures[0].location = info->location;
+    textures[0].binding  = info->binding;
+
+    const struct program_variable_info *position = ngli_hmap_get(s->program.attributes, "position");
+    ngli_assert(position);
+
+    const struct pipeline_attribute attributes[] = {
+        {
+            .name     = "position",
+            .location = position->location,
+            .format   = NGLI_FORMAT_R32G32B32A32_SFLOAT,
+            .stride   = 4 * 4,
+            .buffer   = &s->vertices,
+        },
+    };
+
+    const struct pipeline_params pipeline_params = {
+        .type          = NGLI_PIPELINE_TYPE_GRAPHICS,
+        .program       = &s->program,
+        .textures      = textures,
+        .nb_textures   = NGLI_ARRAY_NB(textures),
+        .uniforms      = uniforms,
+        .nb_uniforms   = NGLI_ARRAY_NB(uniforms),
+        .attributes    = attributes,
+        .nb_attributes = NGLI_ARRAY_NB(attributes),
+        .graphics      = {
+            .topology    = NGLI_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN,
+            .nb_vertices = 4,
+            .state       = ctx->graphicstate,
+            .rt_desc     = {
+                .nb_colors = 1,
+                .colors[0].format = texture_params.format,
+            },
+        },
+    };
+
+    return ngli_pipeline_init(&s->pipeline, ctx, &pipeline_params);
+}
+
+int ngli_yuvconv_convert(struct yuvconv *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+
+    struct rendertarget *rt = &s->rt;
+    struct rendertarget *prev_rt = ngli_gctx_get_rendertarget(ctx);
+    ngli_gctx_set_rendertarget(ctx, rt);
+
+    int prev_vp[4] = {0};
+    ngli_gctx_get_viewport(ctx, prev_vp);
+
+    const int vp[4] = {0, 0, rt->width, rt->height};
+    ngli_gctx_set_viewport(ctx, vp);
+
+    int ret = ngli_pipeline_exec(&s->pipeline);
+
+    ngli_gctx_set_rendertarget(ctx, prev_rt);
+    ngli_gctx_set_viewport(ctx, prev_vp);
+
+    return ret;
+}
+
+void ngli_yuvconv_reset(struct yuvconv *s)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    if (!ctx)
+        return;
+
+    ngli_pipeline_reset(&s->pipeline);
+    ngli_buffer_reset(&s->vertices);
+    ngli_pgcache_release_program(&s->program);
+    ngli_rendertarget_reset(&s->rt);
+    ngli_texture_reset(&s->texture);
+
+    memset(s, 0, sizeof(*s));
+}
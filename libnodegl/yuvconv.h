@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020 GoPro Inc.
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef YUVCONV_H
+#define YUVCONV_H
+
+#include "buffer.h"
+#include "image.h"
+#include "pipeline.h"
+#include "program.h"
+#include "rendertarget.h"
+#include "texture.h"
+
+struct ngl_ctx;
+
+/*
+ * Conversion of an RGBA texture into planar NV12 or I420 data. The planes
+ * are packed 4 bytes per texel into an RGBA render target of
+ * (width / 4) x (height * 3 / 2) texels, so that reading back this render
+ * target as RGBA yields the planar frame as is.
+ */
+struct yuvconv {
+    struct ngl_ctx *ctx;
+    int format;
+    NGLI_ALIGNED_MAT(color_matrix);
+    float dimensions[2];
+
+    struct texture texture;
+    struct rendertarget rt;
+    struct program program;
+    struct buffer vertices;
+    struct pipeline pipeline;
+};
+
+int ngli_yuvconv_init(struct yuvconv *s, struct ngl_ctx *ctx, struct texture *src,
+                      int format, const struct color_info *color_info);
+int ngli_yuvconv_convert(struct yuvconv *s);
+void ngli_yuvconv_reset(struct yuvconv *s);
+
+#endif
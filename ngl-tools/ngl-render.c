@@ -82,6 +82,7 @@ int main(int argc, char *argv[])
     int ret = 0;
     const char *input = NULL;
     const char *output = NULL;
+    const char *shm_name = NULL;
     int width = 320, height = 240;
     struct range ranges[128] = {0};
     struct range *r;
@@ -91,6 +92,7 @@ int main(int argc, char *argv[])
     int debug = 0;
     SDL_Window *window = NULL;
     int stdout_output = 0;
+    int capture_format = NGL_CAPTURE_FORMAT_RGBA;
 
     for (int i = 1; i < argc; i++) {
         if (!strcmp(argv[i], "-d")) {
@@ -105,6 +107,9 @@ int main(int argc, char *argv[])
                     output = arg;
                     stdout_output = !strcmp(output, "-");
                     break;
+                case 'm':
+                    shm_name = arg;
+                    break;
                 case 's':
                     if (sscanf(arg, "%dx%d", &width, &height) != 2) {
                         fprintf(stderr, "Invalid size format: \"%s\" "
@@ -119,6 +124,19 @@ int main(int argc, char *argv[])
                 case 'z':
                     swap_interval = atoi(arg);
                     break;
+                case 'f':
+                    if (!strcmp(arg, "rgba")) {
+                        capture_format = NGL_CAPTURE_FORMAT_RGBA;
+                    } else if (!strcmp(arg, "nv12")) {
+                        capture_format = NGL_CAPTURE_FORMAT_NV12;
+                    } else if (!strcmp(arg, "i420")) {
+                        capture_format = NGL_CAPTURE_FORMAT_I420;
+                    } else {
+                        fprintf(stderr, "Invalid pixel format: \"%s\" "
+                                "is not one of rgba, nv12 or i420\n", arg);
+                        return EXIT_FAILURE;
+                    }
+                    break;
                 case 't':
                     if (nb_ranges >= sizeof(ranges)/sizeof(*ranges)) {
                         fprintf(stderr, "Too much ranges specified (max:%d)\n",
@@ -150,7 +168,13 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    printf("%s -> %s %dx%d\n", input ? input : "<stdin>", output ? output : "-", width, height);
+    if (output && shm_name) {
+        fprintf(stderr, "The raw output (-o) and the shared memory output (-m) cannot be used simultaneously\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%s -> %s %dx%d\n", input ? input : "<stdin>",
+           output ? output : shm_name ? shm_name : "-", width, height);
 
     if (show_window) {
         if (init_window() < 0)
@@ -166,6 +190,8 @@ int main(int argc, char *argv[])
     int fd = -1;
     struct ngl_ctx *ctx = NULL;
     uint8_t *capture_buffer = NULL;
+    const int capture_size = capture_format == NGL_CAPTURE_FORMAT_RGBA ? width * height * 4
+                                                                       : width * height * 3 / 2;
 
     struct ngl_node *scene = get_scene(input);
     if (!scene) {
@@ -192,7 +218,7 @@ int main(int argc, char *argv[])
                 goto end;
             }
         }
-        capture_buffer = calloc(width * height, 4);
+        capture_buffer = calloc(capture_size, 1);
         if (!capture_buffer)
             goto end;
     }
@@ -209,6 +235,8 @@ int main(int argc, char *argv[])
         .viewport = {0, 0, width, height},
         .offscreen = !show_window,
         .capture_buffer = capture_buffer,
+        .capture_format = capture_format,
+        .capture_shm_name = shm_name,
         .clear_color = {0.0f, 0.0f, 0.0f, 1.0f},
     };
     if (show_window) {
@@ -252,7 +280,7 @@ int main(int argc, char *argv[])
                 goto end;
             }
             if (capture_buffer)
-                write(fd, capture_buffer, 4 * width * height);
+                write(fd, capture_buffer, capture_size);
             if (show_window) {
                 SDL_Event event;
                 while (SDL_PollEvent(&event)) {
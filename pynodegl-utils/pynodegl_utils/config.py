@@ -76,6 +76,7 @@ class Config(QtCore.QObject):
             'export_height': 720,
             'export_filename': op.join(tempfile.gettempdir(), 'ngl-export.mp4'),
             'export_extra_enc_args': '',
+            'export_planar': False,
 
             # Medias
             'medias_list': [],
@@ -149,6 +150,10 @@ class Config(QtCore.QObject):
     def set_export_extra_enc_args(self, extra_enc_args):
         self._set_cfg('export_extra_enc_args', extra_enc_args)
 
+    @QtCore.Slot(bool)
+    def set_export_planar(self, planar):
+        self._set_cfg('export_planar', planar)
+
     @QtCore.Slot(tuple)
     def set_aspect_ratio(self, ar):
         self._set_cfg('aspect_ratio', ar)
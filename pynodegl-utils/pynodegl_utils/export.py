@@ -37,7 +37,7 @@ class Exporter(QtCore.QThread):
     failed = QtCore.Signal()
     export_finished = QtCore.Signal()
 
-    def __init__(self, get_scene_func, filename, w, h, extra_enc_args=None, time=None):
+    def __init__(self, get_scene_func, filename, w, h, extra_enc_args=None, time=None, planar=False):
         super().__init__()
         self._get_scene_func = get_scene_func
         self._filename = filename
@@ -45,6 +45,7 @@ class Exporter(QtCore.QThread):
         self._height = h
         self._extra_enc_args = extra_enc_args if extra_enc_args is not None else []
         self._time = time
+        self._planar = planar
         self._cancelled = False
 
     def run(self):
@@ -59,11 +60,11 @@ class Exporter(QtCore.QThread):
                 return
             ok = self._export(filename, width, height, pass2_args)
         else:
-            ok = self._export(filename, width, height, self._extra_enc_args)
+            ok = self._export(filename, width, height, self._extra_enc_args, self._planar)
         if ok:
             self.export_finished.emit()
 
-    def _export(self, filename, width, height, extra_enc_args=None):
+    def _export(self, filename, width, height, extra_enc_args=None, planar=False):
         fd_r, fd_w = os.pipe()
 
         cfg = self._get_scene_func()
@@ -75,12 +76,26 @@ class Exporter(QtCore.QThread):
         duration = cfg['duration']
         samples = cfg['samples']
 
+        # When requested, the frames are converted to I420 (limited range
+        # BT.709) by node.gl when possible so that ffmpeg does not have to
+        # convert them from RGBA on the CPU. This only suits encodings to that
+        # format: RGB, 4:4:4 or alpha outputs need the RGBA frames.
+        planar = planar and width % 4 == 0 and height % 2 == 0
+        if planar:
+            capture_format = ngl.CAPTURE_FORMAT_I420
+            capture_size = width * height * 3 // 2
+            input_args = ['-pixel_format', 'yuv420p', '-colorspace', 'bt709', '-color_range', 'tv']
+        else:
+            capture_format = ngl.CAPTURE_FORMAT_RGBA
+            capture_size = width * height * 4
+            input_args = ['-pixel_format', 'rgba']
+
         cmd = ['ffmpeg', '-r', '%d/%d' % fps,
                '-nostats', '-nostdin',
                '-f', 'rawvideo',
-               '-video_size', '%dx%d' % (width, height),
-               '-pixel_format', 'rgba',
-               '-i', 'pipe:%d' % fd_r]
+               '-video_size', '%dx%d' % (width, height)]
+        cmd += input_args
+        cmd += ['-i', 'pipe:%d' % fd_r]
         if extra_enc_args:
             cmd += extra_enc_args
         cmd += ['-y', filename]
@@ -88,7 +103,7 @@ class Exporter(QtCore.QThread):
         reader = subprocess.Popen(cmd, pass_fds=(fd_r,))
         os.close(fd_r)
 
-        capture_buffer = bytearray(width * height * 4)
+        capture_buffer = bytearray(capture_size)
 
         # node.gl context
         ngl_viewer = ngl.Viewer()
@@ -102,6 +117,7 @@ class Exporter(QtCore.QThread):
             samples=samples,
             clear_color=cfg['clear_color'],
             capture_buffer=capture_buffer,
+            capture_format=capture_format,
         )
         ngl_viewer.set_scene_from_string(cfg['scene'])
 
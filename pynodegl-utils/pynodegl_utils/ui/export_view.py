@@ -53,6 +53,9 @@ class ExportView(QtWidgets.QWidget):
         self._encopts_text = QtWidgets.QLineEdit()
         self._encopts_text.setText(config.get('export_extra_enc_args'))
 
+        self._planar_chkbox = QtWidgets.QCheckBox('Convert to YUV 4:2:0 (BT.709, limited range) on the GPU')
+        self._planar_chkbox.setChecked(config.get('export_planar'))
+
         self._export_btn = QtWidgets.QPushButton('Export')
         btn_hbox = QtWidgets.QHBoxLayout()
         btn_hbox.addStretch()
@@ -67,6 +70,7 @@ class ExportView(QtWidgets.QWidget):
         form.addRow('Width:',    self._spinbox_width)
         form.addRow('Height:',   self._spinbox_height)
         form.addRow('Extra encoder arguments:', self._encopts_text)
+        form.addRow(self._planar_chkbox)
         form.addRow(self._warning_label)
         form.addRow(btn_hbox)
 
@@ -79,6 +83,7 @@ class ExportView(QtWidgets.QWidget):
         self._spinbox_height.valueChanged.connect(self._check_settings)
         self._spinbox_height.valueChanged.connect(config.set_export_height)
         self._encopts_text.textChanged.connect(config.set_export_extra_enc_args)
+        self._planar_chkbox.toggled.connect(config.set_export_planar)
 
         self._exporter = None
 
@@ -150,7 +155,8 @@ class ExportView(QtWidgets.QWidget):
         self._pgd.setWindowModality(QtCore.Qt.WindowModal)
         self._pgd.setMinimumDuration(100)
 
-        self._exporter = Exporter(self._get_scene_func, ofile, width, height, extra_enc_args)
+        planar = self._planar_chkbox.isChecked()
+        self._exporter = Exporter(self._get_scene_func, ofile, width, height, extra_enc_args, planar=planar)
 
         self._pgd.canceled.connect(self._cancel)
         self._exporter.progressed.connect(self._progress)
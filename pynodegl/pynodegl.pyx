@@ -22,6 +22,7 @@
 
 from libc.stdlib cimport calloc
 from libc.string cimport memset
+from libc.stdint cimport int64_t
 from libc.stdint cimport uint8_t
 from libc.stdint cimport uintptr_t
 
@@ -60,6 +61,14 @@ cdef extern from "nodegl.h":
     cdef int NGL_BACKEND_OPENGL
     cdef int NGL_BACKEND_OPENGLES
 
+    cdef int NGL_CAPTURE_FORMAT_RGBA
+    cdef int NGL_CAPTURE_FORMAT_BGRA
+    cdef int NGL_CAPTURE_FORMAT_NV12
+    cdef int NGL_CAPTURE_FORMAT_I420
+
+    cdef int NGL_CAPTURE_COLOR_MATRIX_BT709
+    cdef int NGL_CAPTURE_COLOR_MATRIX_BT601
+
     cdef struct ngl_ctx
 
     cdef struct ngl_config:
@@ -77,13 +86,33 @@ cdef extern from "nodegl.h":
         int  set_surface_pts
         float clear_color[4]
         uint8_t *capture_buffer
+        int  capture_format
+        int  capture_color_matrix
+        int  capture_full_range
+        const char *capture_shm_name
+        int  capture_shm_slots
+        const char *program_cache_dir
+
+    cdef struct ngl_stats:
+        int64_t uniform_updates_issued
+        int64_t uniform_updates_skipped
+        int64_t buffer_duplicates
+        int64_t buffer_bytes_saved
+        int64_t draws_issued
+        int64_t draws_culled
+        int64_t program_cache_hits
+        int64_t program_cache_misses
+        int64_t program_cache_evictions
+        int64_t warmup_time
 
     ngl_ctx *ngl_create()
     int ngl_configure(ngl_ctx *s, ngl_config *config)
     int ngl_resize(ngl_ctx *s, int width, int height, const int *viewport);
     int ngl_set_scene(ngl_ctx *s, ngl_node *scene)
     int ngl_draw(ngl_ctx *s, double t) nogil
+    int ngl_warmup(ngl_ctx *s, double t_start, double t_end) nogil
     char *ngl_dot(ngl_ctx *s, double t) nogil
+    int ngl_get_stats(ngl_ctx *s, ngl_stats *stats)
     void ngl_freep(ngl_ctx **ss)
 
     int ngl_easing_evaluate(const char *name, double *args, int nb_args,
@@ -102,6 +131,14 @@ BACKEND_AUTO      = NGL_BACKEND_AUTO
 BACKEND_OPENGL    = NGL_BACKEND_OPENGL
 BACKEND_OPENGLES  = NGL_BACKEND_OPENGLES
 
+CAPTURE_FORMAT_RGBA = NGL_CAPTURE_FORMAT_RGBA
+CAPTURE_FORMAT_BGRA = NGL_CAPTURE_FORMAT_BGRA
+CAPTURE_FORMAT_NV12 = NGL_CAPTURE_FORMAT_NV12
+CAPTURE_FORMAT_I420 = NGL_CAPTURE_FORMAT_I420
+
+CAPTURE_COLOR_MATRIX_BT709 = NGL_CAPTURE_COLOR_MATRIX_BT709
+CAPTURE_COLOR_MATRIX_BT601 = NGL_CAPTURE_COLOR_MATRIX_BT601
+
 LOG_VERBOSE = NGL_LOG_VERBOSE
 LOG_DEBUG   = NGL_LOG_DEBUG
 LOG_INFO    = NGL_LOG_INFO
@@ -165,6 +202,8 @@ def easing_solve(name, v, args=None, offsets=None):
 cdef class Viewer:
     cdef ngl_ctx *ctx
     cdef object capture_buffer
+    cdef object capture_shm_name
+    cdef object program_cache_dir
 
     def __cinit__(self):
         self.ctx = ngl_create()
@@ -194,6 +233,16 @@ cdef class Viewer:
         self.capture_buffer = kwargs.get('capture_buffer')
         if self.capture_buffer is not None:
             config.capture_buffer = self.capture_buffer
+        config.capture_format = kwargs.get('capture_format', CAPTURE_FORMAT_RGBA)
+        config.capture_color_matrix = kwargs.get('capture_color_matrix', CAPTURE_COLOR_MATRIX_BT709)
+        config.capture_full_range = kwargs.get('capture_full_range', 0)
+        self.capture_shm_name = kwargs.get('capture_shm_name')
+        if self.capture_shm_name is not None:
+            config.capture_shm_name = self.capture_shm_name
+        config.capture_shm_slots = kwargs.get('capture_shm_slots', 0)
+        self.program_cache_dir = kwargs.get('program_cache_dir')
+        if self.program_cache_dir is not None:
+            config.program_cache_dir = self.program_cache_dir
         return ngl_configure(self.ctx, &config)
 
     def resize(self, width, height, viewport=None):
@@ -217,11 +266,24 @@ cdef class Viewer:
         with nogil:
             ngl_draw(self.ctx, t)
 
+    def warmup(self, double t_start, double t_end):
+        cdef int ret
+        with nogil:
+            ret = ngl_warmup(self.ctx, t_start, t_end)
+        return ret
+
     def dot(self, double t):
         cdef char *s;
         with nogil:
             s = ngl_dot(self.ctx, t)
         return _ret_pystr(s) if s else None
 
+    def get_stats(self):
+        cdef ngl_stats stats
+        ret = ngl_get_stats(self.ctx, &stats)
+        if ret < 0:
+            return None
+        return stats
+
     def __dealloc__(self):
         ngl_freep(&self.ctx)